@@ -0,0 +1,110 @@
+package com.shockwave.pdfium;
+
+import android.graphics.Bitmap;
+
+import java.util.ArrayList;
+import java.util.List;
+import java.util.concurrent.Callable;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.TimeUnit;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+import androidx.test.platform.app.InstrumentationRegistry;
+
+import org.junit.Before;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertNotNull;
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Stress of distinct documents used from several threads at once. PDFium is not
+ * thread-safe even across documents, so without the native library lock this crashes
+ * or renders garbage; with it every thread must see the same pixels as a lone render.
+ */
+@RunWith(AndroidJUnit4.class)
+public class ConcurrentDocumentsTest {
+    private static final int THREADS = 6;
+    private static final int ITERATIONS = 20;
+    private static final int PAGE_COUNT = 3;
+    private static final int WIDTH = 300;
+    private static final int HEIGHT = 400;
+
+    private PdfiumCore core;
+    private byte[] pdf;
+    private Bitmap[] expected;
+
+    @Before
+    public void setUp() throws Exception {
+        core = new PdfiumCore(InstrumentationRegistry.getInstrumentation().getTargetContext());
+        pdf = TestPdfs.create(PAGE_COUNT, 150, 10, 7);
+
+        PdfDocument doc = core.newDocument(pdf);
+        core.openPage(doc, 0, PAGE_COUNT - 1);
+        expected = new Bitmap[PAGE_COUNT];
+        for (int i = 0; i < PAGE_COUNT; i++) {
+            expected[i] = render(doc, i);
+        }
+        core.closeDocument(doc);
+    }
+
+    @Test
+    public void documentsOnSeparateThreads() throws Exception {
+        ExecutorService executor = Executors.newFixedThreadPool(THREADS);
+        List<Future<Void>> results = new ArrayList<>();
+        for (int t = 0; t < THREADS; t++) {
+            final int thread = t;
+            results.add(executor.submit(new Callable<Void>() {
+                @Override
+                public Void call() throws Exception {
+                    exercise(thread);
+                    return null;
+                }
+            }));
+        }
+        executor.shutdown();
+        assertTrue(executor.awaitTermination(5, TimeUnit.MINUTES));
+        for (Future<Void> result : results) {
+            //Rethrows assertion failures of workers
+            result.get();
+        }
+    }
+
+    private void exercise(int thread) throws Exception {
+        for (int n = 0; n < ITERATIONS; n++) {
+            PdfDocument doc = core.newDocument(pdf);
+            try {
+                assertEquals(PAGE_COUNT, core.getPageCount(doc));
+                int page = (thread + n) % PAGE_COUNT;
+                core.openPage(doc, page);
+
+                //Mix of calls which enter PDFium through different natives
+                assertEquals(PAGE_COUNT * 2, core.getAllPageSizes(doc).length);
+                assertNotNull(core.getDocumentMeta(doc));
+                assertNotNull(core.getTableOfContents(doc));
+                PageLinks links = core.getPageLinksPacked(doc, page);
+                assertEquals(10, links.getCount());
+                float[] points = links.getRects().clone();
+                core.mapPageRectsToDevice(doc, page, 0, 0, WIDTH, HEIGHT, 0, points, points);
+
+                Bitmap bitmap = render(doc, page);
+                assertTrue("page " + page + " on thread " + thread, expected[page].sameAs(bitmap));
+                bitmap.recycle();
+
+                core.closePage(doc, page);
+            } finally {
+                core.closeDocument(doc);
+            }
+        }
+    }
+
+    private Bitmap render(PdfDocument doc, int page) {
+        Bitmap bitmap = Bitmap.createBitmap(WIDTH, HEIGHT, Bitmap.Config.ARGB_8888);
+        core.renderPageBitmap(doc, bitmap, page, 0, 0, WIDTH, HEIGHT);
+        return bitmap;
+    }
+}
@@ -0,0 +1,112 @@
+package com.shockwave.pdfium;
+
+import android.graphics.Bitmap;
+
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.List;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+import androidx.test.platform.app.InstrumentationRegistry;
+
+import org.junit.Before;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertNotNull;
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Documents read through {@link PdfDataSource}. Source below returns fewer bytes than
+ * asked for, so native side has to keep reading until block is full, and records reads,
+ * so test can check they stay within document.
+ */
+@RunWith(AndroidJUnit4.class)
+public class DataSourceDocumentTest {
+    private static final int PAGE_COUNT = 3;
+    private static final int SIZE = 200;
+    private static final int MAX_READ = 1000;
+
+    private PdfiumCore core;
+    private byte[] pdf;
+
+    @Before
+    public void setUp() {
+        core = new PdfiumCore(InstrumentationRegistry.getInstrumentation().getTargetContext());
+        //Small blocks, so document spans many of them
+        core.setBlockCacheConfig(4096, 8, 2);
+        pdf = TestPdfs.create(PAGE_COUNT, 50, 2);
+    }
+
+    @Test
+    public void rendersSameAsMemoryDocument() throws Exception {
+        ByteSource source = new ByteSource(pdf, false);
+        PdfDocument doc = core.newDocument(source, null);
+        PdfDocument memoryDoc = core.newDocument(pdf);
+        try {
+            assertEquals(PAGE_COUNT, core.getPageCount(doc));
+            for (int i = 0; i < PAGE_COUNT; i++) {
+                assertTrue("page " + i, render(doc, i).sameAs(render(memoryDoc, i)));
+            }
+
+            synchronized (source.reads) {
+                assertFalse(source.reads.isEmpty());
+                for (long[] read : source.reads) {
+                    assertTrue(read[0] >= 0 && read[0] + read[1] <= pdf.length);
+                }
+            }
+            BlockCacheStats stats = core.getBlockCacheStats(doc);
+            assertNotNull(stats);
+            assertTrue(stats.blockHits > 0);
+        } finally {
+            core.closeDocument(doc);
+            core.closeDocument(memoryDoc);
+        }
+    }
+
+    @Test(expected = IOException.class)
+    public void failingSourceFailsOpen() throws Exception {
+        core.newDocument(new ByteSource(pdf, true), null);
+    }
+
+    private Bitmap render(PdfDocument doc, int pageIndex) {
+        core.openPage(doc, pageIndex);
+        Bitmap bitmap = Bitmap.createBitmap(SIZE, SIZE, Bitmap.Config.ARGB_8888);
+        core.renderPageBitmap(doc, bitmap, pageIndex, 0, 0, SIZE, SIZE);
+        return bitmap;
+    }
+
+    private static class ByteSource implements PdfDataSource {
+        final List<long[]> reads = new ArrayList<>();
+        private final byte[] data;
+        private final boolean failing;
+
+        ByteSource(byte[] data, boolean failing) {
+            this.data = data;
+            this.failing = failing;
+        }
+
+        @Override
+        public long getSize() {
+            return data.length;
+        }
+
+        @Override
+        public int read(long position, byte[] buffer, int offset, int size) throws IOException {
+            if (failing) {
+                throw new IOException("Source failed");
+            }
+            synchronized (reads) {
+                reads.add(new long[]{position, size});
+            }
+            if (position >= data.length) {
+                return -1;
+            }
+            int count = (int) Math.min(Math.min(size, MAX_READ), data.length - position);
+            System.arraycopy(data, (int) position, buffer, offset, count);
+            return count;
+        }
+    }
+}
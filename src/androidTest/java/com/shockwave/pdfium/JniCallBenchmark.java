@@ -0,0 +1,156 @@
+package com.shockwave.pdfium;
+
+import android.graphics.Point;
+import android.graphics.RectF;
+import android.os.SystemClock;
+import android.util.Log;
+
+import java.util.Locale;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+import androidx.test.platform.app.InstrumentationRegistry;
+
+import org.junit.After;
+import org.junit.Before;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+/**
+ * Cost per call of small natives which return Java objects, logged with tag JniCallBenchmark.
+ * Run it on builds before and after natives were registered in JNI_OnLoad with cached class
+ * and method IDs to compare per-object calls; batch variants of the same APIs are measured
+ * in the same run as baseline of what is left of JNI transition cost.
+ */
+@RunWith(AndroidJUnit4.class)
+public class JniCallBenchmark {
+    private static final String TAG = JniCallBenchmark.class.getSimpleName();
+    private static final int PAGE_COUNT = 2;
+    private static final int LINKS_PER_PAGE = 50;
+    private static final int POINTS = 10000;
+    private static final int ITERATIONS = 20;
+
+    private PdfiumCore core;
+    private PdfDocument doc;
+
+    @Before
+    public void setUp() throws Exception {
+        core = new PdfiumCore(InstrumentationRegistry.getInstrumentation().getTargetContext());
+        doc = core.newDocument(TestPdfs.create(PAGE_COUNT, 0, LINKS_PER_PAGE, 1));
+        core.openPage(doc, 0, PAGE_COUNT - 1);
+    }
+
+    @After
+    public void tearDown() {
+        core.closeDocument(doc);
+    }
+
+    @Test
+    public void pageSize() {
+        long start = SystemClock.elapsedRealtimeNanos();
+        for (int i = 0; i < POINTS * ITERATIONS; i++) {
+            core.getPageSize(doc, i % PAGE_COUNT);
+        }
+        report("getPageSize", POINTS * ITERATIONS, SystemClock.elapsedRealtimeNanos() - start);
+
+        start = SystemClock.elapsedRealtimeNanos();
+        for (int i = 0; i < ITERATIONS; i++) {
+            core.getAllPageSizes(doc);
+        }
+        report("getAllPageSizes", PAGE_COUNT * ITERATIONS,
+                SystemClock.elapsedRealtimeNanos() - start);
+    }
+
+    @Test
+    public void links() {
+        int calls = ITERATIONS * 10;
+        long start = SystemClock.elapsedRealtimeNanos();
+        for (int i = 0; i < calls; i++) {
+            core.getPageLinks(doc, i % PAGE_COUNT);
+        }
+        report("getPageLinks", LINKS_PER_PAGE * calls,
+                SystemClock.elapsedRealtimeNanos() - start);
+
+        start = SystemClock.elapsedRealtimeNanos();
+        for (int i = 0; i < calls; i++) {
+            core.getPageLinksPacked(doc, i % PAGE_COUNT);
+        }
+        report("getPageLinksPacked", LINKS_PER_PAGE * calls,
+                SystemClock.elapsedRealtimeNanos() - start);
+    }
+
+    @Test
+    public void coordinates() {
+        float[] points = new float[POINTS * 2];
+        for (int i = 0; i < POINTS; i++) {
+            points[i * 2] = i % 612;
+            points[i * 2 + 1] = i % 792;
+        }
+        float[] out = new float[points.length];
+
+        long start = SystemClock.elapsedRealtimeNanos();
+        long sink = 0;
+        for (int n = 0; n < ITERATIONS; n++) {
+            for (int i = 0; i < POINTS; i++) {
+                Point point = core.mapPageCoordsToDevice(doc, 0, 0, 0, 1080, 1400, 0,
+                        points[i * 2], points[i * 2 + 1]);
+                sink += point.x;
+            }
+        }
+        report("mapPageCoordsToDevice", POINTS * ITERATIONS,
+                SystemClock.elapsedRealtimeNanos() - start);
+
+        start = SystemClock.elapsedRealtimeNanos();
+        for (int n = 0; n < ITERATIONS; n++) {
+            core.mapPagePointsToDevice(doc, 0, 0, 0, 1080, 1400, 0, points, out);
+            sink += (long) out[0];
+        }
+        report("mapPagePointsToDevice", POINTS * ITERATIONS,
+                SystemClock.elapsedRealtimeNanos() - start);
+        Log.v(TAG, "checksum " + sink);
+    }
+
+    @Test
+    public void rects() {
+        float[] rects = new float[POINTS * 4];
+        for (int i = 0; i < POINTS; i++) {
+            rects[i * 4] = i % 600;
+            rects[i * 4 + 1] = i % 780 + 10;
+            rects[i * 4 + 2] = i % 600 + 12;
+            rects[i * 4 + 3] = i % 780;
+        }
+        float[] out = new float[rects.length];
+        RectF rect = new RectF();
+
+        long start = SystemClock.elapsedRealtimeNanos();
+        long sink = 0;
+        for (int n = 0; n < ITERATIONS; n++) {
+            for (int i = 0; i < POINTS; i++) {
+                rect.set(rects[i * 4], rects[i * 4 + 1], rects[i * 4 + 2], rects[i * 4 + 3]);
+                sink += (long) core.mapRectToDevice(doc, 0, 0, 0, 1080, 1400, 1, rect).left;
+            }
+        }
+        report("mapRectToDevice", POINTS * ITERATIONS,
+                SystemClock.elapsedRealtimeNanos() - start);
+
+        start = SystemClock.elapsedRealtimeNanos();
+        for (int n = 0; n < ITERATIONS; n++) {
+            core.mapPageRectsToDevice(doc, 0, 0, 0, 1080, 1400, 1, rects, out);
+            sink += (long) out[0];
+        }
+        report("mapPageRectsToDevice", POINTS * ITERATIONS,
+                SystemClock.elapsedRealtimeNanos() - start);
+
+        start = SystemClock.elapsedRealtimeNanos();
+        for (int n = 0; n < ITERATIONS; n++) {
+            core.mapDeviceRectsToPage(doc, 0, 0, 0, 1080, 1400, 1, out, rects);
+            sink += (long) rects[0];
+        }
+        report("mapDeviceRectsToPage", POINTS * ITERATIONS,
+                SystemClock.elapsedRealtimeNanos() - start);
+        Log.v(TAG, "checksum " + sink);
+    }
+
+    private static void report(String api, int items, long elapsedNs) {
+        Log.i(TAG, String.format(Locale.US, "%s: %.1f ns/item", api, (double) elapsedNs / items));
+    }
+}
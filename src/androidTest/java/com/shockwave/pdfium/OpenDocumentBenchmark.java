@@ -0,0 +1,78 @@
+package com.shockwave.pdfium;
+
+import android.content.Context;
+import android.os.ParcelFileDescriptor;
+import android.os.SystemClock;
+import android.util.Log;
+
+import java.io.File;
+import java.io.FileOutputStream;
+import java.util.Locale;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+import androidx.test.platform.app.InstrumentationRegistry;
+
+import org.junit.After;
+import org.junit.Before;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import static org.junit.Assert.assertEquals;
+
+/**
+ * Time to open a document from file and load all of its pages with pread and with
+ * memory-mapped access. Results are logged with tag OpenDocumentBenchmark.
+ */
+@RunWith(AndroidJUnit4.class)
+public class OpenDocumentBenchmark {
+    private static final String TAG = OpenDocumentBenchmark.class.getSimpleName();
+    private static final int PAGE_COUNT = 200;
+    private static final int SHAPES_PER_PAGE = 50;
+    private static final int ITERATIONS = 10;
+
+    private PdfiumCore core;
+    private File file;
+
+    @Before
+    public void setUp() throws Exception {
+        Context context = InstrumentationRegistry.getInstrumentation().getTargetContext();
+        core = new PdfiumCore(context);
+        file = new File(context.getCacheDir(), "openDocumentBenchmark.pdf");
+        FileOutputStream out = new FileOutputStream(file);
+        out.write(TestPdfs.create(PAGE_COUNT, SHAPES_PER_PAGE, 1));
+        out.close();
+    }
+
+    @After
+    public void tearDown() {
+        file.delete();
+    }
+
+    @Test
+    public void preadAgainstMmap() throws Exception {
+        //Warm up page cache of the file, so both modes read from memory
+        open(PdfiumCore.ACCESS_MODE_PREAD);
+
+        for (int mode : new int[]{PdfiumCore.ACCESS_MODE_PREAD, PdfiumCore.ACCESS_MODE_MMAP}) {
+            long start = SystemClock.elapsedRealtimeNanos();
+            for (int i = 0; i < ITERATIONS; i++) {
+                open(mode);
+            }
+            double ms = (SystemClock.elapsedRealtimeNanos() - start) / 1e6 / ITERATIONS;
+            Log.i(TAG, String.format(Locale.US, "%s: %.2f ms/open, %d pages",
+                    mode == PdfiumCore.ACCESS_MODE_MMAP ? "mmap" : "pread", ms, PAGE_COUNT));
+        }
+    }
+
+    private void open(int accessMode) throws Exception {
+        PdfDocument doc = core.newDocument(
+                ParcelFileDescriptor.open(file, ParcelFileDescriptor.MODE_READ_ONLY), null,
+                accessMode);
+        try {
+            assertEquals(PAGE_COUNT, core.getPageCount(doc));
+            core.openPage(doc, 0, PAGE_COUNT - 1);
+        } finally {
+            core.closeDocument(doc);
+        }
+    }
+}
@@ -0,0 +1,172 @@
+package com.shockwave.pdfium;
+
+import android.content.Context;
+import android.graphics.Bitmap;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+import androidx.test.platform.app.InstrumentationRegistry;
+
+import org.junit.After;
+import org.junit.Before;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Ordering of RenderScheduler with one worker. Callback of the first render blocks the
+ * worker, and render thread takes no request until a worker is free, so requests under
+ * test stay queued and their completion order shows the order in which they were taken.
+ */
+@RunWith(AndroidJUnit4.class)
+public class RenderSchedulerTest {
+    private static final int SIZE = 64;
+    private static final long TIMEOUT_S = 30;
+
+    private PdfiumCore core;
+    private PdfDocument doc;
+
+    private final List<Long> completed = new ArrayList<>();
+    private final List<Integer> statuses = new ArrayList<>();
+    private final CountDownLatch blockerStarted = new CountDownLatch(1);
+    private final CountDownLatch releaseBlocker = new CountDownLatch(1);
+    private CountDownLatch done;
+    private long blockerId;
+
+    @Before
+    public void setUp() throws Exception {
+        Context context = InstrumentationRegistry.getInstrumentation().getTargetContext();
+        core = new PdfiumCore(context);
+        //Cached fragments would complete without queueing
+        core.setTileCacheSize(0);
+
+        doc = core.newDocument(TestPdfs.create(4, 20, 1));
+
+        core.openRenderScheduler(doc, 1, new RenderCallback() {
+            @Override
+            public void onRenderComplete(long requestId, int status) {
+                synchronized (completed) {
+                    completed.add(requestId);
+                    statuses.add(status);
+                }
+                if (requestId == blockerId) {
+                    blockerStarted.countDown();
+                    await(releaseBlocker);
+                }
+                if (done != null) {
+                    done.countDown();
+                }
+            }
+        });
+    }
+
+    @After
+    public void tearDown() {
+        core.closeDocument(doc);
+    }
+
+    @Test
+    public void higherPriorityIsRenderedFirst() throws Exception {
+        blockWorker(4);
+        long thumbnail = submit(0, PdfiumCore.PRIORITY_THUMBNAIL);
+        long prefetch = submit(1, PdfiumCore.PRIORITY_PREFETCH);
+        long visible = submit(2, PdfiumCore.PRIORITY_VISIBLE);
+        releaseWorker();
+
+        assertEquals(Arrays.asList(blockerId, visible, prefetch, thumbnail), completedIds());
+        assertAllDone();
+    }
+
+    @Test
+    public void duplicateRequestsShareRenderWithRaisedPriority() throws Exception {
+        blockWorker(4);
+        Bitmap first = bitmap();
+        Bitmap second = bitmap();
+        long duplicate = core.submitRender(doc, first, 1, 0, 0, SIZE, SIZE, false,
+                PdfiumCore.PRIORITY_THUMBNAIL);
+        long prefetch = submit(2, PdfiumCore.PRIORITY_PREFETCH);
+        //Merged into queued render of the same fragment, which moves ahead of prefetch
+        long merged = core.submitRender(doc, second, 1, 0, 0, SIZE, SIZE, false,
+                PdfiumCore.PRIORITY_VISIBLE);
+        releaseWorker();
+
+        assertEquals(Arrays.asList(blockerId, duplicate, merged, prefetch), completedIds());
+        assertAllDone();
+        assertTrue(first.sameAs(second));
+    }
+
+    @Test
+    public void queuedRequestIsCancelledImmediately() throws Exception {
+        blockWorker(3);
+        long cancelled = submit(1, PdfiumCore.PRIORITY_VISIBLE);
+        long kept = submit(2, PdfiumCore.PRIORITY_VISIBLE);
+
+        assertTrue(core.cancelRender(doc, cancelled));
+        synchronized (completed) {
+            //Completed on this thread, before cancelRender returned
+            assertEquals(cancelled, (long) completed.get(completed.size() - 1));
+            assertEquals(RenderJob.STATUS_CANCELLED, (int) statuses.get(statuses.size() - 1));
+        }
+        assertFalse(core.cancelRender(doc, cancelled));
+        releaseWorker();
+
+        assertEquals(Arrays.asList(blockerId, cancelled, kept), completedIds());
+        synchronized (completed) {
+            assertEquals(RenderJob.STATUS_DONE, (int) statuses.get(2));
+        }
+    }
+
+    /** Submit blocker and wait until worker is stuck in its callback */
+    private void blockWorker(int expectedCompletions) throws InterruptedException {
+        done = new CountDownLatch(expectedCompletions);
+        synchronized (completed) {
+            blockerId = submit(0, PdfiumCore.PRIORITY_VISIBLE);
+        }
+        assertTrue(blockerStarted.await(TIMEOUT_S, TimeUnit.SECONDS));
+    }
+
+    private void releaseWorker() throws InterruptedException {
+        releaseBlocker.countDown();
+        assertTrue(done.await(TIMEOUT_S, TimeUnit.SECONDS));
+    }
+
+    private long submit(int pageIndex, int priority) {
+        long id = core.submitRender(doc, bitmap(), pageIndex, 0, 0, SIZE, SIZE, false, priority);
+        assertTrue(id != 0);
+        return id;
+    }
+
+    private List<Long> completedIds() {
+        synchronized (completed) {
+            return new ArrayList<>(completed);
+        }
+    }
+
+    private void assertAllDone() {
+        synchronized (completed) {
+            for (int status : statuses) {
+                assertEquals(RenderJob.STATUS_DONE, status);
+            }
+        }
+    }
+
+    private static Bitmap bitmap() {
+        return Bitmap.createBitmap(SIZE, SIZE, Bitmap.Config.ARGB_8888);
+    }
+
+    private static void await(CountDownLatch latch) {
+        try {
+            latch.await(TIMEOUT_S, TimeUnit.SECONDS);
+        } catch (InterruptedException e) {
+            Thread.currentThread().interrupt();
+        }
+    }
+}
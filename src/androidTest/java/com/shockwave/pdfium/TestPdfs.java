@@ -0,0 +1,147 @@
+package com.shockwave.pdfium;
+
+import java.io.ByteArrayOutputStream;
+import java.nio.charset.Charset;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Locale;
+import java.util.Random;
+
+/** Generates small valid PDF documents for instrumentation tests and benchmarks */
+final class TestPdfs {
+    private static final Charset LATIN1 = Charset.forName("ISO-8859-1");
+
+    private TestPdfs() {
+    }
+
+    /**
+     * Letter sized pages, each with given number of random filled and stroked paths and
+     * a few lines of text "Page N line M", so rendering cost grows with shapesPerPage.
+     */
+    static byte[] create(int pageCount, int shapesPerPage, long seed) {
+        return create(pageCount, shapesPerPage, 0, seed);
+    }
+
+    /**
+     * Same pages with given number of link annotations on each, at random rectangles,
+     * alternately pointing to next page and to URI.
+     */
+    static byte[] create(int pageCount, int shapesPerPage, int linksPerPage, long seed) {
+        Random random = new Random(seed);
+        Writer out = new Writer();
+        int fontObject = 3;
+        int firstPageObject = 4;
+
+        out.header();
+        out.object(1, "<< /Type /Catalog /Pages 2 0 R >>");
+
+        StringBuilder kids = new StringBuilder();
+        for (int i = 0; i < pageCount; i++) {
+            kids.append(firstPageObject + i * 2).append(" 0 R ");
+        }
+        out.object(2, "<< /Type /Pages /Kids [" + kids + "] /Count " + pageCount + " >>");
+        out.object(fontObject, "<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica >>");
+
+        for (int i = 0; i < pageCount; i++) {
+            int pageObject = firstPageObject + i * 2;
+            out.object(pageObject, "<< /Type /Page /Parent 2 0 R /MediaBox [0 0 612 792]"
+                    + " /Resources << /Font << /F1 " + fontObject + " 0 R >> >>"
+                    + annotations(i, pageCount, firstPageObject, linksPerPage, random)
+                    + " /Contents " + (pageObject + 1) + " 0 R >>");
+            out.stream(pageObject + 1, content(i, shapesPerPage, random));
+        }
+        return out.finish(1);
+    }
+
+    private static String content(int pageIndex, int shapes, Random random) {
+        StringBuilder content = new StringBuilder();
+        for (int i = 0; i < shapes; i++) {
+            content.append(String.format(Locale.US, "%.2f %.2f %.2f rg %.2f %.2f %.2f RG 2 w ",
+                    random.nextFloat(), random.nextFloat(), random.nextFloat(),
+                    random.nextFloat(), random.nextFloat(), random.nextFloat()));
+            point(content, random).append("m ");
+            for (int j = 0; j < 3; j++) {
+                point(point(point(content, random), random), random).append("c ");
+            }
+            content.append("h B\n");
+        }
+        content.append("0 g BT /F1 14 Tf\n");
+        for (int line = 0; line < 10; line++) {
+            content.append("1 0 0 1 72 ").append(720 - line * 20).append(" Tm (Page ")
+                    .append(pageIndex + 1).append(" line ").append(line + 1).append(") Tj\n");
+        }
+        content.append("ET\n");
+        return content.toString();
+    }
+
+    private static String annotations(int pageIndex, int pageCount, int firstPageObject,
+                                      int links, Random random) {
+        if (links == 0) {
+            return "";
+        }
+        StringBuilder annots = new StringBuilder(" /Annots [");
+        for (int i = 0; i < links; i++) {
+            int x = random.nextInt(552);
+            int y = random.nextInt(772);
+            annots.append("<< /Type /Annot /Subtype /Link /Border [0 0 0] /Rect [").append(x)
+                    .append(' ').append(y).append(' ').append(x + 60).append(' ')
+                    .append(y + 20).append("] ");
+            if (i % 2 == 0) {
+                int target = firstPageObject + ((pageIndex + 1) % pageCount) * 2;
+                annots.append("/Dest [").append(target).append(" 0 R /Fit] >> ");
+            } else {
+                annots.append("/A << /S /URI /URI (https://example.com/").append(pageIndex)
+                        .append('/').append(i).append(") >> >> ");
+            }
+        }
+        return annots.append(']').toString();
+    }
+
+    private static StringBuilder point(StringBuilder content, Random random) {
+        return content.append(random.nextInt(612)).append(' ')
+                .append(random.nextInt(792)).append(' ');
+    }
+
+    private static class Writer {
+        private final ByteArrayOutputStream out = new ByteArrayOutputStream();
+        private final List<Integer> offsets = new ArrayList<>();
+
+        void header() {
+            write("%PDF-1.4\n%\u00e2\u00e3\u00cf\u00d3\n");
+        }
+
+        void object(int number, String body) {
+            mark(number);
+            write(number + " 0 obj\n" + body + "\nendobj\n");
+        }
+
+        void stream(int number, String data) {
+            byte[] bytes = data.getBytes(LATIN1);
+            mark(number);
+            write(number + " 0 obj\n<< /Length " + bytes.length + " >>\nstream\n");
+            out.write(bytes, 0, bytes.length);
+            write("\nendstream\nendobj\n");
+        }
+
+        byte[] finish(int rootObject) {
+            int xrefOffset = out.size();
+            write("xref\n0 " + (offsets.size() + 1) + "\n0000000000 65535 f \n");
+            for (int offset : offsets) {
+                write(String.format(Locale.US, "%010d 00000 n \n", offset));
+            }
+            write("trailer\n<< /Size " + (offsets.size() + 1) + " /Root " + rootObject
+                    + " 0 R >>\nstartxref\n" + xrefOffset + "\n%%EOF\n");
+            return out.toByteArray();
+        }
+
+        private void mark(int number) {
+            while (offsets.size() < number) offsets.add(0);
+            offsets.set(number - 1, out.size());
+        }
+
+        private void write(String text) {
+            byte[] bytes = text.getBytes(LATIN1);
+            out.write(bytes, 0, bytes.length);
+        }
+    }
+}
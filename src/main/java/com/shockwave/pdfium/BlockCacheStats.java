@@ -0,0 +1,48 @@
+package com.shockwave.pdfium;
+
+/** Snapshot of counters of block cache of document opened with block cache access mode */
+public class BlockCacheStats {
+    long requests;
+    long blockHits;
+    long blockMisses;
+    long readCalls;
+    long bytesRead;
+    long readAheadBlocks;
+
+    /*package*/ BlockCacheStats() {
+    }
+
+    /** Number of blocks requested by Pdfium */
+    public long getRequests() {
+        return requests;
+    }
+
+    public long getBlockHits() {
+        return blockHits;
+    }
+
+    public long getBlockMisses() {
+        return blockMisses;
+    }
+
+    /** Number of read system calls */
+    public long getReadCalls() {
+        return readCalls;
+    }
+
+    public long getBytesRead() {
+        return bytesRead;
+    }
+
+    /** Number of blocks read before they were requested */
+    public long getReadAheadBlocks() {
+        return readAheadBlocks;
+    }
+
+    @Override
+    public String toString() {
+        return "requests=" + requests + " hits=" + blockHits + " misses=" + blockMisses
+                + " readCalls=" + readCalls + " bytesRead=" + bytesRead
+                + " readAhead=" + readAheadBlocks;
+    }
+}
@@ -0,0 +1,52 @@
+package com.shockwave.pdfium;
+
+/** Snapshot of counters of native pool of opened documents */
+public class DocumentPoolStats {
+    long acquires;
+    long hits;
+    long misses;
+    long evictions;
+    int documents;
+    int idleDocuments;
+
+    /*package*/ DocumentPoolStats() {
+    }
+
+    /** Number of document opens which looked up pool */
+    public long getAcquires() {
+        return acquires;
+    }
+
+    public long getHits() {
+        return hits;
+    }
+
+    public long getMisses() {
+        return misses;
+    }
+
+    public long getEvictions() {
+        return evictions;
+    }
+
+    /** Number of pooled documents, including idle ones */
+    public int getDocuments() {
+        return documents;
+    }
+
+    /** Number of pooled documents not used by any {@link PdfDocument} */
+    public int getIdleDocuments() {
+        return idleDocuments;
+    }
+
+    public float getReuseRate() {
+        return acquires == 0 ? 0 : (float) hits / acquires;
+    }
+
+    @Override
+    public String toString() {
+        return "acquires=" + acquires + " hits=" + hits + " misses=" + misses
+                + " evictions=" + evictions + " documents=" + documents
+                + " idle=" + idleDocuments;
+    }
+}
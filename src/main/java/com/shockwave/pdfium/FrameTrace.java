@@ -0,0 +1,63 @@
+package com.shockwave.pdfium;
+
+/**
+ * Deadline misses of frames rendered by
+ * {@link PdfiumCore#renderFrame(PdfDocument, RenderJob[], long)}, with details of the most
+ * recent misses.
+ */
+public class FrameTrace {
+    long frames;
+    long misses;
+    long worstOverrunNs;
+    long totalOverrunNs;
+    long[] missFrames;
+    long[] missOverrunNs;
+    int[] missPendingJobs;
+
+    /*package*/ FrameTrace() {
+    }
+
+    /** Number of rendered frames */
+    public long getFrames() {
+        return frames;
+    }
+
+    /** Number of frames which ended after their deadline */
+    public long getMisses() {
+        return misses;
+    }
+
+    public long getWorstOverrunNs() {
+        return worstOverrunNs;
+    }
+
+    public long getTotalOverrunNs() {
+        return totalOverrunNs;
+    }
+
+    /** Number of recent misses kept in trace, oldest first */
+    public int getRecentMissCount() {
+        return missFrames.length;
+    }
+
+    /** Number of frame, counted from 1, in which recent miss happened */
+    public long getRecentMissFrame(int index) {
+        return missFrames[index];
+    }
+
+    /** Time by which frame of recent miss ended after its deadline */
+    public long getRecentMissOverrunNs(int index) {
+        return missOverrunNs[index];
+    }
+
+    /** Number of jobs left unfinished by frame of recent miss */
+    public int getRecentMissPendingJobs(int index) {
+        return missPendingJobs[index];
+    }
+
+    @Override
+    public String toString() {
+        return "frames=" + frames + " misses=" + misses + " worstOverrunNs=" + worstOverrunNs
+                + " totalOverrunNs=" + totalOverrunNs;
+    }
+}
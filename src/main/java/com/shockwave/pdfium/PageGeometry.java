@@ -0,0 +1,39 @@
+package com.shockwave.pdfium;
+
+import com.shockwave.pdfium.util.Size;
+
+/**
+ * Sizes and rotations of all pages of document, returned by
+ * {@link PdfiumCore#getPageGeometry(PdfDocument, String)}.
+ * Sizes are in points and already account for page rotation.
+ */
+public class PageGeometry {
+    /*package*/ float[] values;
+
+    /*package*/ PageGeometry(float[] values) {
+        this.values = values;
+    }
+
+    public int getPageCount() {
+        return values.length / 3;
+    }
+
+    public float getPageWidthPoint(int pageIndex) {
+        return values[pageIndex * 3];
+    }
+
+    public float getPageHeightPoint(int pageIndex) {
+        return values[pageIndex * 3 + 1];
+    }
+
+    /** Rotation of page in clockwise quarter turns, 0 to 3 */
+    public int getPageRotation(int pageIndex) {
+        return (int) values[pageIndex * 3 + 2];
+    }
+
+    /** Size of page in pixels at given dpi, rounded like {@link PdfiumCore#getPageSize(PdfDocument, int)} */
+    public Size getPageSize(int pageIndex, int dpi) {
+        return new Size((int) (getPageWidthPoint(pageIndex) * dpi / 72),
+                (int) (getPageHeightPoint(pageIndex) * dpi / 72));
+    }
+}
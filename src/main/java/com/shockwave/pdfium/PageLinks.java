@@ -0,0 +1,61 @@
+package com.shockwave.pdfium;
+
+import android.graphics.RectF;
+
+/**
+ * All links of one page, returned by {@link PdfiumCore#getPageLinksPacked(PdfDocument, int)}
+ * in packed arrays indexed by link. Coordinates are in page space.
+ */
+public class PageLinks {
+    /*package*/ final float[] rects;
+    /*package*/ final int[] destPageIndices;
+    /*package*/ final String[] uris;
+    /*package*/ final int[] quadOffsets;
+    /*package*/ final float[] quadPoints;
+
+    /*package*/ PageLinks(float[] rects, int[] destPageIndices, String[] uris,
+                          int[] quadOffsets, float[] quadPoints) {
+        this.rects = rects;
+        this.destPageIndices = destPageIndices;
+        this.uris = uris;
+        this.quadOffsets = quadOffsets;
+        this.quadPoints = quadPoints;
+    }
+
+    public int getCount() {
+        return destPageIndices.length;
+    }
+
+    public RectF getBounds(int link) {
+        return new RectF(rects[link * 4], rects[link * 4 + 1],
+                rects[link * 4 + 2], rects[link * 4 + 3]);
+    }
+
+    /** Left, top, right and bottom of every link */
+    public float[] getRects() {
+        return rects;
+    }
+
+    /** Index of destination page, or -1 if link has no destination in document */
+    public int getDestPageIndex(int link) {
+        return destPageIndices[link];
+    }
+
+    /** URI of link action, empty for actions without URI, null if link has no action */
+    public String getUri(int link) {
+        return uris[link];
+    }
+
+    public int getQuadCount(int link) {
+        return quadOffsets[link + 1] - quadOffsets[link];
+    }
+
+    /**
+     * Get corners of quadrilateral of link, as x1, y1, x2, y2, x3, y3, x4, y4.
+     *
+     * @param quad index of quadrilateral, less than {@link #getQuadCount(int)}
+     */
+    public void getQuadPoints(int link, int quad, float[] out) {
+        System.arraycopy(quadPoints, (quadOffsets[link] + quad) * 8, out, 0, 8);
+    }
+}
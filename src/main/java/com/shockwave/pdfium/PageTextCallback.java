@@ -0,0 +1,15 @@
+package com.shockwave.pdfium;
+
+/**
+ * Receives text of pages extracted by
+ * {@link PdfiumCore#extractText(PdfDocument, int, int, PageTextCallback)}, in page order,
+ * on the thread which called it.
+ */
+public interface PageTextCallback {
+    /**
+     * @param text text of page in reading order as stored in document, empty if page
+     *             has no text or cannot be loaded
+     * @return true to continue with next page, false to stop extraction
+     */
+    boolean onPageText(int pageIndex, String text);
+}
@@ -0,0 +1,22 @@
+package com.shockwave.pdfium;
+
+import java.io.IOException;
+
+/**
+ * Random access source of document bytes, for documents which do not live in a file.
+ * Reads are issued from native block cache in block sized chunks, possibly from
+ * render scheduler thread, but never concurrently for one document. Reads requested by
+ * PDFium run while native library lock is held, so implementations must not call
+ * back into PdfiumCore.
+ */
+public interface PdfDataSource {
+    /** Total size of document in bytes */
+    long getSize() throws IOException;
+
+    /**
+     * Read up to size bytes at position into buffer at offset.
+     *
+     * @return number of bytes read, 0 or -1 at end of data
+     */
+    int read(long position, byte[] buffer, int offset, int size) throws IOException;
+}
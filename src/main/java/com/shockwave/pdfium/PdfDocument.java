@@ -103,7 +103,17 @@ public class PdfDocument {
     }
 
     /*package*/ long mNativeDocPtr;
+    /*package*/ long mNativeRenderSchedulerPtr;
+    /*package*/ long mNativeFrameSchedulerPtr;
     /*package*/ ParcelFileDescriptor parcelFileDescriptor;
+    /*
+     * orders native calls on this handle, like closing pages against rendering them.
+     * PDFium calls of all documents, pooled ones included, are serialized by native lock
+     */
+    /*package*/ final Object lock = new Object();
+    /* guards mNativeSearchPtr, so search can be cancelled while lock is held by searchText */
+    /*package*/ final Object searchLock = new Object();
+    /*package*/ long mNativeSearchPtr;
 
     /*package*/ final Map<Integer, Long> mNativePagesPtr = new ArrayMap<>();
 
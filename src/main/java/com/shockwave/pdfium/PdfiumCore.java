@@ -13,6 +13,7 @@ import com.shockwave.pdfium.util.Size;
 import java.io.FileDescriptor;
 import java.io.IOException;
 import java.lang.reflect.Field;
+import java.nio.ByteBuffer;
 import java.util.ArrayList;
 import java.util.List;
 
@@ -33,10 +34,39 @@ public class PdfiumCore {
         }
     }
 
-    private native long nativeOpenDocument(int fd, String password);
+    private native long nativeOpenDocument(int fd, String password, int accessMode,
+                                           int cacheBlockSize, int cacheMaxBlocks,
+                                           int cacheReadAheadBlocks);
+
+    private native long[] nativeGetBlockCacheStats(long docPtr);
+
+    private native void nativeSetDocumentPoolLimits(int maxDocuments, long idleTimeoutMs);
+
+    private native void nativeTrimDocumentPool(boolean all);
+
+    private native long[] nativeGetDocumentPoolStats();
+
+    private native long nativeOpenProgressiveDocument(int fd, long fileSize, String password);
+
+    private native int nativeUpdateDocumentAvailability(long docPtr, long availableBytes);
+
+    private native int nativeIsPageAvailable(long docPtr, int pageIndex);
+
+    private native int nativeIsLinearized(long docPtr);
+
+    private native int nativeGetFirstAvailablePage(long docPtr);
+
+    private native long[] nativeGetNeededRanges(long docPtr);
 
     private native long nativeOpenMemDocument(byte[] data, String password);
 
+    private native long nativeOpenDirectBufferDocument(ByteBuffer buffer, String password);
+
+    private native long nativeOpenDataSourceDocument(PdfDataSource source, long size,
+                                                     String password, int cacheBlockSize,
+                                                     int cacheMaxBlocks,
+                                                     int cacheReadAheadBlocks);
+
     private native void nativeCloseDocument(long docPtr);
 
     private native int nativeGetPageCount(long docPtr);
@@ -67,10 +97,106 @@ public class PdfiumCore {
     private native void nativeRenderPageBitmap(long pagePtr, Bitmap bitmap, int dpi,
                                                int startX, int startY,
                                                int drawSizeHor, int drawSizeVer,
-                                               boolean renderAnnot);
+                                               boolean renderAnnot, boolean dither,
+                                               int bandSize);
+
+    private native void nativeRenderPageBitmapCached(long docPtr, int pageIndex, long pagePtr,
+                                                     Bitmap bitmap, int startX, int startY,
+                                                     int drawSizeHor, int drawSizeVer,
+                                                     boolean renderAnnot, boolean dither,
+                                                     int bandSize);
+
+    private native void nativeSetTileCacheBudget(long bytes);
+
+    private native void nativeClearTileCache();
+
+    private native long[] nativeGetTileCacheStats();
+
+    private native long nativeStartRenderJob(long docPtr, int pageIndex, Bitmap bitmap,
+                                             int startX, int startY,
+                                             int drawSizeHor, int drawSizeVer,
+                                             boolean renderAnnot, int sliceBudgetMs);
+
+    private native int nativeContinueRenderJob(long jobPtr);
+
+    private native void nativeCancelRenderJob(long jobPtr);
+
+    private native boolean nativeRenderJobToBitmap(long jobPtr, Bitmap bitmap);
+
+    private native void nativeCloseRenderJob(long jobPtr);
+
+    private native long nativeOpenFrameScheduler();
+
+    private native void nativeCloseFrameScheduler(long schedulerPtr);
+
+    private native int nativeRenderFrame(long schedulerPtr, long[] jobsPtr, long deadlineNs,
+                                         int[] statusesOut);
+
+    private native long[] nativeGetFrameTrace(long schedulerPtr);
+
+    private native void nativeResetFrameTrace(long schedulerPtr);
+
+    private native long nativeOpenRenderScheduler(long docPtr, int workerCount,
+                                                  RenderCallback callback);
+
+    private native void nativeCloseRenderScheduler(long schedulerPtr);
+
+    private native long nativeSubmitRender(long schedulerPtr, int pageIndex, Bitmap bitmap,
+                                           int startX, int startY,
+                                           int drawSizeHor, int drawSizeVer,
+                                           boolean renderAnnot, boolean dither, int priority);
+
+    private native boolean nativeCancelRender(long schedulerPtr, long requestId);
+
+    private native int[] nativeRenderThumbnailAtlas(long docPtr, Bitmap bitmap,
+                                                    int fromIndex, int toIndex,
+                                                    int cellWidth, int cellHeight,
+                                                    boolean renderAnnot, boolean dither);
+
+    private native String nativeGetDocumentFingerprint(long docPtr);
+
+    private native int nativeExtractText(long docPtr, int fromIndex, int toIndex,
+                                         PageTextCallback callback);
+
+    private native long nativeOpenTextSearch(String query, boolean matchCase, boolean wholeWord);
+
+    private native int nativeSearchText(long docPtr, long searchPtr, int fromIndex, int toIndex,
+                                        SearchCallback callback);
+
+    private native void nativeCancelTextSearch(long searchPtr);
+
+    private native void nativeCloseTextSearch(long searchPtr);
+
+    private native boolean nativeWriteTextIndex(long docPtr, String path);
+
+    private native long nativeOpenTextIndex(long docPtr, String path);
+
+    private native int[] nativeSearchTextIndex(long indexPtr, String query, int maxHits);
+
+    private native void nativeCloseTextIndex(long indexPtr);
+
+    private native float[] nativeGetAllPageSizes(long docPtr);
+
+    private native float[] nativeGetPageGeometry(long docPtr, String path);
+
+    private native boolean nativeWriteThumbnailStore(long docPtr, String path,
+                                                     int maxWidth, int maxHeight,
+                                                     boolean rgb565, boolean renderAnnot);
+
+    private native long nativeOpenThumbnailStore(long docPtr, String path);
+
+    private native boolean nativeIsThumbnailStoreRgb565(long storePtr);
+
+    private native int[] nativeGetThumbnailSizes(long storePtr);
+
+    private native boolean nativeThumbnailToBitmap(long storePtr, int pageIndex, Bitmap bitmap);
+
+    private native void nativeCloseThumbnailStore(long storePtr);
 
     private native String nativeGetDocumentMetaText(long docPtr, String tag);
 
+    private native Object[] nativeGetTableOfContents(long docPtr);
+
     private native Long nativeGetFirstChildBookmark(long docPtr, Long bookmarkPtr);
 
     private native Long nativeGetSiblingBookmark(long docPtr, long bookmarkPtr);
@@ -83,6 +209,8 @@ public class PdfiumCore {
 
     private native long[] nativeGetPageLinks(long pagePtr);
 
+    private native PageLinks nativeGetPageLinksPacked(long docPtr, long pagePtr);
+
     private native Integer nativeGetDestPageIndex(long docPtr, long linkPtr);
 
     private native String nativeGetLinkURI(long docPtr, long linkPtr);
@@ -92,11 +220,64 @@ public class PdfiumCore {
     private native Point nativePageCoordsToDevice(long pagePtr, int startX, int startY, int sizeX,
                                                   int sizeY, int rotate, double pageX, double pageY);
 
+    private native void nativeMapPageCoordsToDevice(long pagePtr, int startX, int startY, int sizeX,
+                                                    int sizeY, int rotate, float[] coords, float[] out,
+                                                    boolean rects);
 
-    /* synchronize native methods */
+    private native void nativeMapDeviceCoordsToPage(long pagePtr, int startX, int startY, int sizeX,
+                                                    int sizeY, int rotate, float[] coords, float[] out,
+                                                    boolean rects);
+
+
+    /** Read blocks of file requested by Pdfium with separate system calls */
+    public static final int ACCESS_MODE_PREAD = 0;
+    /**
+     * Map whole file into memory and copy requested blocks from mapping, which avoids
+     * thousands of system calls when opening large documents. Falls back to
+     * {@link #ACCESS_MODE_PREAD} if file cannot be mapped. File must not be truncated
+     * while document is opened.
+     */
+    public static final int ACCESS_MODE_MMAP = 1;
+    /**
+     * Read file in aligned blocks kept in LRU cache, reading following blocks ahead
+     * when access is sequential. Meant for descriptors which cannot be mapped, like pipes
+     * or files on slow storage. Configured by {@link #setBlockCacheConfig(int, int, int)}.
+     */
+    public static final int ACCESS_MODE_BLOCK_CACHE = 2;
+
+    /** Availability of progressively opened document could not be determined */
+    public static final int DATA_ERROR = -1;
+    /** Data needed by progressively opened document did not arrive yet */
+    public static final int DATA_NOT_AVAILABLE = 0;
+    /** Data needed by progressively opened document is available */
+    public static final int DATA_AVAILABLE = 1;
+
+    public static final int LINEARIZATION_UNKNOWN = -1;
+    public static final int NOT_LINEARIZED = 0;
+    public static final int LINEARIZED = 1;
+
+    /** Render of page fragment which is on screen, scheduled before any other */
+    public static final int PRIORITY_VISIBLE = 0;
+    /** Render of page fragment which is likely to be shown soon */
+    public static final int PRIORITY_PREFETCH = 1;
+    /** Render of thumbnail, scheduled after everything else */
+    public static final int PRIORITY_THUMBNAIL = 2;
+
+    /* synchronize library-global native state, documents are synchronized on their own lock */
     private static final Object lock = new Object();
+    /**
+     * Default size in bytes of scratch buffer used when rendering RGB_565 bitmaps,
+     * 0 renders whole bitmap in one pass
+     */
+    public static final int DEFAULT_RGB565_BAND_SIZE = 0;
     private static Field mFdField = null;
+    private static volatile boolean sTileCacheEnabled = false;
     private int mCurrentDpi;
+    private boolean mDitherRgb565 = false;
+    private int mRgb565BandSize = DEFAULT_RGB565_BAND_SIZE;
+    private int mCacheBlockSize = 64 * 1024;
+    private int mCacheMaxBlocks = 64;
+    private int mCacheReadAheadBlocks = 4;
 
     public static int getNumFd(ParcelFileDescriptor fdObj) {
         try {
@@ -129,15 +310,137 @@ public class PdfiumCore {
 
     /** Create new document from file with password */
     public PdfDocument newDocument(ParcelFileDescriptor fd, String password) throws IOException {
+        return newDocument(fd, password, ACCESS_MODE_PREAD);
+    }
+
+    /**
+     * Create new document from file with password, reading file in given mode.
+     *
+     * @param accessMode {@link #ACCESS_MODE_PREAD} or {@link #ACCESS_MODE_MMAP}
+     */
+    public PdfDocument newDocument(ParcelFileDescriptor fd, String password, int accessMode)
+            throws IOException {
         PdfDocument document = new PdfDocument();
         document.parcelFileDescriptor = fd;
-        synchronized (lock) {
-            document.mNativeDocPtr = nativeOpenDocument(getNumFd(fd), password);
-        }
+        document.mNativeDocPtr = nativeOpenDocument(getNumFd(fd), password, accessMode,
+                mCacheBlockSize, mCacheMaxBlocks, mCacheReadAheadBlocks);
+
+        return document;
+    }
 
+    /**
+     * Open document whose file is still being written, e.g. by downloader, which appends
+     * to it from beginning. Document can be used once
+     * {@link #updateDocumentAvailability(PdfDocument, long)} returns {@link #DATA_AVAILABLE},
+     * its pages once {@link #isPageAvailable(PdfDocument, int)} does. Until then
+     * {@link #getPageCount(PdfDocument)} returns 0, and opening pages, reading metadata,
+     * table of contents or page sizes and rendering atlases or thumbnails throw
+     * {@link IllegalStateException}.
+     *
+     * @param fileSize final size of file in bytes
+     */
+    public PdfDocument newProgressiveDocument(ParcelFileDescriptor fd, long fileSize,
+                                              String password) throws IOException {
+        PdfDocument document = new PdfDocument();
+        document.parcelFileDescriptor = fd;
+        document.mNativeDocPtr = nativeOpenProgressiveDocument(getNumFd(fd), fileSize,
+                password);
         return document;
     }
 
+    /**
+     * Report how many bytes from beginning of file of progressively opened document were
+     * written and load document when enough of them are present. When data is missing,
+     * {@link #getNeededRanges(PdfDocument)} tells which ranges are needed next.
+     *
+     * @return {@link #DATA_AVAILABLE} when document is loaded, {@link #DATA_NOT_AVAILABLE}
+     * or {@link #DATA_ERROR}
+     */
+    public int updateDocumentAvailability(PdfDocument doc, long availableBytes)
+            throws IOException {
+        synchronized (doc.lock) {
+            return nativeUpdateDocumentAvailability(doc.mNativeDocPtr, availableBytes);
+        }
+    }
+
+    /**
+     * Check whether page of progressively opened document can be loaded.
+     * Always {@link #DATA_AVAILABLE} for documents opened otherwise.
+     */
+    public int isPageAvailable(PdfDocument doc, int pageIndex) {
+        synchronized (doc.lock) {
+            return nativeIsPageAvailable(doc.mNativeDocPtr, pageIndex);
+        }
+    }
+
+    /**
+     * Check whether progressively opened document is linearized, which lets its pages
+     * become available one by one instead of after whole file.
+     *
+     * @return {@link #LINEARIZED}, {@link #NOT_LINEARIZED} or {@link #LINEARIZATION_UNKNOWN}
+     */
+    public int isLinearized(PdfDocument doc) {
+        synchronized (doc.lock) {
+            return nativeIsLinearized(doc.mNativeDocPtr);
+        }
+    }
+
+    /** Get index of page which becomes available first in linearized document */
+    public int getFirstAvailablePage(PdfDocument doc) {
+        synchronized (doc.lock) {
+            return nativeGetFirstAvailablePage(doc.mNativeDocPtr);
+        }
+    }
+
+    /**
+     * Get byte ranges requested by last availability check of progressively opened document.
+     *
+     * @return pairs of offset and size, sorted and not overlapping
+     */
+    public long[] getNeededRanges(PdfDocument doc) {
+        synchronized (doc.lock) {
+            long[] ranges = nativeGetNeededRanges(doc.mNativeDocPtr);
+            return ranges != null ? ranges : new long[0];
+        }
+    }
+
+    /**
+     * Configure block cache of documents opened with {@link #ACCESS_MODE_BLOCK_CACHE}
+     * or from {@link PdfDataSource} afterwards.
+     *
+     * @param blockSize       size of block in bytes, reads are aligned to it, default 64 KiB
+     * @param maxBlocks       number of blocks kept in cache, default 64
+     * @param readAheadBlocks number of blocks read ahead on sequential access, default 4
+     */
+    public void setBlockCacheConfig(int blockSize, int maxBlocks, int readAheadBlocks) {
+        mCacheBlockSize = blockSize;
+        mCacheMaxBlocks = maxBlocks;
+        mCacheReadAheadBlocks = readAheadBlocks;
+    }
+
+    /**
+     * Get read counters of document opened with {@link #ACCESS_MODE_BLOCK_CACHE}
+     * or from {@link PdfDataSource}.
+     *
+     * @return counters, or null if document does not use block cache
+     */
+    public BlockCacheStats getBlockCacheStats(PdfDocument doc) {
+        synchronized (doc.lock) {
+            long[] values = nativeGetBlockCacheStats(doc.mNativeDocPtr);
+            if (values == null) {
+                return null;
+            }
+            BlockCacheStats stats = new BlockCacheStats();
+            stats.requests = values[0];
+            stats.blockHits = values[1];
+            stats.blockMisses = values[2];
+            stats.readCalls = values[3];
+            stats.bytesRead = values[4];
+            stats.readAheadBlocks = values[5];
+            return stats;
+        }
+    }
+
     /** Create new document from bytearray */
     public PdfDocument newDocument(byte[] data) throws IOException {
         return newDocument(data, null);
@@ -146,15 +449,45 @@ public class PdfiumCore {
     /** Create new document from bytearray with password */
     public PdfDocument newDocument(byte[] data, String password) throws IOException {
         PdfDocument document = new PdfDocument();
-        synchronized (lock) {
-            document.mNativeDocPtr = nativeOpenMemDocument(data, password);
+        document.mNativeDocPtr = nativeOpenMemDocument(data, password);
+        return document;
+    }
+
+    /**
+     * Create new document from direct ByteBuffer without copying it.
+     * Bytes between position and limit are used, buffer is referenced until document is closed
+     * and must not be modified meanwhile.
+     */
+    public PdfDocument newDocument(ByteBuffer buffer) throws IOException {
+        return newDocument(buffer, null);
+    }
+
+    /** Create new document from direct ByteBuffer with password */
+    public PdfDocument newDocument(ByteBuffer buffer, String password) throws IOException {
+        if (!buffer.isDirect()) {
+            throw new IllegalArgumentException("Buffer must be direct");
         }
+        PdfDocument document = new PdfDocument();
+        document.mNativeDocPtr = nativeOpenDirectBufferDocument(buffer.slice(), password);
+        return document;
+    }
+
+    /**
+     * Create new document reading from arbitrary source through native block cache,
+     * configured by {@link #setBlockCacheConfig(int, int, int)}. Source is referenced
+     * until document is closed.
+     */
+    public PdfDocument newDocument(PdfDataSource source, String password) throws IOException {
+        PdfDocument document = new PdfDocument();
+        long size = source.getSize();
+        document.mNativeDocPtr = nativeOpenDataSourceDocument(source, size, password,
+                mCacheBlockSize, mCacheMaxBlocks, mCacheReadAheadBlocks);
         return document;
     }
 
     /** Get total numer of pages in document */
     public int getPageCount(PdfDocument doc) {
-        synchronized (lock) {
+        synchronized (doc.lock) {
             return nativeGetPageCount(doc.mNativeDocPtr);
         }
     }
@@ -162,7 +495,7 @@ public class PdfiumCore {
     /** Open page and store native pointer in {@link PdfDocument} */
     public long openPage(PdfDocument doc, int pageIndex) {
         long pagePtr;
-        synchronized (lock) {
+        synchronized (doc.lock) {
             pagePtr = nativeLoadPage(doc.mNativeDocPtr, pageIndex);
             doc.mNativePagesPtr.put(pageIndex, pagePtr);
             return pagePtr;
@@ -173,7 +506,7 @@ public class PdfiumCore {
     /** Open range of pages and store native pointers in {@link PdfDocument} */
     public long[] openPage(PdfDocument doc, int fromIndex, int toIndex) {
         long[] pagesPtr;
-        synchronized (lock) {
+        synchronized (doc.lock) {
             pagesPtr = nativeLoadPages(doc.mNativeDocPtr, fromIndex, toIndex);
             int pageIndex = fromIndex;
             for (long page : pagesPtr) {
@@ -191,7 +524,7 @@ public class PdfiumCore {
      * This method requires page to be opened.
      */
     public int getPageWidth(PdfDocument doc, int index) {
-        synchronized (lock) {
+        synchronized (doc.lock) {
             Long pagePtr;
             if ((pagePtr = doc.mNativePagesPtr.get(index)) != null) {
                 return nativeGetPageWidthPixel(pagePtr, mCurrentDpi);
@@ -205,7 +538,7 @@ public class PdfiumCore {
      * This method requires page to be opened.
      */
     public int getPageHeight(PdfDocument doc, int index) {
-        synchronized (lock) {
+        synchronized (doc.lock) {
             Long pagePtr;
             if ((pagePtr = doc.mNativePagesPtr.get(index)) != null) {
                 return nativeGetPageHeightPixel(pagePtr, mCurrentDpi);
@@ -219,7 +552,7 @@ public class PdfiumCore {
      * This method requires page to be opened.
      */
     public int getPageWidthPoint(PdfDocument doc, int index) {
-        synchronized (lock) {
+        synchronized (doc.lock) {
             Long pagePtr;
             if ((pagePtr = doc.mNativePagesPtr.get(index)) != null) {
                 return nativeGetPageWidthPoint(pagePtr);
@@ -233,7 +566,7 @@ public class PdfiumCore {
      * This method requires page to be opened.
      */
     public int getPageHeightPoint(PdfDocument doc, int index) {
-        synchronized (lock) {
+        synchronized (doc.lock) {
             Long pagePtr;
             if ((pagePtr = doc.mNativePagesPtr.get(index)) != null) {
                 return nativeGetPageHeightPoint(pagePtr);
@@ -247,11 +580,119 @@ public class PdfiumCore {
      * This method does not require given page to be opened.
      */
     public Size getPageSize(PdfDocument doc, int index) {
-        synchronized (lock) {
+        synchronized (doc.lock) {
             return nativeGetPageSizeByIndex(doc.mNativeDocPtr, index, mCurrentDpi);
         }
     }
 
+    /**
+     * Get sizes of all pages in one call, as width and height in points of every page,
+     * not rounded and with page rotation applied. Pages do not need to be opened.
+     */
+    public float[] getAllPageSizes(PdfDocument doc) {
+        synchronized (doc.lock) {
+            return nativeGetAllPageSizes(doc.mNativeDocPtr);
+        }
+    }
+
+    /**
+     * Extract text of pages [fromIndex, toIndex] and pass it to callback page by page,
+     * so text of whole document does not have to be kept in memory. Pages do not need to be
+     * opened. Pages are extracted one after another on calling thread.
+     *
+     * @return number of pages passed to callback
+     * @throws IndexOutOfBoundsException if range is not within pages of document
+     */
+    public int extractText(PdfDocument doc, int fromIndex, int toIndex,
+                           PageTextCallback callback) {
+        synchronized (doc.lock) {
+            checkPageRange(doc, fromIndex, toIndex);
+            return nativeExtractText(doc.mNativeDocPtr, fromIndex, toIndex, callback);
+        }
+    }
+
+    /**
+     * Find all occurrences of query on pages [fromIndex, toIndex] with rectangles of every hit.
+     * Hits are passed to callback in batches, as soon as every window of few pages is searched,
+     * so first hits can be shown before whole document is searched. Search is cancelled when
+     * callback returns false or by {@link #cancelSearch(PdfDocument)}. Pages do not need to be
+     * opened. Pages are searched one after another on calling thread.
+     *
+     * @return number of pages searched
+     * @throws IndexOutOfBoundsException if range is not within pages of document
+     */
+    public int searchText(PdfDocument doc, String query, int fromIndex, int toIndex,
+                          boolean matchCase, boolean wholeWord, SearchCallback callback) {
+        synchronized (doc.lock) {
+            checkPageRange(doc, fromIndex, toIndex);
+            long searchPtr = nativeOpenTextSearch(query, matchCase, wholeWord);
+            if (searchPtr == 0) {
+                return 0;
+            }
+            synchronized (doc.searchLock) {
+                doc.mNativeSearchPtr = searchPtr;
+            }
+            try {
+                return nativeSearchText(doc.mNativeDocPtr, searchPtr, fromIndex, toIndex,
+                        callback);
+            } finally {
+                synchronized (doc.searchLock) {
+                    doc.mNativeSearchPtr = 0;
+                }
+                nativeCloseTextSearch(searchPtr);
+            }
+        }
+    }
+
+    /**
+     * Cancel {@link #searchText(PdfDocument, String, int, int, boolean, boolean, SearchCallback)}
+     * running on document. May be called from any thread, search stops before its next page
+     * and hits of pages searched since last callback are dropped. Does nothing if no search
+     * is running.
+     */
+    public void cancelSearch(PdfDocument doc) {
+        synchronized (doc.searchLock) {
+            if (doc.mNativeSearchPtr != 0) {
+                nativeCancelTextSearch(doc.mNativeSearchPtr);
+            }
+        }
+    }
+
+    /** Pages [fromIndex, toIndex] must exist, empty range with toIndex < fromIndex is allowed */
+    private void checkPageRange(PdfDocument doc, int fromIndex, int toIndex) {
+        int pageCount = nativeGetPageCount(doc.mNativeDocPtr);
+        if (toIndex >= fromIndex && (fromIndex < 0 || toIndex >= pageCount)) {
+            throw new IndexOutOfBoundsException("Pages " + fromIndex + " to " + toIndex
+                    + " of document with " + pageCount + " pages");
+        }
+    }
+
+    /**
+     * Enable ordered (4x4 Bayer) dithering when rendering to RGB_565 bitmaps,
+     * which removes banding on gradients at no visible cost in detail.
+     * Applies to regular, scheduled and thumbnail atlas rendering.
+     * Disabled by default.
+     */
+    public void setRgb565Dithering(boolean enabled) {
+        mDitherRgb565 = enabled;
+    }
+
+    /**
+     * Set size in bytes of scratch buffer used when rendering RGB_565 bitmaps. Page is rendered
+     * in horizontal bands which fit in this buffer, so extra memory does not grow with bitmap size.
+     * 0, the default, renders whole bitmap at once.
+     * <p>
+     * Banding trades CPU for memory: every band is a separate PDFium render pass, which parses
+     * and clips all page objects again, so a page split into n bands costs up to n times more
+     * CPU. Use it only when the 3 bytes per pixel scratch of a whole bitmap is a problem, and
+     * prefer bands of several MiB, e.g. <code>4 * 1024 * 1024</code>.
+     * Renders of render scheduler are not banded, their whole scratch is handed from render
+     * thread to worker thread.
+     */
+    public void setRgb565BandSize(int bytes) {
+        mRgb565BandSize = bytes;
+    }
+
     /**
      * Render page fragment on {@link Surface}.<br>
      * Page must be opened before rendering.
@@ -268,7 +709,7 @@ public class PdfiumCore {
     public void renderPage(PdfDocument doc, Surface surface, int pageIndex,
                            int startX, int startY, int drawSizeX, int drawSizeY,
                            boolean renderAnnot) {
-        synchronized (lock) {
+        synchronized (doc.lock) {
             try {
                 //nativeRenderPage(doc.mNativePagesPtr.get(pageIndex), surface, mCurrentDpi);
                 nativeRenderPage(doc.mNativePagesPtr.get(pageIndex), surface, mCurrentDpi,
@@ -307,10 +748,18 @@ public class PdfiumCore {
     public void renderPageBitmap(PdfDocument doc, Bitmap bitmap, int pageIndex,
                                  int startX, int startY, int drawSizeX, int drawSizeY,
                                  boolean renderAnnot) {
-        synchronized (lock) {
+        synchronized (doc.lock) {
             try {
-                nativeRenderPageBitmap(doc.mNativePagesPtr.get(pageIndex), bitmap, mCurrentDpi,
-                        startX, startY, drawSizeX, drawSizeY, renderAnnot);
+                if (sTileCacheEnabled) {
+                    nativeRenderPageBitmapCached(doc.mNativeDocPtr, pageIndex,
+                            doc.mNativePagesPtr.get(pageIndex), bitmap,
+                            startX, startY, drawSizeX, drawSizeY, renderAnnot, mDitherRgb565,
+                            mRgb565BandSize);
+                } else {
+                    nativeRenderPageBitmap(doc.mNativePagesPtr.get(pageIndex), bitmap, mCurrentDpi,
+                            startX, startY, drawSizeX, drawSizeY, renderAnnot, mDitherRgb565,
+                            mRgb565BandSize);
+                }
             } catch (NullPointerException e) {
                 Log.e(TAG, "mContext may be null");
                 e.printStackTrace();
@@ -321,9 +770,308 @@ public class PdfiumCore {
         }
     }
 
+    /**
+     * Set byte budget of native cache of rendered bitmap fragments, shared by all documents.
+     * When enabled, {@link #renderPageBitmap(PdfDocument, Bitmap, int, int, int, int, int, boolean)}
+     * copies fragment rendered before with the same page, position, size and options instead
+     * of rendering it again. Least recently used fragments are evicted when budget is exceeded.
+     *
+     * @param bytes budget in bytes, 0 disables cache and releases cached fragments
+     */
+    public void setTileCacheSize(long bytes) {
+        synchronized (lock) {
+            nativeSetTileCacheBudget(bytes);
+            sTileCacheEnabled = bytes > 0;
+        }
+    }
+
+    /** Release all fragments held by native tile cache */
+    public void clearTileCache() {
+        synchronized (lock) {
+            nativeClearTileCache();
+        }
+    }
+
+    /**
+     * Enable process wide pool of opened documents, shared by all PdfiumCore instances.
+     * While enabled, documents opened from file with
+     * {@link #newDocument(ParcelFileDescriptor, String, int)} share one parsed native
+     * document when their file has the same device, inode, size and modification time,
+     * password matches and they were opened with the same access mode and block cache
+     * settings. Closed documents are kept until idle timeout or until their
+     * slot is needed.
+     *
+     * @param maxDocuments  cap on pooled documents, 0 disables pooling and releases idle documents
+     * @param idleTimeoutMs time unused documents stay pooled, 0 keeps them until evicted by cap
+     */
+    public void setDocumentPoolConfig(int maxDocuments, long idleTimeoutMs) {
+        synchronized (lock) {
+            nativeSetDocumentPoolLimits(maxDocuments, idleTimeoutMs);
+        }
+    }
+
+    /** Release documents of pool which are not used, or only those past idle timeout */
+    public void trimDocumentPool(boolean all) {
+        synchronized (lock) {
+            nativeTrimDocumentPool(all);
+        }
+    }
+
+    /** Get reuse counters of native document pool */
+    public DocumentPoolStats getDocumentPoolStats() {
+        synchronized (lock) {
+            long[] values = nativeGetDocumentPoolStats();
+            DocumentPoolStats stats = new DocumentPoolStats();
+            stats.acquires = values[0];
+            stats.hits = values[1];
+            stats.misses = values[2];
+            stats.evictions = values[3];
+            stats.documents = (int) values[4];
+            stats.idleDocuments = (int) values[5];
+            return stats;
+        }
+    }
+
+    /** Get hit, miss and eviction counters of native tile cache */
+    public TileCacheStats getTileCacheStats() {
+        synchronized (lock) {
+            long[] values = nativeGetTileCacheStats();
+            TileCacheStats stats = new TileCacheStats();
+            stats.hits = values[0];
+            stats.misses = values[1];
+            stats.evictions = values[2];
+            stats.bytes = values[3];
+            stats.budget = values[4];
+            stats.entries = (int) values[5];
+            return stats;
+        }
+    }
+
+    /**
+     * Start progressive render of page fragment. Nothing is rendered until
+     * {@link #continueRenderJob(RenderJob)} is called, every call renders for at most
+     * about <code>sliceBudgetMs</code> milliseconds.<br>
+     * Page does not need to be opened, every job renders its own instance of the page,
+     * so jobs of the same page and regular rendering of that page do not disturb each other.
+     * Document must not be closed until job is closed.
+     *
+     * @param bitmap bitmap which defines size and format of rendered fragment,
+     *               pixels are copied into it by {@link #renderJobToBitmap(RenderJob, Bitmap)}
+     * @return job handle, or null if render could not be started
+     */
+    public RenderJob startRenderJob(PdfDocument doc, Bitmap bitmap, int pageIndex,
+                                    int startX, int startY, int drawSizeX, int drawSizeY,
+                                    boolean renderAnnot, int sliceBudgetMs) {
+        synchronized (doc.lock) {
+            long jobPtr = nativeStartRenderJob(doc.mNativeDocPtr, pageIndex, bitmap, startX, startY,
+                    drawSizeX, drawSizeY, renderAnnot, sliceBudgetMs);
+            if (jobPtr == 0) {
+                return null;
+            }
+            RenderJob job = new RenderJob();
+            job.mNativePtr = jobPtr;
+            job.lock = doc.lock;
+            job.pageIndex = pageIndex;
+            return job;
+        }
+    }
+
+    /**
+     * Render next time slice of job.
+     *
+     * @return one of <code>RenderJob.STATUS_*</code> constants
+     */
+    public int continueRenderJob(RenderJob job) {
+        synchronized (job.lock) {
+            if (job.mNativePtr == 0 || job.isFinished()) {
+                return job.status;
+            }
+            job.status = nativeContinueRenderJob(job.mNativePtr);
+            return job.status;
+        }
+    }
+
+    /**
+     * Cancel job. Can be called from any thread, slice rendered at the moment
+     * is abandoned within few milliseconds.
+     */
+    public void cancelRenderJob(RenderJob job) {
+        synchronized (job) {
+            if (job.mNativePtr != 0) {
+                nativeCancelRenderJob(job.mNativePtr);
+            }
+        }
+    }
+
+    /**
+     * Copy pixels rendered so far into bitmap, which must have the same size and format
+     * as bitmap passed to
+     * {@link #startRenderJob(PdfDocument, Bitmap, int, int, int, int, int, boolean, int)}
+     */
+    public boolean renderJobToBitmap(RenderJob job, Bitmap bitmap) {
+        synchronized (job.lock) {
+            return job.mNativePtr != 0 && nativeRenderJobToBitmap(job.mNativePtr, bitmap);
+        }
+    }
+
+    /** Release native resources of job, must be called before its document is closed */
+    public void closeRenderJob(RenderJob job) {
+        synchronized (job.lock) {
+            synchronized (job) {
+                if (job.mNativePtr != 0) {
+                    nativeCloseRenderJob(job.mNativePtr);
+                    job.mNativePtr = 0;
+                }
+            }
+        }
+    }
+
+    /**
+     * Render jobs of visible tiles within one frame. Time left until deadline is split into
+     * slices across unfinished jobs, earlier jobs in array are served first in every round.
+     * Jobs which do not finish are incomplete, their pixels rendered so far can still be
+     * shown through {@link #renderJobToBitmap(RenderJob, Bitmap)} and they continue when
+     * passed to next frame. Frames which end after deadline are recorded in
+     * {@link #getFrameTrace(PdfDocument)}.
+     *
+     * @param jobs          jobs started by
+     *                      {@link #startRenderJob(PdfDocument, Bitmap, int, int, int, int, int, boolean, int)},
+     *                      finished and closed jobs are skipped, cancelled jobs end with
+     *                      {@link RenderJob#STATUS_CANCELLED}
+     * @param deadlineNanos end of rendering in {@link System#nanoTime()} time base, e.g. frame
+     *                      time of Choreographer plus frame interval minus time to draw tiles
+     * @return number of jobs left incomplete
+     */
+    public int renderFrame(PdfDocument doc, RenderJob[] jobs, long deadlineNanos) {
+        synchronized (doc.lock) {
+            if (doc.mNativeFrameSchedulerPtr == 0) {
+                doc.mNativeFrameSchedulerPtr = nativeOpenFrameScheduler();
+            }
+
+            long[] jobsPtr = new long[jobs.length];
+            for (int i = 0; i < jobs.length; i++) {
+                jobsPtr[i] = jobs[i].isFinished() ? 0 : jobs[i].mNativePtr;
+            }
+            int[] statuses = new int[jobs.length];
+            int incomplete = nativeRenderFrame(doc.mNativeFrameSchedulerPtr, jobsPtr,
+                    deadlineNanos, statuses);
+
+            for (int i = 0; i < jobs.length; i++) {
+                if (jobsPtr[i] != 0) {
+                    jobs[i].status = statuses[i];
+                }
+            }
+            return incomplete;
+        }
+    }
+
+    /** Get deadline misses of {@link #renderFrame(PdfDocument, RenderJob[], long)} */
+    public FrameTrace getFrameTrace(PdfDocument doc) {
+        synchronized (doc.lock) {
+            FrameTrace trace = new FrameTrace();
+            long[] values = doc.mNativeFrameSchedulerPtr != 0
+                    ? nativeGetFrameTrace(doc.mNativeFrameSchedulerPtr) : new long[4];
+            trace.frames = values[0];
+            trace.misses = values[1];
+            trace.worstOverrunNs = values[2];
+            trace.totalOverrunNs = values[3];
+
+            int count = (values.length - 4) / 3;
+            trace.missFrames = new long[count];
+            trace.missOverrunNs = new long[count];
+            trace.missPendingJobs = new int[count];
+            for (int i = 0; i < count; i++) {
+                trace.missFrames[i] = values[4 + i * 3];
+                trace.missOverrunNs[i] = values[4 + i * 3 + 1];
+                trace.missPendingJobs[i] = (int) values[4 + i * 3 + 2];
+            }
+            return trace;
+        }
+    }
+
+    /** Clear counters and recent misses of frame trace */
+    public void resetFrameTrace(PdfDocument doc) {
+        synchronized (doc.lock) {
+            if (doc.mNativeFrameSchedulerPtr != 0) {
+                nativeResetFrameTrace(doc.mNativeFrameSchedulerPtr);
+            }
+        }
+    }
+
+    /**
+     * Open native render scheduler of document, used by
+     * {@link #submitRender(PdfDocument, Bitmap, int, int, int, int, int, boolean, int)}.
+     * One render thread renders pages of the document, worker threads convert its output
+     * into bitmaps and call back, so conversion and callbacks overlap with rendering.
+     *
+     * @param workerCount number of worker threads, 0 or less uses one worker per CPU core
+     * @param callback    receives completion of every submitted render
+     */
+    public void openRenderScheduler(PdfDocument doc, int workerCount, RenderCallback callback)
+            throws IOException {
+        closeRenderScheduler(doc);
+        synchronized (doc.lock) {
+            doc.mNativeRenderSchedulerPtr = nativeOpenRenderScheduler(doc.mNativeDocPtr,
+                    workerCount, callback);
+        }
+    }
+
+    /**
+     * Queue render of page fragment into bitmap, same semantics as
+     * {@link #renderPageBitmap(PdfDocument, Bitmap, int, int, int, int, int, boolean)}.
+     * Queued renders run by priority, then in order of submission. Render of fragment which
+     * is already queued or rendering, with the same position, size, format and options,
+     * is merged into it and raises its priority if needed. Bitmap must not be used until
+     * render is completed. Page does not need to be opened.
+     *
+     * @param priority {@link #PRIORITY_VISIBLE}, {@link #PRIORITY_PREFETCH}
+     *                 or {@link #PRIORITY_THUMBNAIL}
+     * @return id of request passed to {@link RenderCallback}, 0 if render was not queued
+     */
+    public long submitRender(PdfDocument doc, Bitmap bitmap, int pageIndex,
+                             int startX, int startY, int drawSizeX, int drawSizeY,
+                             boolean renderAnnot, int priority) {
+        synchronized (doc.lock) {
+            if (doc.mNativeRenderSchedulerPtr == 0) {
+                throw new IllegalStateException("Render scheduler is not opened");
+            }
+            return nativeSubmitRender(doc.mNativeRenderSchedulerPtr, pageIndex, bitmap,
+                    startX, startY, drawSizeX, drawSizeY, renderAnnot, mDitherRgb565, priority);
+        }
+    }
+
+    /**
+     * Cancel submitted render. Queued render is completed as cancelled before this method
+     * returns, running one once its worker finishes.
+     *
+     * @return false if render was already completed
+     */
+    public boolean cancelRender(PdfDocument doc, long requestId) {
+        synchronized (doc.lock) {
+            return doc.mNativeRenderSchedulerPtr != 0
+                    && nativeCancelRender(doc.mNativeRenderSchedulerPtr, requestId);
+        }
+    }
+
+    /**
+     * Stop render workers of document. Queued renders are completed as cancelled,
+     * running ones are finished first.
+     */
+    public void closeRenderScheduler(PdfDocument doc) {
+        long schedulerPtr;
+        synchronized (doc.lock) {
+            schedulerPtr = doc.mNativeRenderSchedulerPtr;
+            doc.mNativeRenderSchedulerPtr = 0;
+        }
+        //Callbacks of finishing workers may call back into this document
+        if (schedulerPtr != 0) {
+            nativeCloseRenderScheduler(schedulerPtr);
+        }
+    }
+
     /** close specific page */
     public void closePage(PdfDocument doc, int pageIndex) {
-        synchronized (lock) {
+        synchronized (doc.lock) {
             if (doc.mNativePagesPtr.containsKey(pageIndex)) {
                 long pagePtr = doc.mNativePagesPtr.get(pageIndex);
                 nativeClosePage(pagePtr);
@@ -334,12 +1082,18 @@ public class PdfiumCore {
 
     /** Release native resources and opened file */
     public void closeDocument(PdfDocument doc) {
-        synchronized (lock) {
+        closeRenderScheduler(doc);
+        synchronized (doc.lock) {
             for (Integer index : doc.mNativePagesPtr.keySet()) {
                 nativeClosePage(doc.mNativePagesPtr.get(index));
             }
             doc.mNativePagesPtr.clear();
 
+            if (doc.mNativeFrameSchedulerPtr != 0) {
+                nativeCloseFrameScheduler(doc.mNativeFrameSchedulerPtr);
+                doc.mNativeFrameSchedulerPtr = 0;
+            }
+
             nativeCloseDocument(doc.mNativeDocPtr);
 
             if (doc.parcelFileDescriptor != null) { //if document was loaded from file
@@ -353,9 +1107,188 @@ public class PdfiumCore {
         }
     }
 
+    /**
+     * Render thumbnails of page range into grid of <code>cellWidth x cellHeight</code> cells of
+     * one bitmap, row by row. Thumbnails keep aspect ratio and are centered in their cells, pages
+     * which do not fit in bitmap are skipped. Pages do not need to be opened.
+     * Pages are rendered one after another on calling thread.
+     *
+     * @return left, top, right and bottom of thumbnail of every page in range,
+     * zeros for pages which were not rendered
+     * @throws IndexOutOfBoundsException if range is not within pages of document
+     * @throws IllegalArgumentException  if cell size is not positive
+     */
+    public int[] renderThumbnailAtlas(PdfDocument doc, Bitmap bitmap, int fromIndex, int toIndex,
+                                      int cellWidth, int cellHeight, boolean renderAnnot) {
+        if (cellWidth <= 0 || cellHeight <= 0) {
+            throw new IllegalArgumentException("Cell size " + cellWidth + "x" + cellHeight);
+        }
+        synchronized (doc.lock) {
+            checkPageRange(doc, fromIndex, toIndex);
+            return nativeRenderThumbnailAtlas(doc.mNativeDocPtr, bitmap,
+                    fromIndex, toIndex, cellWidth, cellHeight, renderAnnot, mDitherRgb565);
+        }
+    }
+
+    /**
+     * Get fingerprint of document content, which can be used to name cache files.
+     * Documents not opened from file have no fingerprint.
+     *
+     * @return hex string, or null
+     */
+    public String getDocumentFingerprint(PdfDocument doc) {
+        synchronized (doc.lock) {
+            return nativeGetDocumentFingerprint(doc.mNativeDocPtr);
+        }
+    }
+
+    /**
+     * Get size and rotation of every page. Pages have to be loaded to know their rotation,
+     * so when path is given, result is stored in that file and read back without loading
+     * any page next time the same document is opened. Pages are measured one after another
+     * on the calling thread.
+     *
+     * @param path path of geometry file, replaced atomically, or null to not persist it
+     * @return geometry, or null if document is not loaded
+     */
+    public PageGeometry getPageGeometry(PdfDocument doc, String path) {
+        float[] values;
+        synchronized (doc.lock) {
+            values = nativeGetPageGeometry(doc.mNativeDocPtr, path);
+        }
+        return values != null ? new PageGeometry(values) : null;
+    }
+
+    /**
+     * Render thumbnails of all pages and write them to file, which can be opened by
+     * {@link #openThumbnailStore(PdfDocument, String)} every time document is opened again.
+     * Document must be opened from file.
+     *
+     * @param path      path of thumbnail file, replaced atomically
+     * @param maxWidth  maximum width of thumbnail, aspect ratio of page is kept
+     * @param maxHeight maximum height of thumbnail
+     * @param config    {@link Bitmap.Config#ARGB_8888} or {@link Bitmap.Config#RGB_565}
+     * @return true if file was written
+     */
+    public boolean writeThumbnailStore(PdfDocument doc, String path, int maxWidth, int maxHeight,
+                                       Bitmap.Config config, boolean renderAnnot) {
+        synchronized (doc.lock) {
+            return nativeWriteThumbnailStore(doc.mNativeDocPtr, path, maxWidth, maxHeight,
+                    config == Bitmap.Config.RGB_565, renderAnnot);
+        }
+    }
+
+    /**
+     * Open thumbnail file written by
+     * {@link #writeThumbnailStore(PdfDocument, String, int, int, Bitmap.Config, boolean)}.
+     *
+     * @return store, or null if file does not exist or was written for other version of document
+     */
+    public ThumbnailStore openThumbnailStore(PdfDocument doc, String path) {
+        long storePtr;
+        synchronized (doc.lock) {
+            storePtr = nativeOpenThumbnailStore(doc.mNativeDocPtr, path);
+        }
+        if (storePtr == 0) {
+            return null;
+        }
+
+        ThumbnailStore store = new ThumbnailStore();
+        store.mNativePtr = storePtr;
+        store.sizes = nativeGetThumbnailSizes(storePtr);
+        store.config = nativeIsThumbnailStoreRgb565(storePtr)
+                ? Bitmap.Config.RGB_565 : Bitmap.Config.ARGB_8888;
+        return store;
+    }
+
+    /**
+     * Copy thumbnail of page into top left corner of bitmap. Bitmap must have configuration of
+     * store and be at least {@link ThumbnailStore#getThumbnailSize(int)} large.
+     * Does not use PDFium, so it does not wait for rendering of other pages.
+     */
+    public boolean renderThumbnail(ThumbnailStore store, int pageIndex, Bitmap bitmap) {
+        synchronized (store) {
+            return store.mNativePtr != 0
+                    && nativeThumbnailToBitmap(store.mNativePtr, pageIndex, bitmap);
+        }
+    }
+
+    /** Unmap thumbnail file */
+    public void closeThumbnailStore(ThumbnailStore store) {
+        synchronized (store) {
+            if (store.mNativePtr != 0) {
+                nativeCloseThumbnailStore(store.mNativePtr);
+                store.mNativePtr = 0;
+            }
+        }
+    }
+
+    /**
+     * Extract text of all pages and write inverted index of it to file, which can be opened by
+     * {@link #openTextIndex(PdfDocument, String)} every time document is opened again.
+     * Document must be opened from file. Pages are extracted one after another on calling
+     * thread.
+     *
+     * @param path path of index file, replaced atomically
+     * @return true if file was written
+     */
+    public boolean writeTextIndex(PdfDocument doc, String path) {
+        synchronized (doc.lock) {
+            return nativeWriteTextIndex(doc.mNativeDocPtr, path);
+        }
+    }
+
+    /**
+     * Open index file written by {@link #writeTextIndex(PdfDocument, String)}.
+     *
+     * @return index, or null if file does not exist or was written for other version of document
+     */
+    public TextIndex openTextIndex(PdfDocument doc, String path) {
+        long indexPtr;
+        synchronized (doc.lock) {
+            indexPtr = nativeOpenTextIndex(doc.mNativeDocPtr, path);
+        }
+        if (indexPtr == 0) {
+            return null;
+        }
+
+        TextIndex index = new TextIndex();
+        index.mNativePtr = indexPtr;
+        return index;
+    }
+
+    /**
+     * Find word or phrase in index. Case and punctuation are ignored, words of phrase must
+     * follow each other on page. Does not use PDFium, so it does not wait for rendering.
+     *
+     * @param maxHits maximum number of hits, 0 for all
+     * @return page index, char index and char count of every hit, in page order. Char index
+     * is offset in page text passed by
+     * {@link #extractText(PdfDocument, int, int, PageTextCallback)}
+     * @throws IOException if index file is corrupted
+     */
+    public int[] searchTextIndex(TextIndex index, String query, int maxHits) throws IOException {
+        synchronized (index) {
+            if (index.mNativePtr == 0) {
+                return new int[0];
+            }
+            return nativeSearchTextIndex(index.mNativePtr, query, maxHits);
+        }
+    }
+
+    /** Unmap index file */
+    public void closeTextIndex(TextIndex index) {
+        synchronized (index) {
+            if (index.mNativePtr != 0) {
+                nativeCloseTextIndex(index.mNativePtr);
+                index.mNativePtr = 0;
+            }
+        }
+    }
+
     /** Get metadata for given document */
     public PdfDocument.Meta getDocumentMeta(PdfDocument doc) {
-        synchronized (lock) {
+        synchronized (doc.lock) {
             PdfDocument.Meta meta = new PdfDocument.Meta();
             meta.title = nativeGetDocumentMetaText(doc.mNativeDocPtr, "Title");
             meta.author = nativeGetDocumentMetaText(doc.mNativeDocPtr, "Author");
@@ -372,54 +1305,65 @@ public class PdfiumCore {
 
     /** Get table of contents (bookmarks) for given document */
     public List<PdfDocument.Bookmark> getTableOfContents(PdfDocument doc) {
-        synchronized (lock) {
-            List<PdfDocument.Bookmark> topLevel = new ArrayList<>();
-            Long first = nativeGetFirstChildBookmark(doc.mNativeDocPtr, null);
-            if (first != null) {
-                recursiveGetBookmark(topLevel, doc, first);
-            }
-            return topLevel;
+        Object[] outline;
+        synchronized (doc.lock) {
+            outline = nativeGetTableOfContents(doc.mNativeDocPtr);
         }
-    }
-
-    private void recursiveGetBookmark(List<PdfDocument.Bookmark> tree, PdfDocument doc, long bookmarkPtr) {
-        PdfDocument.Bookmark bookmark = new PdfDocument.Bookmark();
-        bookmark.mNativePtr = bookmarkPtr;
-        bookmark.title = nativeGetBookmarkTitle(bookmarkPtr);
-        bookmark.pageIdx = nativeGetBookmarkDestIndex(doc.mNativeDocPtr, bookmarkPtr);
-        tree.add(bookmark);
-
-        Long child = nativeGetFirstChildBookmark(doc.mNativeDocPtr, bookmarkPtr);
-        if (child != null) {
-            recursiveGetBookmark(bookmark.getChildren(), doc, child);
+        List<PdfDocument.Bookmark> topLevel = new ArrayList<>();
+        if (outline == null) {
+            return topLevel;
         }
 
-        Long sibling = nativeGetSiblingBookmark(doc.mNativeDocPtr, bookmarkPtr);
-        if (sibling != null) {
-            recursiveGetBookmark(tree, doc, sibling);
+        //Whole outline in preorder, parent of every bookmark comes before it
+        String[] titles = (String[]) outline[0];
+        long[] pageIndices = (long[]) outline[1];
+        int[] parents = (int[]) outline[2];
+        long[] pointers = (long[]) outline[4];
+        PdfDocument.Bookmark[] bookmarks = new PdfDocument.Bookmark[titles.length];
+        for (int i = 0; i < titles.length; i++) {
+            PdfDocument.Bookmark bookmark = new PdfDocument.Bookmark();
+            bookmark.mNativePtr = pointers[i];
+            bookmark.title = titles[i];
+            bookmark.pageIdx = pageIndices[i];
+            bookmarks[i] = bookmark;
+
+            if (parents[i] < 0) {
+                topLevel.add(bookmark);
+            } else {
+                bookmarks[parents[i]].getChildren().add(bookmark);
+            }
         }
+        return topLevel;
     }
 
     /** Get all links from given page */
     public List<PdfDocument.Link> getPageLinks(PdfDocument doc, int pageIndex) {
-        synchronized (lock) {
-            List<PdfDocument.Link> links = new ArrayList<>();
+        List<PdfDocument.Link> links = new ArrayList<>();
+        PageLinks packed = getPageLinksPacked(doc, pageIndex);
+        if (packed == null) {
+            return links;
+        }
+        for (int i = 0; i < packed.getCount(); i++) {
+            int destIndex = packed.getDestPageIndex(i);
+            links.add(new PdfDocument.Link(packed.getBounds(i),
+                    destIndex >= 0 ? destIndex : null, packed.getUri(i)));
+        }
+        return links;
+    }
+
+    /**
+     * Get all links from given page with single native call, including their quadrilaterals.
+     * Page must be opened.
+     *
+     * @return links, or null if page is not opened
+     */
+    public PageLinks getPageLinksPacked(PdfDocument doc, int pageIndex) {
+        synchronized (doc.lock) {
             Long nativePagePtr = doc.mNativePagesPtr.get(pageIndex);
             if (nativePagePtr == null) {
-                return links;
-            }
-            long[] linkPtrs = nativeGetPageLinks(nativePagePtr);
-            for (long linkPtr : linkPtrs) {
-                Integer index = nativeGetDestPageIndex(doc.mNativeDocPtr, linkPtr);
-                String uri = nativeGetLinkURI(doc.mNativeDocPtr, linkPtr);
-
-                RectF rect = nativeGetLinkRect(linkPtr);
-                if (rect != null && (index != null || uri != null)) {
-                    links.add(new PdfDocument.Link(rect, index, uri));
-                }
-
+                return null;
             }
-            return links;
+            return nativeGetPageLinksPacked(doc.mNativeDocPtr, nativePagePtr);
         }
     }
 
@@ -457,4 +1401,64 @@ public class PdfiumCore {
                 coords.right, coords.bottom);
         return new RectF(leftTop.x, leftTop.y, rightBottom.x, rightBottom.y);
     }
+
+    /**
+     * Map many page points to device coordinates with one transform, page must be opened
+     *
+     * @param points x, y pairs in page coordinates
+     * @param out    array of at least points.length for device coordinates, may be points
+     * @see PdfiumCore#mapPageCoordsToDevice(PdfDocument, int, int, int, int, int, int, double, double)
+     */
+    public void mapPagePointsToDevice(PdfDocument doc, int pageIndex, int startX, int startY, int sizeX,
+                                      int sizeY, int rotate, float[] points, float[] out) {
+        synchronized (doc.lock) {
+            long pagePtr = doc.mNativePagesPtr.get(pageIndex);
+            nativeMapPageCoordsToDevice(pagePtr, startX, startY, sizeX, sizeY, rotate, points, out, false);
+        }
+    }
+
+    /**
+     * Map many page rects to device coordinates with one transform, page must be opened
+     *
+     * @param rects left, top, right, bottom quads in page coordinates
+     * @param out   array of at least rects.length for device rects with left &lt;= right
+     *              and top &lt;= bottom, may be rects
+     * @see PdfiumCore#mapRectToDevice(PdfDocument, int, int, int, int, int, int, RectF)
+     */
+    public void mapPageRectsToDevice(PdfDocument doc, int pageIndex, int startX, int startY, int sizeX,
+                                     int sizeY, int rotate, float[] rects, float[] out) {
+        synchronized (doc.lock) {
+            long pagePtr = doc.mNativePagesPtr.get(pageIndex);
+            nativeMapPageCoordsToDevice(pagePtr, startX, startY, sizeX, sizeY, rotate, rects, out, true);
+        }
+    }
+
+    /**
+     * Map many device points back to page coordinates, page must be opened
+     *
+     * @param points x, y pairs in device coordinates
+     * @param out    array of at least points.length for page coordinates, may be points
+     */
+    public void mapDevicePointsToPage(PdfDocument doc, int pageIndex, int startX, int startY, int sizeX,
+                                      int sizeY, int rotate, float[] points, float[] out) {
+        synchronized (doc.lock) {
+            long pagePtr = doc.mNativePagesPtr.get(pageIndex);
+            nativeMapDeviceCoordsToPage(pagePtr, startX, startY, sizeX, sizeY, rotate, points, out, false);
+        }
+    }
+
+    /**
+     * Map many device rects back to page coordinates, page must be opened
+     *
+     * @param rects left, top, right, bottom quads in device coordinates
+     * @param out   array of at least rects.length for page rects with left &lt;= right
+     *              and top &lt;= bottom, may be rects
+     */
+    public void mapDeviceRectsToPage(PdfDocument doc, int pageIndex, int startX, int startY, int sizeX,
+                                     int sizeY, int rotate, float[] rects, float[] out) {
+        synchronized (doc.lock) {
+            long pagePtr = doc.mNativePagesPtr.get(pageIndex);
+            nativeMapDeviceCoordsToPage(pagePtr, startX, startY, sizeX, sizeY, rotate, rects, out, true);
+        }
+    }
 }
@@ -0,0 +1,16 @@
+package com.shockwave.pdfium;
+
+/**
+ * Receives completion of renders submitted by
+ * {@link PdfiumCore#submitRender(PdfDocument, android.graphics.Bitmap, int, int, int, int, int, boolean, int)}.
+ * Called on native worker thread, or on thread which cancelled the request, so it should
+ * only hand result over to other thread and return.
+ */
+public interface RenderCallback {
+    /**
+     * @param requestId id returned when render was submitted
+     * @param status    {@link RenderJob#STATUS_DONE}, {@link RenderJob#STATUS_FAILED}
+     *                  or {@link RenderJob#STATUS_CANCELLED}
+     */
+    void onRenderComplete(long requestId, int status);
+}
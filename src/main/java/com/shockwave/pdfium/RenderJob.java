@@ -0,0 +1,37 @@
+package com.shockwave.pdfium;
+
+/**
+ * Handle of progressive page render started by
+ * {@link PdfiumCore#startRenderJob(PdfDocument, android.graphics.Bitmap, int, int, int, int, int, boolean, int)}.
+ */
+public class RenderJob {
+    /** Rendering is not finished, call {@link PdfiumCore#continueRenderJob(RenderJob)} again */
+    public static final int STATUS_TO_BE_CONTINUED = 1;
+    /** Whole page fragment is rendered */
+    public static final int STATUS_DONE = 2;
+    /** Rendering failed */
+    public static final int STATUS_FAILED = 3;
+    /** Job was cancelled before it finished */
+    public static final int STATUS_CANCELLED = 4;
+
+    /*package*/ long mNativePtr;
+    /*package*/ int pageIndex;
+    /*package*/ int status = STATUS_TO_BE_CONTINUED;
+    /* lock of document the job renders */
+    /*package*/ Object lock;
+
+    /*package*/ RenderJob() {
+    }
+
+    public int getPageIndex() {
+        return pageIndex;
+    }
+
+    public int getStatus() {
+        return status;
+    }
+
+    public boolean isFinished() {
+        return status != STATUS_TO_BE_CONTINUED;
+    }
+}
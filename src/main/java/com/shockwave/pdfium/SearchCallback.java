@@ -0,0 +1,19 @@
+package com.shockwave.pdfium;
+
+/**
+ * Receives hits found by
+ * {@link PdfiumCore#searchText(PdfDocument, String, int, int, boolean, boolean, SearchCallback)},
+ * in page order, on the thread which called it.
+ */
+public interface SearchCallback {
+    /**
+     * Called after every searched window of pages, also when it has no hits.
+     *
+     * @param lastPageIndex last page searched so far
+     * @param hits          page index, char index, char count and rect count of every hit
+     * @param rects         left, top, right and bottom in page coordinates of every rect,
+     *                      rects of hits follow each other in order of hits
+     * @return true to continue search, false to cancel it
+     */
+    boolean onSearchResults(int lastPageIndex, int[] hits, float[] rects);
+}
@@ -0,0 +1,12 @@
+package com.shockwave.pdfium;
+
+/**
+ * Memory mapped full-text index of document, opened by
+ * {@link PdfiumCore#openTextIndex(PdfDocument, String)}.
+ */
+public class TextIndex {
+    /*package*/ long mNativePtr;
+
+    /*package*/ TextIndex() {
+    }
+}
@@ -0,0 +1,32 @@
+package com.shockwave.pdfium;
+
+import android.graphics.Bitmap;
+
+import com.shockwave.pdfium.util.Size;
+
+/**
+ * Memory mapped file with thumbnails of all pages of document, opened by
+ * {@link PdfiumCore#openThumbnailStore(PdfDocument, String)}.
+ */
+public class ThumbnailStore {
+    /*package*/ long mNativePtr;
+    /*package*/ int[] sizes;
+    /*package*/ Bitmap.Config config;
+
+    /*package*/ ThumbnailStore() {
+    }
+
+    public int getPageCount() {
+        return sizes.length / 2;
+    }
+
+    /** Bitmap configuration thumbnails were stored in */
+    public Bitmap.Config getConfig() {
+        return config;
+    }
+
+    /** Size of thumbnail in pixels, Size(0, 0) if page could not be rendered */
+    public Size getThumbnailSize(int pageIndex) {
+        return new Size(sizes[pageIndex * 2], sizes[pageIndex * 2 + 1]);
+    }
+}
@@ -0,0 +1,50 @@
+package com.shockwave.pdfium;
+
+/** Snapshot of counters of native tile cache */
+public class TileCacheStats {
+    long hits;
+    long misses;
+    long evictions;
+    long bytes;
+    long budget;
+    int entries;
+
+    /*package*/ TileCacheStats() {
+    }
+
+    public long getHits() {
+        return hits;
+    }
+
+    public long getMisses() {
+        return misses;
+    }
+
+    public long getEvictions() {
+        return evictions;
+    }
+
+    /** Bytes of pixels held by cache */
+    public long getBytes() {
+        return bytes;
+    }
+
+    public long getBudget() {
+        return budget;
+    }
+
+    public int getEntries() {
+        return entries;
+    }
+
+    public float getHitRate() {
+        long lookups = hits + misses;
+        return lookups == 0 ? 0 : (float) hits / lookups;
+    }
+
+    @Override
+    public String toString() {
+        return "hits=" + hits + " misses=" + misses + " evictions=" + evictions
+                + " bytes=" + bytes + "/" + budget + " entries=" + entries;
+    }
+}
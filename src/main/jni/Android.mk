@@ -41,8 +41,46 @@ LOCAL_MODULE := jniPdfium
 LOCAL_CFLAGS += -DHAVE_PTHREADS
 LOCAL_C_INCLUDES += $(LOCAL_PATH)/include
 LOCAL_SHARED_LIBRARIES += aospPdfium
+#Runtime dependencies of libmodpdfium.so, listed so ndk-build packages them with the library
+LOCAL_SHARED_LIBRARIES += libmodft2 libmodpng
+#libmodpdfium.so was linked against this libc++_shared.so, it is packaged instead of the NDK one
+LOCAL_SHARED_LIBRARIES += libmodc++_shared
 LOCAL_LDLIBS += -llog -landroid -ljnigraphics
 
-LOCAL_SRC_FILES :=  $(LOCAL_PATH)/src/mainJNILib.cpp
+LOCAL_SRC_FILES :=  $(LOCAL_PATH)/src/mainJNILib.cpp \
+                    $(LOCAL_PATH)/src/documentFile.cpp \
+                    $(LOCAL_PATH)/src/documentPool.cpp \
+                    $(LOCAL_PATH)/src/blockCache.cpp \
+                    $(LOCAL_PATH)/src/javaDataSource.cpp \
+                    $(LOCAL_PATH)/src/progressiveLoader.cpp \
+                    $(LOCAL_PATH)/src/pageBitmap.cpp \
+                    $(LOCAL_PATH)/src/bitmapUtil.cpp \
+                    $(LOCAL_PATH)/src/renderJob.cpp \
+                    $(LOCAL_PATH)/src/frameScheduler.cpp \
+                    $(LOCAL_PATH)/src/renderScheduler.cpp \
+                    $(LOCAL_PATH)/src/tileCache.cpp \
+                    $(LOCAL_PATH)/src/sidecar.cpp \
+                    $(LOCAL_PATH)/src/thumbnailStore.cpp \
+                    $(LOCAL_PATH)/src/pageGeometry.cpp \
+                    $(LOCAL_PATH)/src/coordinateMap.cpp \
+                    $(LOCAL_PATH)/src/thumbnailAtlas.cpp \
+                    $(LOCAL_PATH)/src/textExtractor.cpp \
+                    $(LOCAL_PATH)/src/textIndex.cpp \
+                    $(LOCAL_PATH)/src/textSearch.cpp
+
+#SIMD RGB_565 conversion, selected at runtime through cpufeatures
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+LOCAL_SRC_FILES += $(LOCAL_PATH)/src/bitmapUtilNeon.cpp.neon
+endif
+ifeq ($(TARGET_ARCH_ABI),arm64-v8a)
+LOCAL_SRC_FILES += $(LOCAL_PATH)/src/bitmapUtilNeon.cpp
+endif
+ifneq ($(filter x86 x86_64,$(TARGET_ARCH_ABI)),)
+#Kernels enable SSSE3 per function, flag for whole module would let it leak into other code
+LOCAL_SRC_FILES += $(LOCAL_PATH)/src/bitmapUtilSse.cpp
+endif
+LOCAL_STATIC_LIBRARIES += cpufeatures
 
 include $(BUILD_SHARED_LIBRARY)
+
+$(call import-module,android/cpufeatures)
@@ -1,4 +1,6 @@
-APP_STL := c++_shared
+#Static, so NDK libc++_shared.so does not replace the prebuilt one PDFium was linked against.
+#Only C API crosses between libjniPdfium.so and PDFium, so the two runtimes never share objects
+APP_STL := c++_static
 APP_CPPFLAGS += -fexceptions
 
 #For ANativeWindow support
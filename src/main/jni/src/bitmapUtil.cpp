@@ -0,0 +1,80 @@
+#include "util.hpp"
+#include "bitmapUtil.hpp"
+
+#include <cpu-features.h>
+
+const uint8_t bayer4x4[4][4] = {
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 }
+};
+
+void rowTo565Scalar(const uint8_t *src, uint16_t *dst, int width) {
+    rgb *srcLine = (rgb*) src;
+    for (int x = 0; x < width; x++) {
+        dst[x] = rgbTo565(&srcLine[x]);
+    }
+}
+
+void rowTo565DitherScalar(const uint8_t *src, uint16_t *dst, int width, int x, int y) {
+    rgb *srcLine = (rgb*) src;
+    for (int i = 0; i < width; i++) {
+        dst[i] = rgbTo565Dither(&srcLine[i], x + i, y);
+    }
+}
+
+struct RowKernels {
+    RowTo565 convert;
+    RowTo565Dither convertDither;
+};
+
+static RowKernels selectRowKernels() {
+    RowKernels kernels = { &rowTo565Scalar, &rowTo565DitherScalar };
+    AndroidCpuFamily family = android_getCpuFamily();
+    uint64_t features = android_getCpuFeatures();
+    (void) features;
+
+#if defined(HAVE_ROW_TO_565_NEON)
+    if (family == ANDROID_CPU_FAMILY_ARM64
+            || (family == ANDROID_CPU_FAMILY_ARM && (features & ANDROID_CPU_ARM_FEATURE_NEON))) {
+        LOGD("Using NEON RGB_565 conversion");
+        kernels.convert = &rowTo565Neon;
+        kernels.convertDither = &rowTo565DitherNeon;
+    }
+#elif defined(HAVE_ROW_TO_565_SSSE3)
+    if ((family == ANDROID_CPU_FAMILY_X86 || family == ANDROID_CPU_FAMILY_X86_64)
+            && (features & ANDROID_CPU_X86_FEATURE_SSSE3)) {
+        LOGD("Using SSSE3 RGB_565 conversion");
+        kernels.convert = &rowTo565Ssse3;
+        kernels.convertDither = &rowTo565DitherSsse3;
+    }
+#endif
+    (void) family;
+    return kernels;
+}
+
+static const RowKernels& rowKernels() {
+    static const RowKernels kernels = selectRowKernels();
+    return kernels;
+}
+
+void rgbBitmapTo565(void *source, int sourceStride, void *dest, int destStride,
+                    int width, int height) {
+    RowTo565 convert = rowKernels().convert;
+    for (int y = 0; y < height; y++) {
+        convert((const uint8_t*) source, (uint16_t*) dest, width);
+        source = (char*) source + sourceStride;
+        dest = (char*) dest + destStride;
+    }
+}
+
+void rgbBitmapTo565Dither(void *source, int sourceStride, void *dest, int destStride,
+                          int width, int height, int originX, int originY) {
+    RowTo565Dither convert = rowKernels().convertDither;
+    for (int y = 0; y < height; y++) {
+        convert((const uint8_t*) source, (uint16_t*) dest, width, originX, originY + y);
+        source = (char*) source + sourceStride;
+        dest = (char*) dest + destStride;
+    }
+}
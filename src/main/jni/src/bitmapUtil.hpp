@@ -0,0 +1,66 @@
+#ifndef _BITMAP_UTIL_HPP_
+#define _BITMAP_UTIL_HPP_
+
+#include <stdint.h>
+
+struct rgb {
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+};
+
+inline uint16_t rgbTo565(rgb *color) {
+    return ((color->red >> 3) << 11) | ((color->green >> 2) << 5) | (color->blue >> 3);
+}
+
+/** 4x4 Bayer matrix, values 0-15 */
+extern const uint8_t bayer4x4[4][4];
+
+inline uint8_t saturatedAdd(uint8_t value, uint8_t add) {
+    int sum = value + add;
+    return sum > 255 ? 255 : (uint8_t) sum;
+}
+
+/** Ordered dither of one pixel placed at (x, y) in destination bitmap */
+inline uint16_t rgbTo565Dither(rgb *color, int x, int y) {
+    uint8_t threshold = bayer4x4[y & 3][x & 3];
+    rgb dithered;
+    dithered.red = saturatedAdd(color->red, threshold >> 1);
+    dithered.green = saturatedAdd(color->green, threshold >> 2);
+    dithered.blue = saturatedAdd(color->blue, threshold >> 1);
+    return rgbTo565(&dithered);
+}
+
+void rgbBitmapTo565(void *source, int sourceStride, void *dest, int destStride,
+                    int width, int height);
+
+/**
+ * Same as rgbBitmapTo565 with 4x4 ordered dithering, originX and originY
+ * are position of dest in whole bitmap so pattern stays aligned across tiles.
+ */
+void rgbBitmapTo565Dither(void *source, int sourceStride, void *dest, int destStride,
+                          int width, int height, int originX, int originY);
+
+/*
+ * Row kernels, selected at runtime by CPU features. SIMD kernels convert
+ * whole blocks of 16 pixels and leave remaining pixels to the scalar kernels.
+ */
+typedef void (*RowTo565)(const uint8_t *src, uint16_t *dst, int width);
+typedef void (*RowTo565Dither)(const uint8_t *src, uint16_t *dst, int width, int x, int y);
+
+void rowTo565Scalar(const uint8_t *src, uint16_t *dst, int width);
+void rowTo565DitherScalar(const uint8_t *src, uint16_t *dst, int width, int x, int y);
+
+#if defined(__arm__) || defined(__aarch64__)
+#define HAVE_ROW_TO_565_NEON
+void rowTo565Neon(const uint8_t *src, uint16_t *dst, int width);
+void rowTo565DitherNeon(const uint8_t *src, uint16_t *dst, int width, int x, int y);
+#endif
+
+#if defined(__i386__) || defined(__x86_64__)
+#define HAVE_ROW_TO_565_SSSE3
+void rowTo565Ssse3(const uint8_t *src, uint16_t *dst, int width);
+void rowTo565DitherSsse3(const uint8_t *src, uint16_t *dst, int width, int x, int y);
+#endif
+
+#endif
@@ -0,0 +1,44 @@
+#include "bitmapUtil.hpp"
+
+#include <arm_neon.h>
+
+static inline uint16x8_t pack565(uint8x8_t r, uint8x8_t g, uint8x8_t b) {
+    uint16x8_t result = vshll_n_u8(r, 8);
+    result = vsriq_n_u16(result, vshll_n_u8(g, 8), 5);
+    return vsriq_n_u16(result, vshll_n_u8(b, 8), 11);
+}
+
+static inline void store565(uint16_t *dst, uint8x16_t r, uint8x16_t g, uint8x16_t b) {
+    vst1q_u16(dst, pack565(vget_low_u8(r), vget_low_u8(g), vget_low_u8(b)));
+    vst1q_u16(dst + 8, pack565(vget_high_u8(r), vget_high_u8(g), vget_high_u8(b)));
+}
+
+void rowTo565Neon(const uint8_t *src, uint16_t *dst, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x3_t pixels = vld3q_u8(src + x * 3);
+        store565(dst + x, pixels.val[0], pixels.val[1], pixels.val[2]);
+    }
+    rowTo565Scalar(src + x * 3, dst + x, width - x);
+}
+
+void rowTo565DitherNeon(const uint8_t *src, uint16_t *dst, int width, int x0, int y) {
+    uint8_t thresholdRB[16], thresholdG[16];
+    for (int i = 0; i < 16; i++) {
+        uint8_t threshold = bayer4x4[y & 3][(x0 + i) & 3];
+        thresholdRB[i] = threshold >> 1;
+        thresholdG[i] = threshold >> 2;
+    }
+    uint8x16_t addRB = vld1q_u8(thresholdRB);
+    uint8x16_t addG = vld1q_u8(thresholdG);
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x3_t pixels = vld3q_u8(src + x * 3);
+        store565(dst + x,
+                 vqaddq_u8(pixels.val[0], addRB),
+                 vqaddq_u8(pixels.val[1], addG),
+                 vqaddq_u8(pixels.val[2], addRB));
+    }
+    rowTo565DitherScalar(src + x * 3, dst + x, width - x, x0 + x, y);
+}
@@ -0,0 +1,83 @@
+#include "bitmapUtil.hpp"
+
+#include <tmmintrin.h>
+
+/*
+ * Only functions of this file may use SSSE3, it is not enabled for the whole module,
+ * so the compiler cannot emit it in code which runs before cpufeatures dispatch.
+ */
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+
+/* Gathers one channel of 16 packed 3-byte pixels */
+SSSE3_TARGET static inline __m128i gatherChannel(__m128i a, __m128i b, __m128i c,
+                                    __m128i maskA, __m128i maskB, __m128i maskC) {
+    return _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, maskA), _mm_shuffle_epi8(b, maskB)),
+                        _mm_shuffle_epi8(c, maskC));
+}
+
+SSSE3_TARGET static inline __m128i pack565(__m128i r, __m128i g, __m128i b) {
+    r = _mm_slli_epi16(_mm_and_si128(r, _mm_set1_epi16(0xF8)), 8);
+    g = _mm_slli_epi16(_mm_and_si128(g, _mm_set1_epi16(0xFC)), 3);
+    b = _mm_srli_epi16(b, 3);
+    return _mm_or_si128(_mm_or_si128(r, g), b);
+}
+
+template <bool dither>
+SSSE3_TARGET static inline int convertBlocks(const uint8_t *src, uint16_t *dst, int width,
+                                __m128i addRB, __m128i addG) {
+    const __m128i maskR0 = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 15, 12, 9, 6, 3, 0);
+    const __m128i maskR1 = _mm_set_epi8(-1, -1, -1, -1, -1, 14, 11, 8, 5, 2, -1, -1, -1, -1, -1, -1);
+    const __m128i maskR2 = _mm_set_epi8(13, 10, 7, 4, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i maskG0 = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 13, 10, 7, 4, 1);
+    const __m128i maskG1 = _mm_set_epi8(-1, -1, -1, -1, -1, 15, 12, 9, 6, 3, 0, -1, -1, -1, -1, -1);
+    const __m128i maskG2 = _mm_set_epi8(14, 11, 8, 5, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i maskB0 = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 14, 11, 8, 5, 2);
+    const __m128i maskB1 = _mm_set_epi8(-1, -1, -1, -1, -1, -1, 13, 10, 7, 4, 1, -1, -1, -1, -1, -1);
+    const __m128i maskB2 = _mm_set_epi8(15, 12, 9, 6, 3, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i zero = _mm_setzero_si128();
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m128i *in = (const __m128i*) (src + x * 3);
+        __m128i a = _mm_loadu_si128(in);
+        __m128i b = _mm_loadu_si128(in + 1);
+        __m128i c = _mm_loadu_si128(in + 2);
+
+        __m128i r = gatherChannel(a, b, c, maskR0, maskR1, maskR2);
+        __m128i g = gatherChannel(a, b, c, maskG0, maskG1, maskG2);
+        __m128i bl = gatherChannel(a, b, c, maskB0, maskB1, maskB2);
+        if (dither) {
+            r = _mm_adds_epu8(r, addRB);
+            g = _mm_adds_epu8(g, addG);
+            bl = _mm_adds_epu8(bl, addRB);
+        }
+
+        __m128i *out = (__m128i*) (dst + x);
+        _mm_storeu_si128(out, pack565(_mm_unpacklo_epi8(r, zero),
+                                      _mm_unpacklo_epi8(g, zero),
+                                      _mm_unpacklo_epi8(bl, zero)));
+        _mm_storeu_si128(out + 1, pack565(_mm_unpackhi_epi8(r, zero),
+                                          _mm_unpackhi_epi8(g, zero),
+                                          _mm_unpackhi_epi8(bl, zero)));
+    }
+    return x;
+}
+
+SSSE3_TARGET void rowTo565Ssse3(const uint8_t *src, uint16_t *dst, int width) {
+    int x = convertBlocks<false>(src, dst, width, _mm_setzero_si128(), _mm_setzero_si128());
+    rowTo565Scalar(src + x * 3, dst + x, width - x);
+}
+
+SSSE3_TARGET void rowTo565DitherSsse3(const uint8_t *src, uint16_t *dst, int width, int x0, int y) {
+    uint8_t thresholdRB[16], thresholdG[16];
+    for (int i = 0; i < 16; i++) {
+        uint8_t threshold = bayer4x4[y & 3][(x0 + i) & 3];
+        thresholdRB[i] = threshold >> 1;
+        thresholdG[i] = threshold >> 2;
+    }
+    __m128i addRB = _mm_loadu_si128((const __m128i*) thresholdRB);
+    __m128i addG = _mm_loadu_si128((const __m128i*) thresholdG);
+
+    int x = convertBlocks<true>(src, dst, width, addRB, addG);
+    rowTo565DitherScalar(src + x * 3, dst + x, width - x, x0 + x, y);
+}
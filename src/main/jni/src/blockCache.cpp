@@ -0,0 +1,143 @@
+#include "util.hpp"
+#include "blockCache.hpp"
+
+extern "C" {
+    #include <unistd.h>
+    #include <errno.h>
+    #include <string.h>
+}
+
+using namespace android;
+
+long FdDataSource::read(uint64_t position, uint8_t *buffer, size_t size) {
+    while (true) {
+        ssize_t count = pread(fd, buffer, size, position);
+        if (count < 0 && errno == EINTR) continue;
+        if (count < 0) {
+            LOGE("Cannot read from file descriptor. Error:%d", errno);
+        }
+        return count;
+    }
+}
+
+BlockCache::BlockCache(DataSource *source, uint64_t fileSize, const Config &config)
+    : source(source), fileSize(fileSize), config(config) {
+    if (this->config.blockSize == 0) this->config.blockSize = DEFAULT_BLOCK_SIZE;
+    if (this->config.maxBlocks <= 0) this->config.maxBlocks = DEFAULT_MAX_BLOCKS;
+    if (this->config.readAheadBlocks < 0) this->config.readAheadBlocks = 0;
+    //Read ahead must not evict the block it was read for
+    if (this->config.readAheadBlocks >= this->config.maxBlocks) {
+        this->config.readAheadBlocks = this->config.maxBlocks - 1;
+    }
+    memset(&stats, 0, sizeof(stats));
+}
+
+BlockCache::~BlockCache() {
+    delete source;
+}
+
+int BlockCache::getBlock(void* param, unsigned long position, unsigned char* outBuffer,
+                         unsigned long size) {
+    BlockCache *cache = reinterpret_cast<BlockCache*>(param);
+    return cache->read(position, outBuffer, size) ? 1 : 0;
+}
+
+bool BlockCache::read(uint64_t position, uint8_t *out, size_t size) {
+    if (position > fileSize || size > fileSize - position) return false;
+
+    Mutex::Autolock guard(lock);
+    stats.requests++;
+
+    while (size > 0) {
+        uint64_t blockIndex = position / config.blockSize;
+        size_t offset = (size_t)(position % config.blockSize);
+
+        const Block *block = fetchBlock(blockIndex);
+        if (block == NULL || offset >= block->data.size()) return false;
+
+        size_t count = block->data.size() - offset;
+        if (count > size) count = size;
+        memcpy(out, &block->data[offset], count);
+
+        out += count;
+        position += count;
+        size -= count;
+    }
+    return true;
+}
+
+const BlockCache::Block* BlockCache::fetchBlock(uint64_t blockIndex) {
+    auto found = index.find(blockIndex);
+    if (found != index.end()) {
+        stats.blockHits++;
+        blocks.splice(blocks.begin(), blocks, found->second);
+        return &*found->second;
+    }
+    stats.blockMisses++;
+
+    //Consecutive misses mean sequential scan, read following blocks in the same call
+    int blockCount = 1;
+    if (lastMissIndex != UINT64_MAX && blockIndex == lastMissIndex + 1) {
+        blockCount += config.readAheadBlocks;
+    }
+    uint64_t lastBlock = (fileSize - 1) / config.blockSize;
+    while (blockCount > 1 && (blockIndex + blockCount - 1 > lastBlock
+                              || index.count(blockIndex + blockCount - 1))) {
+        blockCount--;
+    }
+
+    uint64_t start = blockIndex * config.blockSize;
+    uint64_t end = start + (uint64_t)blockCount * config.blockSize;
+    if (end > fileSize) end = fileSize;
+    size_t length = (size_t)(end - start);
+
+    readBuffer.resize(length);
+    size_t filled = 0;
+    while (filled < length) {
+        long count = source->read(start + filled, &readBuffer[filled], length - filled);
+        stats.readCalls++;
+        if (count <= 0) break;
+        filled += count;
+        stats.bytesRead += count;
+    }
+    if (filled == 0) return NULL;
+
+    lastMissIndex = blockIndex + blockCount - 1;
+
+    //Insert read-ahead blocks first, so requested block ends up most recently used
+    for (int i = blockCount - 1; i >= 0; i--) {
+        size_t blockStart = (size_t)i * config.blockSize;
+        if (blockStart >= filled) continue;
+        size_t blockLength = filled - blockStart;
+        if (blockLength > config.blockSize) blockLength = config.blockSize;
+        insertBlock(blockIndex + i, &readBuffer[blockStart], blockLength);
+        if (i > 0) stats.readAheadBlocks++;
+    }
+
+    found = index.find(blockIndex);
+    return found != index.end() ? &*found->second : NULL;
+}
+
+void BlockCache::insertBlock(uint64_t blockIndex, const uint8_t *data, size_t size) {
+    auto found = index.find(blockIndex);
+    if (found != index.end()) {
+        blocks.erase(found->second);
+        index.erase(found);
+    }
+
+    blocks.push_front(Block());
+    Block &block = blocks.front();
+    block.index = blockIndex;
+    block.data.assign(data, data + size);
+    index[blockIndex] = blocks.begin();
+
+    while ((int)blocks.size() > config.maxBlocks) {
+        index.erase(blocks.back().index);
+        blocks.pop_back();
+    }
+}
+
+BlockCache::Stats BlockCache::getStats() {
+    Mutex::Autolock guard(lock);
+    return stats;
+}
@@ -0,0 +1,89 @@
+#ifndef _BLOCK_CACHE_HPP_
+#define _BLOCK_CACHE_HPP_
+
+#include <utils/Mutex.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/** Random access source of document bytes */
+class DataSource {
+    public:
+    virtual ~DataSource() {}
+    /** Read up to size bytes at position, returns count read, 0 at end, negative on error */
+    virtual long read(uint64_t position, uint8_t *buffer, size_t size) = 0;
+};
+
+class FdDataSource : public DataSource {
+    public:
+    FdDataSource(int fd) : fd(fd) {}
+    virtual long read(uint64_t position, uint8_t *buffer, size_t size);
+
+    private:
+    int fd;
+};
+
+/**
+ * Cache of fixed size, aligned blocks of DataSource for FPDF_FILEACCESS.
+ * Keeps LRU of recently read blocks and when misses hit consecutive blocks,
+ * reads following blocks ahead in the same call. Safe to share between
+ * document instances on different threads.
+ */
+class BlockCache {
+    public:
+    struct Config {
+        size_t blockSize;
+        int maxBlocks;
+        int readAheadBlocks;
+    };
+
+    struct Stats {
+        uint64_t requests;
+        uint64_t blockHits;
+        uint64_t blockMisses;
+        uint64_t readCalls;
+        uint64_t bytesRead;
+        uint64_t readAheadBlocks;
+    };
+
+    static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+    static const int DEFAULT_MAX_BLOCKS = 64;
+    static const int DEFAULT_READ_AHEAD_BLOCKS = 4;
+
+    /** Cache takes ownership of source */
+    BlockCache(DataSource *source, uint64_t fileSize, const Config &config);
+    ~BlockCache();
+
+    bool read(uint64_t position, uint8_t *out, size_t size);
+    Stats getStats();
+
+    /** m_GetBlock callback, param is BlockCache */
+    static int getBlock(void* param, unsigned long position, unsigned char* outBuffer,
+                        unsigned long size);
+
+    private:
+    struct Block {
+        uint64_t index;
+        std::vector<uint8_t> data;
+    };
+
+    typedef std::list<Block> BlockList;
+
+    const Block* fetchBlock(uint64_t index);
+    void insertBlock(uint64_t index, const uint8_t *data, size_t size);
+
+    DataSource *source;
+    uint64_t fileSize;
+    Config config;
+
+    android::Mutex lock;
+    BlockList blocks;
+    std::unordered_map<uint64_t, BlockList::iterator> index;
+    std::vector<uint8_t> readBuffer;
+    uint64_t lastMissIndex = UINT64_MAX;
+    Stats stats;
+};
+
+#endif
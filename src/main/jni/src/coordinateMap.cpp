@@ -0,0 +1,101 @@
+#include "util.hpp"
+#include "coordinateMap.hpp"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+bool PageTransform::fromViewport(FPDF_PAGE page, int startX, int startY, int sizeX, int sizeY,
+                                 int rotate, PageTransform *pageToDevice,
+                                 PageTransform *deviceToPage) {
+    if (page == NULL || sizeX == 0 || sizeY == 0) return false;
+
+    //Device to page mapping reports doubles, so three probes give exact transform
+    double x0, y0, x1, y1, x2, y2;
+    FPDF_DeviceToPage(page, startX, startY, sizeX, sizeY, rotate, startX, startY, &x0, &y0);
+    FPDF_DeviceToPage(page, startX, startY, sizeX, sizeY, rotate, startX + sizeX, startY, &x1, &y1);
+    FPDF_DeviceToPage(page, startX, startY, sizeX, sizeY, rotate, startX, startY + sizeY, &x2, &y2);
+
+    double a = (x1 - x0) / sizeX;
+    double b = (y1 - y0) / sizeX;
+    double c = (x2 - x0) / sizeY;
+    double d = (y2 - y0) / sizeY;
+    double e = x0 - a * startX - c * startY;
+    double f = y0 - b * startX - d * startY;
+
+    double det = a * d - b * c;
+    if (det == 0) return false;
+
+    deviceToPage->a = (float) a;
+    deviceToPage->b = (float) b;
+    deviceToPage->c = (float) c;
+    deviceToPage->d = (float) d;
+    deviceToPage->e = (float) e;
+    deviceToPage->f = (float) f;
+
+    double ia = d / det;
+    double ib = -b / det;
+    double ic = -c / det;
+    double id = a / det;
+    pageToDevice->a = (float) ia;
+    pageToDevice->b = (float) ib;
+    pageToDevice->c = (float) ic;
+    pageToDevice->d = (float) id;
+    pageToDevice->e = (float)(-(ia * e + ic * f));
+    pageToDevice->f = (float)(-(ib * e + id * f));
+    return true;
+}
+
+void PageTransform::apply(const float *in, float *out, size_t pointCount) const {
+    size_t i = 0;
+
+#if defined(__aarch64__)
+    //Four points per iteration, de-interleaved into x and y lanes
+    float32x4_t va = vdupq_n_f32(a), vb = vdupq_n_f32(b), vc = vdupq_n_f32(c);
+    float32x4_t vd = vdupq_n_f32(d), ve = vdupq_n_f32(e), vf = vdupq_n_f32(f);
+    for (; i + 4 <= pointCount; i += 4) {
+        float32x4x2_t p = vld2q_f32(in + i * 2);
+        float32x4x2_t r;
+        r.val[0] = vfmaq_f32(vfmaq_f32(ve, va, p.val[0]), vc, p.val[1]);
+        r.val[1] = vfmaq_f32(vfmaq_f32(vf, vb, p.val[0]), vd, p.val[1]);
+        vst2q_f32(out + i * 2, r);
+    }
+#elif defined(__SSE2__)
+    //Two points per iteration, x and y of each point stay interleaved
+    __m128 vxx = _mm_setr_ps(a, b, a, b);
+    __m128 vyy = _mm_setr_ps(c, d, c, d);
+    __m128 vt = _mm_setr_ps(e, f, e, f);
+    for (; i + 2 <= pointCount; i += 2) {
+        __m128 p = _mm_loadu_ps(in + i * 2);
+        __m128 px = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 py = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, vxx), _mm_mul_ps(py, vyy)), vt);
+        _mm_storeu_ps(out + i * 2, r);
+    }
+#endif
+
+    for (; i < pointCount; i++) {
+        float x = in[i * 2];
+        float y = in[i * 2 + 1];
+        out[i * 2] = a * x + c * y + e;
+        out[i * 2 + 1] = b * x + d * y + f;
+    }
+}
+
+void normalizeRects(float *rects, size_t rectCount) {
+    for (size_t i = 0; i < rectCount; i++) {
+        float *rect = rects + i * 4;
+        if (rect[0] > rect[2]) {
+            float left = rect[2];
+            rect[2] = rect[0];
+            rect[0] = left;
+        }
+        if (rect[1] > rect[3]) {
+            float top = rect[3];
+            rect[3] = rect[1];
+            rect[1] = top;
+        }
+    }
+}
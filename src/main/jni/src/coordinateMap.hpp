@@ -0,0 +1,27 @@
+#ifndef _COORDINATE_MAP_HPP_
+#define _COORDINATE_MAP_HPP_
+
+#include <fpdfview.h>
+#include <stddef.h>
+
+/**
+ * Affine map x' = a*x + c*y + e, y' = b*x + d*y + f between page and device space
+ * of one page, viewport and rotation, so batches of points are mapped without
+ * calling PDFium for every point.
+ */
+struct PageTransform {
+    float a, b, c, d, e, f;
+
+    /** Both directions of FPDF_PageToDevice / FPDF_DeviceToPage for viewport */
+    static bool fromViewport(FPDF_PAGE page, int startX, int startY, int sizeX, int sizeY,
+                             int rotate, PageTransform *pageToDevice,
+                             PageTransform *deviceToPage);
+
+    /** Map x, y pairs, in and out may be the same array */
+    void apply(const float *in, float *out, size_t pointCount) const;
+};
+
+/** Swap edges of left, top, right, bottom rects mapped by rotating transform */
+void normalizeRects(float *rects, size_t rectCount);
+
+#endif
@@ -0,0 +1,200 @@
+#include "util.hpp"
+#include "documentFile.hpp"
+#include "progressiveLoader.hpp"
+#include "javaDataSource.hpp"
+
+extern "C" {
+    #include <unistd.h>
+    #include <sys/stat.h>
+    #include <sys/mman.h>
+    #include <string.h>
+    #include <errno.h>
+}
+
+#include <utils/Mutex.h>
+using namespace android;
+
+static Mutex sLibraryLock;
+
+static int sLibraryReferenceCount = 0;
+
+void initLibraryIfNeed(){
+    Mutex::Autolock lock(sLibraryLock);
+    if(sLibraryReferenceCount == 0){
+        LOGD("Init FPDF library");
+        FPDF_InitLibrary();
+    }
+    sLibraryReferenceCount++;
+}
+
+Mutex& getLibraryLock(){
+    return sLibraryLock;
+}
+
+void destroyLibraryIfNeed(){
+    Mutex::Autolock lock(sLibraryLock);
+    sLibraryReferenceCount--;
+    if(sLibraryReferenceCount == 0){
+        LOGD("Destroy FPDF library");
+        FPDF_DestroyLibrary();
+    }
+}
+
+long getFileSize(int fd){
+    struct stat file_state;
+
+    if(fstat(fd, &file_state) >= 0){
+        return (long)(file_state.st_size);
+    }else{
+        LOGE("Error getting file size");
+        return 0;
+    }
+}
+
+int getBlock(void* param, unsigned long position, unsigned char* outBuffer,
+        unsigned long size) {
+    const int fd = reinterpret_cast<intptr_t>(param);
+    const int readCount = pread(fd, outBuffer, size, position);
+    if (readCount < 0) {
+        LOGE("Cannot read from file descriptor. Error:%d", errno);
+        return 0;
+    }
+    return 1;
+}
+
+static int getBlockMapped(void* param, unsigned long position, unsigned char* outBuffer,
+        unsigned long size) {
+    const DocumentFile *doc = reinterpret_cast<const DocumentFile*>(param);
+    if (position > doc->fileSize || size > doc->fileSize - position) {
+        LOGE("Block out of mapped file: %lu+%lu", position, size);
+        return 0;
+    }
+    const uint8_t *data = doc->mappedData != NULL ? doc->mappedData : doc->memoryData;
+    memcpy(outBuffer, data + position, size);
+    return 1;
+}
+
+//Trailer and cross-reference table are read first, from the end of file
+static const size_t MMAP_TAIL_PREFETCH = 1024 * 1024;
+static const size_t MMAP_HEAD_PREFETCH = 64 * 1024;
+
+void DocumentFile::setFile(int fd, size_t size, FileAccessMode mode,
+                           const BlockCache::Config &cacheConfig){
+    fileFd = fd;
+    fileSize = size;
+
+    if(mode == ACCESS_BLOCK_CACHE){
+        blockCache = new BlockCache(new FdDataSource(fd), size, cacheConfig);
+        return;
+    }
+    if(mode != ACCESS_MMAP || size == 0) return;
+
+    //Note that truncating file while it is mapped raises SIGBUS on access
+    void *mapped = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    if(mapped == MAP_FAILED){
+        LOGD("Cannot map file, falling back to pread. Error:%d", errno);
+        return;
+    }
+    mappedData = (const uint8_t*) mapped;
+
+    long pageSize = sysconf(_SC_PAGESIZE);
+    size_t tail = size < MMAP_TAIL_PREFETCH ? size : MMAP_TAIL_PREFETCH;
+    size_t tailStart = (size - tail) & ~(size_t)(pageSize - 1);
+    madvise((void*)(mappedData + tailStart), size - tailStart, MADV_WILLNEED);
+    madvise(mapped, size < MMAP_HEAD_PREFETCH ? size : MMAP_HEAD_PREFETCH, MADV_WILLNEED);
+}
+
+void DocumentFile::setDataSource(DataSource *source, size_t size,
+                                 const BlockCache::Config &cacheConfig){
+    fileSize = size;
+    blockCache = new BlockCache(source, size, cacheConfig);
+}
+
+void DocumentFile::setOwnedMemory(uint8_t *data, size_t size){
+    memoryData = data;
+    fileSize = size;
+    ownsMemory = true;
+}
+
+bool DocumentFile::setDirectBuffer(JNIEnv *env, jobject buffer){
+    void *address = env->GetDirectBufferAddress(buffer);
+    jlong capacity = env->GetDirectBufferCapacity(buffer);
+    if(address == NULL || capacity <= 0) return false;
+    if(env->GetJavaVM(&javaVm) != JNI_OK) return false;
+
+    bufferRef = env->NewGlobalRef(buffer);
+    if(bufferRef == NULL) return false;
+    memoryData = (const uint8_t*) address;
+    fileSize = (size_t) capacity;
+    return true;
+}
+
+void DocumentFile::fillLoader(FPDF_FILEACCESS *loader) const{
+    loader->m_FileLen = fileSize;
+    if(blockCache != NULL){
+        loader->m_Param = blockCache;
+        loader->m_GetBlock = &BlockCache::getBlock;
+    }else if(mappedData != NULL || memoryData != NULL){
+        loader->m_Param = const_cast<DocumentFile*>(this);
+        loader->m_GetBlock = &getBlockMapped;
+    }else{
+        loader->m_Param = reinterpret_cast<void*>(intptr_t(fileFd));
+        loader->m_GetBlock = &getBlock;
+    }
+}
+
+DocumentFile::~DocumentFile(){
+    if(pdfDocument != NULL){
+        Mutex::Autolock lock(sLibraryLock);
+        FPDF_CloseDocument(pdfDocument);
+    }
+    if(mappedData != NULL){
+        munmap((void*) mappedData, fileSize);
+    }
+    delete blockCache;
+    //Availability provider is destroyed only after its document
+    delete progressive;
+    if(ownsMemory){
+        delete[] memoryData;
+    }
+    if(bufferRef != NULL){
+        //Buffer must stay reachable until PDFium has released the document
+        ScopedJniEnv scoped(javaVm);
+        if(scoped.get() != NULL){
+            scoped.get()->DeleteGlobalRef(bufferRef);
+        }
+    }
+    if(ownsFd){
+        close(fileFd);
+    }
+
+    destroyLibraryIfNeed();
+}
+
+bool DocumentFile::hasCompleteSource() const {
+    if(progressive != NULL && !progressive->isComplete()) return false;
+    return fileFd >= 0 || memoryData != NULL || blockCache != NULL;
+}
+
+bool DocumentFile::read(uint64_t position, uint8_t *outBuffer, size_t size) const {
+    if(position > fileSize || size > fileSize - position) return false;
+    if(fileFd < 0 && memoryData == NULL && blockCache == NULL) return false;
+
+    if(blockCache == NULL && mappedData == NULL && memoryData == NULL){
+        //Plain loader does not retry short reads
+        while(size > 0){
+            ssize_t count = pread(fileFd, outBuffer, size, position);
+            if(count < 0 && errno == EINTR) continue;
+            if(count <= 0) return false;
+            outBuffer += count;
+            size -= count;
+            position += count;
+        }
+        return true;
+    }
+
+    FPDF_FILEACCESS loader;
+    fillLoader(&loader);
+    return loader.m_GetBlock(loader.m_Param, (unsigned long) position, outBuffer,
+                             (unsigned long) size) != 0;
+}
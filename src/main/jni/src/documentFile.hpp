@@ -0,0 +1,77 @@
+#ifndef _DOCUMENT_FILE_HPP_
+#define _DOCUMENT_FILE_HPP_
+
+#include "blockCache.hpp"
+
+#include <jni.h>
+#include <fpdfview.h>
+#include <utils/Mutex.h>
+#include <stdint.h>
+#include <string>
+
+void initLibraryIfNeed();
+void destroyLibraryIfNeed();
+/**
+ * Serializes every call into PDFium, which is not thread-safe even across distinct
+ * documents. Lock is not recursive, it must not be held while calling code which takes
+ * it itself, like DocumentFile destructor.
+ */
+android::Mutex& getLibraryLock();
+
+long getFileSize(int fd);
+
+int getBlock(void* param, unsigned long position, unsigned char* outBuffer,
+        unsigned long size);
+
+/** How blocks requested by PDFium are read from file descriptor */
+enum FileAccessMode {
+    ACCESS_PREAD = 0,
+    //Serve blocks from read-only mapping of whole file, pread if file cannot be mapped
+    ACCESS_MMAP = 1,
+    //Serve blocks from BlockCache with read-ahead, for fds which cannot be mapped
+    ACCESS_BLOCK_CACHE = 2
+};
+
+class ProgressiveLoader;
+
+class DocumentFile {
+    public:
+    FPDF_DOCUMENT pdfDocument = NULL;
+    size_t fileSize;
+    int fileFd = -1;
+    //Pooled documents outlive descriptor of opener and keep their own duplicate
+    bool ownsFd = false;
+    bool hasPassword = false;
+    std::string password;
+    const uint8_t *mappedData = NULL;
+    BlockCache *blockCache = NULL;
+    //In-memory document, either owned copy or address of pinned direct ByteBuffer
+    const uint8_t *memoryData = NULL;
+    bool ownsMemory = false;
+    JavaVM *javaVm = NULL;
+    jobject bufferRef = NULL;
+    //Set for documents opened before their file is complete, pdfDocument is loaded later
+    ProgressiveLoader *progressive = NULL;
+
+    DocumentFile() { initLibraryIfNeed(); }
+    ~DocumentFile();
+
+    /** Attach file descriptor, must be called before loader is filled */
+    void setFile(int fd, size_t size, FileAccessMode mode,
+                 const BlockCache::Config &cacheConfig);
+    /** Attach arbitrary source of given size, read through BlockCache which owns it */
+    void setDataSource(DataSource *source, size_t size, const BlockCache::Config &cacheConfig);
+    /** Attach heap copy of document, released with delete[] together with document */
+    void setOwnedMemory(uint8_t *data, size_t size);
+    /** Attach direct ByteBuffer without copying, global reference is kept until destruction */
+    bool setDirectBuffer(JNIEnv *env, jobject buffer);
+    /** Fill loader reading from attached file */
+    void fillLoader(FPDF_FILEACCESS *loader) const;
+
+    /** True if whole source document can be read, e.g. to fingerprint it for sidecars */
+    bool hasCompleteSource() const;
+    /** Read bytes of source document, independent of access mode */
+    bool read(uint64_t position, uint8_t *outBuffer, size_t size) const;
+};
+
+#endif
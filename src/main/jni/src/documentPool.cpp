@@ -0,0 +1,217 @@
+#include "util.hpp"
+#include "documentPool.hpp"
+#include "tileCache.hpp"
+
+extern "C" {
+    #include <sys/stat.h>
+    #include <time.h>
+}
+
+using namespace android;
+
+static int64_t monotonicNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+bool DocumentPool::Key::operator==(const Key &other) const {
+    return device == other.device && inode == other.inode && size == other.size
+        && modifiedSec == other.modifiedSec && modifiedNsec == other.modifiedNsec
+        && hasPassword == other.hasPassword && password == other.password
+        && accessMode == other.accessMode && cacheBlockSize == other.cacheBlockSize
+        && cacheMaxBlocks == other.cacheMaxBlocks
+        && cacheReadAheadBlocks == other.cacheReadAheadBlocks;
+}
+
+size_t DocumentPool::KeyHash::operator()(const Key &key) const {
+    size_t hash = std::hash<uint64_t>()(key.inode);
+    hash = hash * 31 + std::hash<uint64_t>()(key.device);
+    hash = hash * 31 + std::hash<uint64_t>()(key.size);
+    hash = hash * 31 + std::hash<int64_t>()(key.modifiedNsec);
+    return hash;
+}
+
+DocumentPool& DocumentPool::instance() {
+    static DocumentPool pool;
+    return pool;
+}
+
+bool DocumentPool::makeKey(int fd, const char *password, FileAccessMode accessMode,
+                           const BlockCache::Config &cacheConfig, Key *key) {
+    struct stat fileState;
+    if (fstat(fd, &fileState) < 0 || !S_ISREG(fileState.st_mode)) return false;
+
+    key->device = (uint64_t) fileState.st_dev;
+    key->inode = (uint64_t) fileState.st_ino;
+    key->size = (uint64_t) fileState.st_size;
+    key->modifiedSec = (int64_t) fileState.st_mtim.tv_sec;
+    key->modifiedNsec = (int64_t) fileState.st_mtim.tv_nsec;
+    key->hasPassword = password != NULL;
+    key->password = password != NULL ? password : "";
+    key->accessMode = (int) accessMode;
+    key->cacheBlockSize = cacheConfig.blockSize;
+    key->cacheMaxBlocks = cacheConfig.maxBlocks;
+    key->cacheReadAheadBlocks = cacheConfig.readAheadBlocks;
+    return true;
+}
+
+void DocumentPool::setLimits(int maxDocuments, int64_t idleTimeoutMs) {
+    std::vector<DocumentFile*> expired;
+    {
+        Mutex::Autolock guard(lock);
+        this->maxDocuments = maxDocuments > 0 ? maxDocuments : 0;
+        idleTimeoutNs = idleTimeoutMs > 0 ? idleTimeoutMs * 1000000LL : 0;
+        collectIdle(monotonicNs(), false, 0, &expired);
+    }
+    destroy(expired);
+}
+
+bool DocumentPool::isEnabled() {
+    Mutex::Autolock guard(lock);
+    return maxDocuments > 0;
+}
+
+DocumentFile* DocumentPool::acquire(const Key &key) {
+    std::vector<DocumentFile*> expired;
+    DocumentFile *doc = NULL;
+    {
+        Mutex::Autolock guard(lock);
+        collectIdle(monotonicNs(), false, 0, &expired);
+        acquires++;
+
+        auto found = index.find(key);
+        if (found != index.end()) {
+            hits++;
+            found->second->references++;
+            doc = found->second->doc;
+        } else {
+            misses++;
+        }
+    }
+    destroy(expired);
+    return doc;
+}
+
+bool DocumentPool::add(const Key &key, DocumentFile *doc) {
+    std::vector<DocumentFile*> expired;
+    bool added = false;
+    {
+        Mutex::Autolock guard(lock);
+        if (maxDocuments > 0 && index.find(key) == index.end()) {
+            //Make room for new document, documents in use are never evicted
+            collectIdle(monotonicNs(), false, 1, &expired);
+            if ((int) entries.size() < maxDocuments) {
+                entries.push_back(Entry());
+                Entry &entry = entries.back();
+                entry.key = key;
+                entry.doc = doc;
+                entry.references = 1;
+                entry.idleSinceNs = 0;
+                EntryList::iterator it = --entries.end();
+                index[key] = it;
+                byDocument[doc] = it;
+                added = true;
+            }
+        }
+    }
+    destroy(expired);
+    return added;
+}
+
+bool DocumentPool::release(DocumentFile *doc) {
+    std::vector<DocumentFile*> expired;
+    {
+        Mutex::Autolock guard(lock);
+        auto found = byDocument.find(doc);
+        if (found == byDocument.end()) return false;
+
+        Entry &entry = *found->second;
+        if (--entry.references == 0) {
+            entry.idleSinceNs = monotonicNs();
+        }
+        collectIdle(monotonicNs(), false, 0, &expired);
+    }
+    destroy(expired);
+    return true;
+}
+
+void DocumentPool::trim() {
+    std::vector<DocumentFile*> expired;
+    {
+        Mutex::Autolock guard(lock);
+        collectIdle(monotonicNs(), false, 0, &expired);
+    }
+    destroy(expired);
+}
+
+void DocumentPool::clear() {
+    std::vector<DocumentFile*> expired;
+    {
+        Mutex::Autolock guard(lock);
+        collectIdle(monotonicNs(), true, 0, &expired);
+    }
+    destroy(expired);
+}
+
+DocumentPool::Stats DocumentPool::getStats() {
+    Mutex::Autolock guard(lock);
+    Stats stats;
+    stats.acquires = acquires;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.evictions = evictions;
+    stats.documents = (int) entries.size();
+    stats.idleDocuments = 0;
+    for (EntryList::iterator it = entries.begin(); it != entries.end(); ++it) {
+        if (it->references == 0) stats.idleDocuments++;
+    }
+    return stats;
+}
+
+void DocumentPool::collectIdle(int64_t now, bool all, int reserve,
+                               std::vector<DocumentFile*> *expired) {
+    //Pool holds few documents, so idle ones are found by scanning
+    int excess = (int) entries.size() + reserve - maxDocuments;
+    EntryList::iterator it = entries.begin();
+    while (it != entries.end()) {
+        EntryList::iterator current = it++;
+        if (current->references > 0) continue;
+
+        bool timedOut = idleTimeoutNs > 0 && now - current->idleSinceNs >= idleTimeoutNs;
+        if (all || timedOut || maxDocuments == 0) {
+            expired->push_back(current->doc);
+            evictions++;
+            removeEntry(current);
+            excess--;
+        }
+    }
+
+    while (excess > 0) {
+        EntryList::iterator oldest = entries.end();
+        for (it = entries.begin(); it != entries.end(); ++it) {
+            if (it->references == 0
+                    && (oldest == entries.end() || it->idleSinceNs < oldest->idleSinceNs)) {
+                oldest = it;
+            }
+        }
+        if (oldest == entries.end()) break;
+        expired->push_back(oldest->doc);
+        evictions++;
+        removeEntry(oldest);
+        excess--;
+    }
+}
+
+void DocumentPool::removeEntry(EntryList::iterator it) {
+    index.erase(it->key);
+    byDocument.erase(it->doc);
+    entries.erase(it);
+}
+
+void DocumentPool::destroy(const std::vector<DocumentFile*> &docs) {
+    for (size_t i = 0; i < docs.size(); i++) {
+        TileCache::instance().removeDocument(docs[i]);
+        delete docs[i];
+    }
+}
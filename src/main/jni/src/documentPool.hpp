@@ -0,0 +1,102 @@
+#ifndef _DOCUMENT_POOL_HPP_
+#define _DOCUMENT_POOL_HPP_
+
+#include "documentFile.hpp"
+
+#include <utils/Mutex.h>
+#include <stdint.h>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Process wide pool of opened documents keyed by identity of their file, so the
+ * same file opened by several clients is parsed once. Handles are reference counted,
+ * documents without references stay pooled until idle timeout or until the cap on
+ * pooled documents needs their slot. Disabled while max documents is 0.
+ */
+class DocumentPool {
+    public:
+    struct Key {
+        uint64_t device;
+        uint64_t inode;
+        uint64_t size;
+        int64_t modifiedSec;
+        int64_t modifiedNsec;
+        //Document decrypted with one password must not be handed out for another
+        std::string password;
+        bool hasPassword;
+        //Instances share loader of pooled document, so they must agree on how it reads
+        int accessMode;
+        size_t cacheBlockSize;
+        int cacheMaxBlocks;
+        int cacheReadAheadBlocks;
+
+        bool operator==(const Key &other) const;
+    };
+
+    struct Stats {
+        uint64_t acquires;
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        int documents;
+        int idleDocuments;
+    };
+
+    static DocumentPool& instance();
+
+    /** Key of file open as fd with given access settings, false if it cannot be stat'ed */
+    static bool makeKey(int fd, const char *password, FileAccessMode accessMode,
+                        const BlockCache::Config &cacheConfig, Key *key);
+
+    void setLimits(int maxDocuments, int64_t idleTimeoutMs);
+    bool isEnabled();
+
+    /** Pooled document with new reference added, NULL on miss */
+    DocumentFile* acquire(const Key &key);
+    /** Pool newly opened document holding its first reference, false if it cannot be pooled */
+    bool add(const Key &key, DocumentFile *doc);
+    /** Drop reference of pooled document, false if document is not pooled */
+    bool release(DocumentFile *doc);
+
+    /** Destroy idle documents past timeout */
+    void trim();
+    /** Destroy all idle documents */
+    void clear();
+    Stats getStats();
+
+    private:
+    struct KeyHash {
+        size_t operator()(const Key &key) const;
+    };
+
+    struct Entry {
+        Key key;
+        DocumentFile *doc;
+        int references;
+        int64_t idleSinceNs;
+    };
+
+    typedef std::list<Entry> EntryList;
+
+    DocumentPool() {}
+    /** Remove timed out idle documents and oldest idle ones over cap less reserve */
+    void collectIdle(int64_t now, bool all, int reserve, std::vector<DocumentFile*> *expired);
+    void removeEntry(EntryList::iterator it);
+    static void destroy(const std::vector<DocumentFile*> &docs);
+
+    android::Mutex lock;
+    EntryList entries;
+    std::unordered_map<Key, EntryList::iterator, KeyHash> index;
+    std::unordered_map<const DocumentFile*, EntryList::iterator> byDocument;
+    int maxDocuments = 0;
+    int64_t idleTimeoutNs = 0;
+    uint64_t acquires = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "util.hpp"
+#include "frameScheduler.hpp"
+
+extern "C" {
+    #include <time.h>
+}
+
+//Shorter slices cost more in restarted PDFium steps than they render
+static const int64_t MIN_SLICE_NS = 1000000LL;
+
+static int64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+//Settles status of cancelled job, returns whether job still needs slices
+static bool keepPending(RenderJob *job) {
+    if(job == NULL) return false;
+    if(job->isCancelled()){
+        job->markCancelled();
+        return false;
+    }
+    return job->getStatus() <= FPDF_RENDER_TOBECOUNTINUED;
+}
+
+FrameScheduler::FrameScheduler() {
+    ring.reserve(TRACE_CAPACITY);
+}
+
+int FrameScheduler::renderFrame(RenderJob **jobs, int jobCount, int64_t deadlineNs) {
+    std::vector<RenderJob*> pending;
+    for(int i = 0; i < jobCount; i++){
+        if(keepPending(jobs[i])) pending.push_back(jobs[i]);
+    }
+    frames++;
+
+    int64_t now = monotonicNs();
+    while(!pending.empty() && now < deadlineNs){
+        //Whole remaining time is shared again after every round, finished jobs free their share
+        int64_t slice = (deadlineNs - now) / (int64_t)pending.size();
+        if(slice < MIN_SLICE_NS) slice = MIN_SLICE_NS;
+
+        size_t kept = 0;
+        for(size_t i = 0; i < pending.size(); i++){
+            RenderJob *job = pending[i];
+            if(now < deadlineNs){
+                int64_t left = deadlineNs - now;
+                job->setSliceBudget(slice < left ? slice : left);
+                job->resume();
+                now = monotonicNs();
+            }
+            if(keepPending(job)) pending[kept++] = job;
+        }
+        pending.resize(kept);
+    }
+
+    //PDFium checks for pause only between page objects, one object may outlast the frame
+    if(now > deadlineNs){
+        recordMiss(now - deadlineNs, (int)pending.size());
+    }
+    return (int)pending.size();
+}
+
+void FrameScheduler::recordMiss(int64_t overrunNs, int pendingJobs) {
+    misses++;
+    totalOverrunNs += overrunNs;
+    if(overrunNs > worstOverrunNs) worstOverrunNs = overrunNs;
+
+    Miss miss;
+    miss.frame = frames;
+    miss.overrunNs = overrunNs;
+    miss.pendingJobs = pendingJobs;
+    if((int)ring.size() < TRACE_CAPACITY){
+        ring.push_back(miss);
+    }else{
+        ring[ringStart] = miss;
+        ringStart = (ringStart + 1) % TRACE_CAPACITY;
+    }
+}
+
+FrameScheduler::Trace FrameScheduler::getTrace() const {
+    Trace trace;
+    trace.frames = frames;
+    trace.misses = misses;
+    trace.worstOverrunNs = worstOverrunNs;
+    trace.totalOverrunNs = totalOverrunNs;
+    for(size_t i = 0; i < ring.size(); i++){
+        trace.recent.push_back(ring[(ringStart + i) % ring.size()]);
+    }
+    return trace;
+}
+
+void FrameScheduler::resetTrace() {
+    frames = 0;
+    misses = 0;
+    worstOverrunNs = 0;
+    totalOverrunNs = 0;
+    ring.clear();
+    ringStart = 0;
+}
@@ -0,0 +1,58 @@
+#ifndef _FRAME_SCHEDULER_HPP_
+#define _FRAME_SCHEDULER_HPP_
+
+#include "renderJob.hpp"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Drives RenderJobs of visible tiles so every frame renders what fits before its deadline.
+ * Time left in frame is split into slices across unfinished jobs, jobs earlier in the list
+ * get their slice first. Jobs which do not finish keep their partial pixels and continue
+ * in the next frame. Frames which end after their deadline are traced.
+ */
+class FrameScheduler {
+    public:
+    /** Deadline misses kept in trace, oldest are dropped */
+    static const int TRACE_CAPACITY = 64;
+
+    struct Miss {
+        uint64_t frame;
+        int64_t overrunNs;
+        int pendingJobs;
+    };
+
+    struct Trace {
+        uint64_t frames;
+        uint64_t misses;
+        int64_t worstOverrunNs;
+        int64_t totalOverrunNs;
+        //Most recent misses, oldest first
+        std::vector<Miss> recent;
+    };
+
+    FrameScheduler();
+
+    /**
+     * Render slices of jobs until deadlineNs on CLOCK_MONOTONIC, the clock of
+     * System.nanoTime(). Unfinished jobs which were cancelled end as RENDER_JOB_CANCELLED.
+     * Returns number of jobs left unfinished.
+     */
+    int renderFrame(RenderJob **jobs, int jobCount, int64_t deadlineNs);
+
+    Trace getTrace() const;
+    void resetTrace();
+
+    private:
+    void recordMiss(int64_t overrunNs, int pendingJobs);
+
+    uint64_t frames = 0;
+    uint64_t misses = 0;
+    int64_t worstOverrunNs = 0;
+    int64_t totalOverrunNs = 0;
+    std::vector<Miss> ring;
+    int ringStart = 0;
+};
+
+#endif
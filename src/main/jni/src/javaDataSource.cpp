@@ -0,0 +1,84 @@
+#include "util.hpp"
+#include "javaDataSource.hpp"
+
+ScopedJniEnv::ScopedJniEnv(JavaVM *vm) : vm(vm) {
+    if (vm->GetEnv((void**) &env, JNI_VERSION_1_6) == JNI_OK) return;
+
+    //Render scheduler thread reads documents too
+    if (vm->AttachCurrentThread(&env, NULL) == JNI_OK) {
+        attached = true;
+    } else {
+        LOGE("Cannot attach thread to VM");
+        env = NULL;
+    }
+}
+
+ScopedJniEnv::~ScopedJniEnv() {
+    if (attached) {
+        vm->DetachCurrentThread();
+    }
+}
+
+JavaDataSource::JavaDataSource(JNIEnv *env, jobject source) {
+    if (env->GetJavaVM(&javaVm) != JNI_OK) return;
+
+    jclass cls = env->GetObjectClass(source);
+    readMethod = env->GetMethodID(cls, "read", "(J[BII)I");
+    env->DeleteLocalRef(cls);
+    if (readMethod == NULL) {
+        env->ExceptionClear();
+        LOGE("Data source has no read(long, byte[], int, int) method");
+        return;
+    }
+    sourceRef = env->NewGlobalRef(source);
+}
+
+JavaDataSource::~JavaDataSource() {
+    if (javaVm == NULL) return;
+
+    ScopedJniEnv scoped(javaVm);
+    JNIEnv *env = scoped.get();
+    if (env == NULL) return;
+    if (sourceRef != NULL) env->DeleteGlobalRef(sourceRef);
+    if (scratchRef != NULL) env->DeleteGlobalRef(scratchRef);
+}
+
+long JavaDataSource::read(uint64_t position, uint8_t *buffer, size_t size) {
+    ScopedJniEnv scoped(javaVm);
+    JNIEnv *env = scoped.get();
+    if (env == NULL) return -1;
+
+    if (scratchRef == NULL || scratchSize < (jsize) size) {
+        if (scratchRef != NULL) env->DeleteGlobalRef(scratchRef);
+        scratchRef = NULL;
+        scratchSize = 0;
+
+        jbyteArray scratch = env->NewByteArray((jsize) size);
+        if (scratch == NULL) {
+            env->ExceptionClear();
+            LOGE("Cannot allocate read buffer of %zu bytes", size);
+            return -1;
+        }
+        scratchRef = (jbyteArray) env->NewGlobalRef(scratch);
+        env->DeleteLocalRef(scratch);
+        scratchSize = (jsize) size;
+    }
+
+    size_t total = 0;
+    while (total < size) {
+        jint count = env->CallIntMethod(sourceRef, readMethod, (jlong)(position + total),
+                                        scratchRef, (jint) 0, (jint)(size - total));
+        if (env->ExceptionCheck()) {
+            //PDFium only sees failed block, exception must not leak into caller of render
+            env->ExceptionDescribe();
+            env->ExceptionClear();
+            return -1;
+        }
+        if (count <= 0) break;
+        if ((size_t) count > size - total) count = (jint)(size - total);
+
+        env->GetByteArrayRegion(scratchRef, 0, count, (jbyte*)(buffer + total));
+        total += count;
+    }
+    return (long) total;
+}
@@ -0,0 +1,44 @@
+#ifndef _JAVA_DATA_SOURCE_HPP_
+#define _JAVA_DATA_SOURCE_HPP_
+
+#include "blockCache.hpp"
+
+#include <jni.h>
+
+/** JNIEnv of current thread, attached for the scope if it was not attached yet */
+class ScopedJniEnv {
+    public:
+    ScopedJniEnv(JavaVM *vm);
+    ~ScopedJniEnv();
+
+    JNIEnv* get() const { return env; }
+
+    private:
+    JavaVM *vm;
+    JNIEnv *env = NULL;
+    bool attached = false;
+};
+
+/**
+ * DataSource calling back into com.shockwave.pdfium.PdfDataSource.
+ * Meant to be wrapped by BlockCache, which turns PDFium's small scattered
+ * reads into few block sized up-calls and serializes them.
+ */
+class JavaDataSource : public DataSource {
+    public:
+    JavaDataSource(JNIEnv *env, jobject source);
+    virtual ~JavaDataSource();
+
+    bool isValid() const { return sourceRef != NULL && readMethod != NULL; }
+    virtual long read(uint64_t position, uint8_t *buffer, size_t size);
+
+    private:
+    JavaVM *javaVm = NULL;
+    jobject sourceRef = NULL;
+    jmethodID readMethod = NULL;
+    //Reused transfer array, grown to largest read
+    jbyteArray scratchRef = NULL;
+    jsize scratchSize = 0;
+};
+
+#endif
@@ -1,7 +1,25 @@
 #include "util.hpp"
+#include "documentFile.hpp"
+#include "progressiveLoader.hpp"
+#include "javaDataSource.hpp"
+#include "documentPool.hpp"
+#include "pageBitmap.hpp"
+#include "renderScheduler.hpp"
+#include "renderJob.hpp"
+#include "frameScheduler.hpp"
+#include "tileCache.hpp"
+#include "sidecar.hpp"
+#include "thumbnailStore.hpp"
+#include "thumbnailAtlas.hpp"
+#include "pageGeometry.hpp"
+#include "textExtractor.hpp"
+#include "textIndex.hpp"
+#include "textSearch.hpp"
+#include "coordinateMap.hpp"
 
 extern "C" {
     #include <unistd.h>
+    #include <fcntl.h>
     #include <sys/mman.h>
     #include <sys/stat.h>
     #include <string.h>
@@ -18,53 +36,7 @@ using namespace android;
 #include <fpdf_doc.h>
 #include <string>
 #include <vector>
-
-static Mutex sLibraryLock;
-
-static int sLibraryReferenceCount = 0;
-
-static void initLibraryIfNeed(){
-    Mutex::Autolock lock(sLibraryLock);
-    if(sLibraryReferenceCount == 0){
-        LOGD("Init FPDF library");
-        FPDF_InitLibrary();
-    }
-    sLibraryReferenceCount++;
-}
-
-static void destroyLibraryIfNeed(){
-    Mutex::Autolock lock(sLibraryLock);
-    sLibraryReferenceCount--;
-    if(sLibraryReferenceCount == 0){
-        LOGD("Destroy FPDF library");
-        FPDF_DestroyLibrary();
-    }
-}
-
-struct rgb {
-    uint8_t red;
-    uint8_t green;
-    uint8_t blue;
-};
-
-class DocumentFile {
-    private:
-    int fileFd;
-
-    public:
-    FPDF_DOCUMENT pdfDocument = NULL;
-    size_t fileSize;
-
-    DocumentFile() { initLibraryIfNeed(); }
-    ~DocumentFile();
-};
-DocumentFile::~DocumentFile(){
-    if(pdfDocument != NULL){
-        FPDF_CloseDocument(pdfDocument);
-    }
-
-    destroyLibraryIfNeed();
-}
+#include <unordered_set>
 
 template <class string_type>
 inline typename string_type::value_type* WriteInto(string_type* str, size_t length_with_null) {
@@ -73,17 +45,6 @@ inline typename string_type::value_type* WriteInto(string_type* str, size_t leng
   return &((*str)[0]);
 }
 
-inline long getFileSize(int fd){
-    struct stat file_state;
-
-    if(fstat(fd, &file_state) >= 0){
-        return (long)(file_state.st_size);
-    }else{
-        LOGE("Error getting file size");
-        return 0;
-    }
-}
-
 static char* getErrorDescription(const long error) {
     char* description = NULL;
     switch(error) {
@@ -112,8 +73,91 @@ static char* getErrorDescription(const long error) {
     return description;
 }
 
+//Classes and methods used on hot paths, resolved once in JNI_OnLoad
+static struct {
+    jclass longClass;
+    jmethodID longInit;
+    jmethodID longValue;
+    jclass integerClass;
+    jmethodID integerInit;
+    jclass sizeClass;
+    jmethodID sizeInit;
+    jclass sizeFClass;
+    jmethodID sizeFInit;
+    jclass rectFClass;
+    jmethodID rectFInit;
+    jclass pointClass;
+    jmethodID pointInit;
+    jclass objectClass;
+    jclass stringClass;
+    jclass pageLinksClass;
+    jmethodID pageLinksInit;
+    jclass ioExceptionClass;
+    jclass illegalStateExceptionClass;
+    jclass passwordExceptionClass;
+} sJni;
+
+static jclass findClassGlobal(JNIEnv *env, const char *name) {
+    jclass local = env->FindClass(name);
+    if (local == NULL) {
+        LOGE("Unable to find class %s", name);
+        return NULL;
+    }
+    jclass global = (jclass) env->NewGlobalRef(local);
+    env->DeleteLocalRef(local);
+    return global;
+}
+
+static bool cacheClasses(JNIEnv *env) {
+    sJni.longClass = findClassGlobal(env, "java/lang/Long");
+    sJni.integerClass = findClassGlobal(env, "java/lang/Integer");
+    sJni.sizeClass = findClassGlobal(env, "com/shockwave/pdfium/util/Size");
+    sJni.sizeFClass = findClassGlobal(env, "com/shockwave/pdfium/util/SizeF");
+    sJni.rectFClass = findClassGlobal(env, "android/graphics/RectF");
+    sJni.pointClass = findClassGlobal(env, "android/graphics/Point");
+    sJni.objectClass = findClassGlobal(env, "java/lang/Object");
+    sJni.stringClass = findClassGlobal(env, "java/lang/String");
+    sJni.pageLinksClass = findClassGlobal(env, "com/shockwave/pdfium/PageLinks");
+    sJni.ioExceptionClass = findClassGlobal(env, "java/io/IOException");
+    sJni.illegalStateExceptionClass = findClassGlobal(env, "java/lang/IllegalStateException");
+    sJni.passwordExceptionClass = findClassGlobal(env, "com/shockwave/pdfium/PdfPasswordException");
+    if (sJni.longClass == NULL || sJni.integerClass == NULL || sJni.sizeClass == NULL
+            || sJni.sizeFClass == NULL || sJni.rectFClass == NULL || sJni.pointClass == NULL
+            || sJni.objectClass == NULL || sJni.stringClass == NULL || sJni.pageLinksClass == NULL
+            || sJni.ioExceptionClass == NULL || sJni.illegalStateExceptionClass == NULL
+            || sJni.passwordExceptionClass == NULL) {
+        return false;
+    }
+
+    sJni.longInit = env->GetMethodID(sJni.longClass, "<init>", "(J)V");
+    sJni.longValue = env->GetMethodID(sJni.longClass, "longValue", "()J");
+    sJni.integerInit = env->GetMethodID(sJni.integerClass, "<init>", "(I)V");
+    sJni.sizeInit = env->GetMethodID(sJni.sizeClass, "<init>", "(II)V");
+    sJni.sizeFInit = env->GetMethodID(sJni.sizeFClass, "<init>", "(FF)V");
+    sJni.rectFInit = env->GetMethodID(sJni.rectFClass, "<init>", "(FFFF)V");
+    sJni.pointInit = env->GetMethodID(sJni.pointClass, "<init>", "(II)V");
+    sJni.pageLinksInit = env->GetMethodID(sJni.pageLinksClass, "<init>",
+                                          "([F[I[Ljava/lang/String;[I[F)V");
+    return sJni.longInit != NULL && sJni.longValue != NULL && sJni.integerInit != NULL
+        && sJni.sizeInit != NULL && sJni.sizeFInit != NULL && sJni.rectFInit != NULL
+        && sJni.pointInit != NULL && sJni.pageLinksInit != NULL;
+}
+
+static jclass findExceptionClass(JNIEnv* env, const char* className) {
+    if (strcmp(className, "java/io/IOException") == 0) {
+        return sJni.ioExceptionClass;
+    }
+    if (strcmp(className, "java/lang/IllegalStateException") == 0) {
+        return sJni.illegalStateExceptionClass;
+    }
+    if (strcmp(className, "com/shockwave/pdfium/PdfPasswordException") == 0) {
+        return sJni.passwordExceptionClass;
+    }
+    return env->FindClass(className);
+}
+
 int jniThrowException(JNIEnv* env, const char* className, const char* message) {
-    jclass exClass = env->FindClass(className);
+    jclass exClass = findExceptionClass(env, className);
     if (exClass == NULL) {
         LOGE("Unable to find exception class %s", className);
         return -1;
@@ -137,50 +181,28 @@ int jniThrowExceptionFmt(JNIEnv* env, const char* className, const char* fmt, ..
 }
 
 jobject NewLong(JNIEnv* env, jlong value) {
-    jclass cls = env->FindClass("java/lang/Long");
-    jmethodID methodID = env->GetMethodID(cls, "<init>", "(J)V");
-    return env->NewObject(cls, methodID, value);
+    return env->NewObject(sJni.longClass, sJni.longInit, value);
 }
 
 jobject NewInteger(JNIEnv* env, jint value) {
-    jclass cls = env->FindClass("java/lang/Integer");
-    jmethodID methodID = env->GetMethodID(cls, "<init>", "(I)V");
-    return env->NewObject(cls, methodID, value);
-}
-
-uint16_t rgbTo565(rgb *color) {
-    return ((color->red >> 3) << 11) | ((color->green >> 2) << 5) | (color->blue >> 3);
+    return env->NewObject(sJni.integerClass, sJni.integerInit, value);
 }
 
-void rgbBitmapTo565(void *source, int sourceStride, void *dest, AndroidBitmapInfo *info) {
-    rgb *srcLine;
-    uint16_t *dstLine;
-    int y, x;
-    for (y = 0; y < info->height; y++) {
-        srcLine = (rgb*) source;
-        dstLine = (uint16_t*) dest;
-        for (x = 0; x < info->width; x++) {
-            dstLine[x] = rgbTo565(&srcLine[x]);
-        }
-        source = (char*) source + sourceStride;
-        dest = (char*) dest + info->stride;
+//Progressive documents have no FPDF_DOCUMENT until enough of their file is available
+static bool checkDocumentLoaded(JNIEnv *env, DocumentFile *doc) {
+    if(doc == NULL || doc->pdfDocument == NULL){
+        jniThrowException(env, "java/lang/IllegalStateException",
+                               "Document is not loaded yet");
+        return false;
     }
+    return true;
 }
 
 extern "C" { //For JNI support
 
-static int getBlock(void* param, unsigned long position, unsigned char* outBuffer,
-        unsigned long size) {
-    const int fd = reinterpret_cast<intptr_t>(param);
-    const int readCount = pread(fd, outBuffer, size, position);
-    if (readCount < 0) {
-        LOGE("Cannot read from file descriptor. Error:%d", errno);
-        return 0;
-    }
-    return 1;
-}
-
-JNI_FUNC(jlong, PdfiumCore, nativeOpenDocument)(JNI_ARGS, jint fd, jstring password){
+JNI_FUNC(jlong, PdfiumCore, nativeOpenDocument)(JNI_ARGS, jint fd, jstring password,
+                                                jint accessMode, jint cacheBlockSize,
+                                                jint cacheMaxBlocks, jint cacheReadAheadBlocks){
 
     size_t fileLength = (size_t)getFileSize(fd);
     if(fileLength <= 0) {
@@ -189,19 +211,109 @@ JNI_FUNC(jlong, PdfiumCore, nativeOpenDocument)(JNI_ARGS, jint fd, jstring passw
         return -1;
     }
 
+    const char *cpassword = NULL;
+    if(password != NULL) {
+        cpassword = env->GetStringUTFChars(password, NULL);
+    }
+
+    BlockCache::Config cacheConfig;
+    cacheConfig.blockSize = cacheBlockSize > 0 ? (size_t)cacheBlockSize : 0;
+    cacheConfig.maxBlocks = (int)cacheMaxBlocks;
+    cacheConfig.readAheadBlocks = (int)cacheReadAheadBlocks;
+
+    DocumentPool &pool = DocumentPool::instance();
+    DocumentPool::Key poolKey;
+    bool pooled = pool.isEnabled()
+            && DocumentPool::makeKey(fd, cpassword, (FileAccessMode)accessMode, cacheConfig,
+                                     &poolKey);
+    if(pooled) {
+        DocumentFile *shared = pool.acquire(poolKey);
+        if(shared != NULL) {
+            if(cpassword != NULL) {
+                env->ReleaseStringUTFChars(password, cpassword);
+            }
+            return reinterpret_cast<jlong>(shared);
+        }
+
+        //Descriptor of opener is closed with its document, pooled one may live longer
+        fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        if(fd < 0) {
+            if(cpassword != NULL) {
+                env->ReleaseStringUTFChars(password, cpassword);
+            }
+            jniThrowException(env, "java/io/IOException",
+                                    "Cannot duplicate file descriptor");
+            return -1;
+        }
+    }
+
     DocumentFile *docFile = new DocumentFile();
+    docFile->setFile(fd, fileLength, (FileAccessMode)accessMode, cacheConfig);
+    docFile->ownsFd = pooled;
 
     FPDF_FILEACCESS loader;
-    loader.m_FileLen = fileLength;
-    loader.m_Param = reinterpret_cast<void*>(intptr_t(fd));
-    loader.m_GetBlock = &getBlock;
+    docFile->fillLoader(&loader);
+
+    if(cpassword != NULL) {
+        docFile->hasPassword = true;
+        docFile->password = cpassword;
+    }
+
+    FPDF_DOCUMENT document;
+    long errorNum = FPDF_ERR_SUCCESS;
+    {
+        //Last error is library-global, read it before another document is loaded
+        Mutex::Autolock lock(getLibraryLock());
+        document = FPDF_LoadCustomDocument(&loader, cpassword);
+        if(!document) errorNum = FPDF_GetLastError();
+    }
+
+    if(cpassword != NULL) {
+        env->ReleaseStringUTFChars(password, cpassword);
+    }
+
+    if (!document) {
+        delete docFile;
+
+        if(errorNum == FPDF_ERR_PASSWORD) {
+            jniThrowException(env, "com/shockwave/pdfium/PdfPasswordException",
+                                    "Password required or incorrect password.");
+        } else {
+            char* error = getErrorDescription(errorNum);
+            jniThrowExceptionFmt(env, "java/io/IOException",
+                                    "cannot create document: %s", error);
+
+            free(error);
+        }
 
+        return -1;
+    }
+
+    docFile->pdfDocument = document;
+    if(pooled && !pool.add(poolKey, docFile)) {
+        //Pool is full of documents in use, document is private to this opener
+        LOGD("Document pool full, document not pooled");
+    }
+
+    return reinterpret_cast<jlong>(docFile);
+}
+
+static jlong loadMemDocument(JNIEnv *env, DocumentFile *docFile, jstring password) {
     const char *cpassword = NULL;
     if(password != NULL) {
         cpassword = env->GetStringUTFChars(password, NULL);
+        docFile->hasPassword = true;
+        docFile->password = cpassword;
     }
 
-    FPDF_DOCUMENT document = FPDF_LoadCustomDocument(&loader, cpassword);
+    FPDF_DOCUMENT document;
+    long errorNum = FPDF_ERR_SUCCESS;
+    {
+        Mutex::Autolock lock(getLibraryLock());
+        document = FPDF_LoadMemDocument( reinterpret_cast<const void*>(docFile->memoryData),
+                                                  (int) docFile->fileSize, cpassword);
+        if(!document) errorNum = FPDF_GetLastError();
+    }
 
     if(cpassword != NULL) {
         env->ReleaseStringUTFChars(password, cpassword);
@@ -210,7 +322,6 @@ JNI_FUNC(jlong, PdfiumCore, nativeOpenDocument)(JNI_ARGS, jint fd, jstring passw
     if (!document) {
         delete docFile;
 
-        const long errorNum = FPDF_GetLastError();
         if(errorNum == FPDF_ERR_PASSWORD) {
             jniThrowException(env, "com/shockwave/pdfium/PdfPasswordException",
                                     "Password required or incorrect password.");
@@ -231,20 +342,67 @@ JNI_FUNC(jlong, PdfiumCore, nativeOpenDocument)(JNI_ARGS, jint fd, jstring passw
 }
 
 JNI_FUNC(jlong, PdfiumCore, nativeOpenMemDocument)(JNI_ARGS, jbyteArray data, jstring password){
+    int size = (int) env->GetArrayLength(data);
+    if(size <= 0) {
+        jniThrowException(env, "java/io/IOException",
+                                    "File is empty");
+        return -1;
+    }
+
+    //PDFium reads the data for the whole life of document, so it is copied once and
+    //owned by DocumentFile instead of pinning the array
+    uint8_t *cDataCopy = new uint8_t[size];
+    env->GetByteArrayRegion(data, 0, size, reinterpret_cast<jbyte*>(cDataCopy));
+
+    DocumentFile *docFile = new DocumentFile();
+    docFile->setOwnedMemory(cDataCopy, (size_t) size);
+
+    return loadMemDocument(env, docFile, password);
+}
+
+JNI_FUNC(jlong, PdfiumCore, nativeOpenDataSourceDocument)(JNI_ARGS, jobject source,
+                                                          jlong size, jstring password,
+                                                          jint cacheBlockSize, jint cacheMaxBlocks,
+                                                          jint cacheReadAheadBlocks){
+    if(size <= 0) {
+        jniThrowException(env, "java/io/IOException",
+                                    "File is empty");
+        return -1;
+    }
+
+    JavaDataSource *dataSource = new JavaDataSource(env, source);
+    if(!dataSource->isValid()) {
+        delete dataSource;
+        jniThrowException(env, "java/io/IOException",
+                                    "Invalid data source");
+        return -1;
+    }
+
     DocumentFile *docFile = new DocumentFile();
+    BlockCache::Config cacheConfig;
+    cacheConfig.blockSize = cacheBlockSize > 0 ? (size_t)cacheBlockSize : 0;
+    cacheConfig.maxBlocks = (int)cacheMaxBlocks;
+    cacheConfig.readAheadBlocks = (int)cacheReadAheadBlocks;
+    docFile->setDataSource(dataSource, (size_t)size, cacheConfig);
+
+    FPDF_FILEACCESS loader;
+    docFile->fillLoader(&loader);
 
     const char *cpassword = NULL;
     if(password != NULL) {
         cpassword = env->GetStringUTFChars(password, NULL);
+        docFile->hasPassword = true;
+        docFile->password = cpassword;
     }
 
-    jbyte *cData = env->GetByteArrayElements(data, NULL);
-    int size = (int) env->GetArrayLength(data);
-    jbyte *cDataCopy = new jbyte[size];
-    memcpy(cDataCopy, cData, size);
-    FPDF_DOCUMENT document = FPDF_LoadMemDocument( reinterpret_cast<const void*>(cDataCopy),
-                                                          size, cpassword);
-    env->ReleaseByteArrayElements(data, cData, JNI_ABORT);
+    FPDF_DOCUMENT document;
+    long errorNum = FPDF_ERR_SUCCESS;
+    {
+        //Last error is library-global, read it before another document is loaded
+        Mutex::Autolock lock(getLibraryLock());
+        document = FPDF_LoadCustomDocument(&loader, cpassword);
+        if(!document) errorNum = FPDF_GetLastError();
+    }
 
     if(cpassword != NULL) {
         env->ReleaseStringUTFChars(password, cpassword);
@@ -253,7 +411,6 @@ JNI_FUNC(jlong, PdfiumCore, nativeOpenMemDocument)(JNI_ARGS, jbyteArray data, js
     if (!document) {
         delete docFile;
 
-        const long errorNum = FPDF_GetLastError();
         if(errorNum == FPDF_ERR_PASSWORD) {
             jniThrowException(env, "com/shockwave/pdfium/PdfPasswordException",
                                     "Password required or incorrect password.");
@@ -273,23 +430,188 @@ JNI_FUNC(jlong, PdfiumCore, nativeOpenMemDocument)(JNI_ARGS, jbyteArray data, js
     return reinterpret_cast<jlong>(docFile);
 }
 
+JNI_FUNC(jlong, PdfiumCore, nativeOpenDirectBufferDocument)(JNI_ARGS, jobject buffer,
+                                                            jstring password){
+    DocumentFile *docFile = new DocumentFile();
+    if(!docFile->setDirectBuffer(env, buffer)) {
+        delete docFile;
+        jniThrowException(env, "java/io/IOException",
+                                    "Buffer is not direct or empty");
+        return -1;
+    }
+
+    return loadMemDocument(env, docFile, password);
+}
+
+JNI_FUNC(jlongArray, PdfiumCore, nativeGetBlockCacheStats)(JNI_ARGS, jlong docPtr){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(doc == NULL || doc->blockCache == NULL) return NULL;
+
+    BlockCache::Stats stats = doc->blockCache->getStats();
+    jlong values[] = { (jlong)stats.requests, (jlong)stats.blockHits, (jlong)stats.blockMisses,
+                       (jlong)stats.readCalls, (jlong)stats.bytesRead,
+                       (jlong)stats.readAheadBlocks };
+
+    jlongArray result = env->NewLongArray(6);
+    env->SetLongArrayRegion(result, 0, 6, values);
+    return result;
+}
+
+JNI_FUNC(jlong, PdfiumCore, nativeOpenProgressiveDocument)(JNI_ARGS, jint fd, jlong fileSize,
+                                                           jstring password){
+    if(fileSize <= 0) {
+        jniThrowException(env, "java/io/IOException",
+                                    "Expected file size is unknown");
+        return -1;
+    }
+
+    DocumentFile *docFile = new DocumentFile();
+    //File grows while it is opened, so it can be neither mapped nor cached
+    BlockCache::Config cacheConfig = { 0, 0, 0 };
+    docFile->setFile(fd, (size_t)fileSize, ACCESS_PREAD, cacheConfig);
+
+    if(password != NULL) {
+        const char *cpassword = env->GetStringUTFChars(password, NULL);
+        docFile->hasPassword = true;
+        docFile->password = cpassword;
+        env->ReleaseStringUTFChars(password, cpassword);
+    }
+
+    docFile->progressive = new ProgressiveLoader(docFile);
+    if(!docFile->progressive->isValid()) {
+        delete docFile;
+        jniThrowException(env, "java/io/IOException",
+                                    "cannot create availability provider");
+        return -1;
+    }
+
+    return reinterpret_cast<jlong>(docFile);
+}
+
+JNI_FUNC(jint, PdfiumCore, nativeUpdateDocumentAvailability)(JNI_ARGS, jlong docPtr,
+                                                            jlong availableBytes){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(doc == NULL || doc->progressive == NULL) return PDF_DATA_ERROR;
+
+    doc->progressive->setAvailableBytes(availableBytes > 0 ? (uint64_t)availableBytes : 0);
+    if(doc->pdfDocument != NULL) return PDF_DATA_AVAIL;
+
+    int status = doc->progressive->isDocumentAvailable();
+    if(status != PDF_DATA_AVAIL) return status;
+
+    FPDF_DOCUMENT document;
+    long errorNum = FPDF_ERR_SUCCESS;
+    {
+        Mutex::Autolock lock(getLibraryLock());
+        document = doc->progressive->loadDocument(
+                doc->hasPassword ? doc->password.c_str() : NULL);
+        if(document == NULL) errorNum = FPDF_GetLastError();
+    }
+    if(document == NULL) {
+        if(errorNum == FPDF_ERR_PASSWORD) {
+            jniThrowException(env, "com/shockwave/pdfium/PdfPasswordException",
+                                    "Password required or incorrect password.");
+        } else {
+            char* error = getErrorDescription(errorNum);
+            jniThrowExceptionFmt(env, "java/io/IOException",
+                                    "cannot create document: %s", error);
+
+            free(error);
+        }
+        return PDF_DATA_ERROR;
+    }
+    doc->pdfDocument = document;
+
+    return PDF_DATA_AVAIL;
+}
+
+JNI_FUNC(jint, PdfiumCore, nativeIsPageAvailable)(JNI_ARGS, jlong docPtr, jint pageIndex){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(doc == NULL || doc->pdfDocument == NULL) return PDF_DATA_ERROR;
+    if(doc->progressive == NULL) return PDF_DATA_AVAIL;
+
+    return doc->progressive->isPageAvailable(pageIndex);
+}
+
+JNI_FUNC(jint, PdfiumCore, nativeIsLinearized)(JNI_ARGS, jlong docPtr){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(doc == NULL || doc->progressive == NULL) return PDF_LINEARIZATION_UNKNOWN;
+
+    return doc->progressive->isLinearized();
+}
+
+JNI_FUNC(jint, PdfiumCore, nativeGetFirstAvailablePage)(JNI_ARGS, jlong docPtr){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(doc == NULL || doc->pdfDocument == NULL) return -1;
+
+    Mutex::Autolock lock(getLibraryLock());
+    return (jint)FPDFAvail_GetFirstPageNum(doc->pdfDocument);
+}
+
+JNI_FUNC(jlongArray, PdfiumCore, nativeGetNeededRanges)(JNI_ARGS, jlong docPtr){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(doc == NULL || doc->progressive == NULL) return NULL;
+
+    std::vector<uint64_t> ranges = doc->progressive->getNeededRanges();
+    jlongArray result = env->NewLongArray(ranges.size());
+    if(result == NULL || ranges.empty()) return result;
+
+    std::vector<jlong> values(ranges.begin(), ranges.end());
+    env->SetLongArrayRegion(result, 0, values.size(), &values[0]);
+    return result;
+}
+
 JNI_FUNC(jint, PdfiumCore, nativeGetPageCount)(JNI_ARGS, jlong documentPtr){
     DocumentFile *doc = reinterpret_cast<DocumentFile*>(documentPtr);
+    if(doc == NULL || doc->pdfDocument == NULL) return 0;
+
+    Mutex::Autolock lock(getLibraryLock());
     return (jint)FPDF_GetPageCount(doc->pdfDocument);
 }
 
 JNI_FUNC(void, PdfiumCore, nativeCloseDocument)(JNI_ARGS, jlong documentPtr){
     DocumentFile *doc = reinterpret_cast<DocumentFile*>(documentPtr);
+    if(DocumentPool::instance().release(doc)) return;
+
+    TileCache::instance().removeDocument(doc);
     delete doc;
 }
 
+JNI_FUNC(void, PdfiumCore, nativeSetDocumentPoolLimits)(JNI_ARGS, jint maxDocuments,
+                                                       jlong idleTimeoutMs){
+    DocumentPool::instance().setLimits(maxDocuments, idleTimeoutMs);
+}
+
+JNI_FUNC(void, PdfiumCore, nativeTrimDocumentPool)(JNI_ARGS, jboolean all){
+    if(all) {
+        DocumentPool::instance().clear();
+    } else {
+        DocumentPool::instance().trim();
+    }
+}
+
+JNI_FUNC(jlongArray, PdfiumCore, nativeGetDocumentPoolStats)(JNI_ARGS){
+    DocumentPool::Stats stats = DocumentPool::instance().getStats();
+    jlong values[] = { (jlong)stats.acquires, (jlong)stats.hits, (jlong)stats.misses,
+                       (jlong)stats.evictions, (jlong)stats.documents,
+                       (jlong)stats.idleDocuments };
+
+    jlongArray result = env->NewLongArray(6);
+    env->SetLongArrayRegion(result, 0, 6, values);
+    return result;
+}
+
 static jlong loadPageInternal(JNIEnv *env, DocumentFile *doc, int pageIndex){
     try{
         if(doc == NULL) throw "Get page document null";
 
         FPDF_DOCUMENT pdfDoc = doc->pdfDocument;
         if(pdfDoc != NULL){
-            FPDF_PAGE page = FPDF_LoadPage(pdfDoc, pageIndex);
+            FPDF_PAGE page;
+            {
+                Mutex::Autolock lock(getLibraryLock());
+                page = FPDF_LoadPage(pdfDoc, pageIndex);
+            }
             if (page == NULL) {
                 throw "Loaded page is null";
             }
@@ -308,21 +630,28 @@ static jlong loadPageInternal(JNIEnv *env, DocumentFile *doc, int pageIndex){
     }
 }
 
-static void closePageInternal(jlong pagePtr) { FPDF_ClosePage(reinterpret_cast<FPDF_PAGE>(pagePtr)); }
+static void closePageInternal(jlong pagePtr) {
+    Mutex::Autolock lock(getLibraryLock());
+    FPDF_ClosePage(reinterpret_cast<FPDF_PAGE>(pagePtr));
+}
 
 JNI_FUNC(jlong, PdfiumCore, nativeLoadPage)(JNI_ARGS, jlong docPtr, jint pageIndex){
     DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(!checkDocumentLoaded(env, doc)) return -1;
     return loadPageInternal(env, doc, (int)pageIndex);
 }
 JNI_FUNC(jlongArray, PdfiumCore, nativeLoadPages)(JNI_ARGS, jlong docPtr, jint fromIndex, jint toIndex){
     DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
 
     if(toIndex < fromIndex) return NULL;
+    if(!checkDocumentLoaded(env, doc)) return NULL;
     jlong pages[ toIndex - fromIndex + 1 ];
 
     int i;
     for(i = 0; i <= (toIndex - fromIndex); i++){
         pages[i] = loadPageInternal(env, doc, (int)(i + fromIndex));
+        //No JNI calls are allowed with pending exception
+        if(env->ExceptionCheck()) return NULL;
     }
 
     jlongArray javaPages = env -> NewLongArray( (jsize)(toIndex - fromIndex + 1) );
@@ -342,33 +671,35 @@ JNI_FUNC(void, PdfiumCore, nativeClosePages)(JNI_ARGS, jlongArray pagesPtr){
 
 JNI_FUNC(jint, PdfiumCore, nativeGetPageWidthPixel)(JNI_ARGS, jlong pagePtr, jint dpi){
     FPDF_PAGE page = reinterpret_cast<FPDF_PAGE>(pagePtr);
+    Mutex::Autolock lock(getLibraryLock());
     return (jint)(FPDF_GetPageWidth(page) * dpi / 72);
 }
 JNI_FUNC(jint, PdfiumCore, nativeGetPageHeightPixel)(JNI_ARGS, jlong pagePtr, jint dpi){
     FPDF_PAGE page = reinterpret_cast<FPDF_PAGE>(pagePtr);
+    Mutex::Autolock lock(getLibraryLock());
     return (jint)(FPDF_GetPageHeight(page) * dpi / 72);
 }
 
 JNI_FUNC(jint, PdfiumCore, nativeGetPageWidthPoint)(JNI_ARGS, jlong pagePtr){
     FPDF_PAGE page = reinterpret_cast<FPDF_PAGE>(pagePtr);
+    Mutex::Autolock lock(getLibraryLock());
     return (jint)FPDF_GetPageWidth(page);
 }
 JNI_FUNC(jint, PdfiumCore, nativeGetPageHeightPoint)(JNI_ARGS, jlong pagePtr){
     FPDF_PAGE page = reinterpret_cast<FPDF_PAGE>(pagePtr);
+    Mutex::Autolock lock(getLibraryLock());
     return (jint)FPDF_GetPageHeight(page);
 }
 JNI_FUNC(jobject, PdfiumCore, nativeGetPageSizeByIndex)(JNI_ARGS, jlong docPtr, jint pageIndex, jint dpi){
     DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
-    if(doc == NULL) {
-        LOGE("Document is null");
-
-        jniThrowException(env, "java/lang/IllegalStateException",
-                               "Document is null");
-        return NULL;
-    }
+    if(!checkDocumentLoaded(env, doc)) return NULL;
 
     double width, height;
-    int result = FPDF_GetPageSizeByIndex(doc->pdfDocument, pageIndex, &width, &height);
+    int result;
+    {
+        Mutex::Autolock lock(getLibraryLock());
+        result = FPDF_GetPageSizeByIndex(doc->pdfDocument, pageIndex, &width, &height);
+    }
 
     if (result == 0) {
         width = 0;
@@ -378,9 +709,7 @@ JNI_FUNC(jobject, PdfiumCore, nativeGetPageSizeByIndex)(JNI_ARGS, jlong docPtr,
     jint widthInt = (jint) (width * dpi / 72);
     jint heightInt = (jint) (height * dpi / 72);
 
-    jclass clazz = env->FindClass("com/shockwave/pdfium/util/Size");
-    jmethodID constructorID = env->GetMethodID(clazz, "<init>", "(II)V");
-    return env->NewObject(clazz, constructorID, widthInt, heightInt);
+    return env->NewObject(sJni.sizeClass, sJni.sizeInit, widthInt, heightInt);
 }
 
 static void renderPageInternal( FPDF_PAGE page,
@@ -390,6 +719,7 @@ static void renderPageInternal( FPDF_PAGE page,
                                 int drawSizeHor, int drawSizeVer,
                                 bool renderAnnot){
 
+    Mutex::Autolock lock(getLibraryLock());
     FPDF_BITMAP pdfBitmap = FPDFBitmap_CreateEx( canvasHorSize, canvasVerSize,
                                                  FPDFBitmap_BGRA,
                                                  windowBuffer->bits, (int)(windowBuffer->stride) * 4);
@@ -466,10 +796,32 @@ JNI_FUNC(void, PdfiumCore, nativeRenderPage)(JNI_ARGS, jlong pagePtr, jobject ob
     ANativeWindow_release(nativeWindow);
 }
 
+/** Fetch info and lock pixels of bitmap, returns NULL if bitmap cannot be rendered to */
+static void* lockRenderBitmap(JNIEnv *env, jobject bitmap, AndroidBitmapInfo *info){
+    int ret;
+    if((ret = AndroidBitmap_getInfo(env, bitmap, info)) < 0) {
+        LOGE("Fetching bitmap info failed: %s", strerror(ret * -1));
+        return NULL;
+    }
+
+    if(info->format != ANDROID_BITMAP_FORMAT_RGBA_8888 && info->format != ANDROID_BITMAP_FORMAT_RGB_565){
+        LOGE("Bitmap format must be RGBA_8888 or RGB_565");
+        return NULL;
+    }
+
+    void *addr;
+    if( (ret = AndroidBitmap_lockPixels(env, bitmap, &addr)) != 0 ){
+        LOGE("Locking bitmap failed: %s", strerror(ret * -1));
+        return NULL;
+    }
+    return addr;
+}
+
 JNI_FUNC(void, PdfiumCore, nativeRenderPageBitmap)(JNI_ARGS, jlong pagePtr, jobject bitmap,
                                              jint dpi, jint startX, jint startY,
                                              jint drawSizeHor, jint drawSizeVer,
-                                             jboolean renderAnnot){
+                                             jboolean renderAnnot, jboolean dither,
+                                             jint bandSize){
 
     FPDF_PAGE page = reinterpret_cast<FPDF_PAGE>(pagePtr);
 
@@ -479,110 +831,697 @@ JNI_FUNC(void, PdfiumCore, nativeRenderPageBitmap)(JNI_ARGS, jlong pagePtr, jobj
     }
 
     AndroidBitmapInfo info;
-    int ret;
-    if((ret = AndroidBitmap_getInfo(env, bitmap, &info)) < 0) {
-        LOGE("Fetching bitmap info failed: %s", strerror(ret * -1));
-        return;
-    }
+    void *addr = lockRenderBitmap(env, bitmap, &info);
+    if(addr == NULL) return;
 
-    int canvasHorSize = info.width;
-    int canvasVerSize = info.height;
+    int flags = FPDF_REVERSE_BYTE_ORDER;
 
-    if(info.format != ANDROID_BITMAP_FORMAT_RGBA_8888 && info.format != ANDROID_BITMAP_FORMAT_RGB_565){
-        LOGE("Bitmap format must be RGBA_8888 or RGB_565");
-        return;
+    if(renderAnnot) {
+    	flags |= FPDF_ANNOT;
     }
 
-    void *addr;
-    if( (ret = AndroidBitmap_lockPixels(env, bitmap, &addr)) != 0 ){
-        LOGE("Locking bitmap failed: %s", strerror(ret * -1));
-        return;
-    }
+    renderPageBitmapInternal(page, addr, info,
+                             (int)startX, (int)startY, (int)drawSizeHor, (int)drawSizeVer,
+                             flags, (bool)dither, (int)bandSize);
 
-    void *tmp;
-    int format;
-    int sourceStride;
-    if (info.format == ANDROID_BITMAP_FORMAT_RGB_565) {
-        tmp = malloc(canvasVerSize * canvasHorSize * sizeof(rgb));
-        sourceStride = canvasHorSize * sizeof(rgb);
-        format = FPDFBitmap_BGR;
-    } else {
-        tmp = addr;
-        sourceStride = info.stride;
-        format = FPDFBitmap_BGRA;
-    }
+    AndroidBitmap_unlockPixels(env, bitmap);
+}
 
-    FPDF_BITMAP pdfBitmap = FPDFBitmap_CreateEx( canvasHorSize, canvasVerSize,
-                                                     format, tmp, sourceStride);
+JNI_FUNC(void, PdfiumCore, nativeRenderPageBitmapCached)(JNI_ARGS, jlong docPtr, jint pageIndex,
+                                             jlong pagePtr, jobject bitmap,
+                                             jint startX, jint startY,
+                                             jint drawSizeHor, jint drawSizeVer,
+                                             jboolean renderAnnot, jboolean dither,
+                                             jint bandSize){
 
-    /*LOGD("Start X: %d", startX);
-    LOGD("Start Y: %d", startY);
-    LOGD("Canvas Hor: %d", canvasHorSize);
-    LOGD("Canvas Ver: %d", canvasVerSize);
-    LOGD("Draw Hor: %d", drawSizeHor);
-    LOGD("Draw Ver: %d", drawSizeVer);*/
+    FPDF_PAGE page = reinterpret_cast<FPDF_PAGE>(pagePtr);
 
-    if(drawSizeHor < canvasHorSize || drawSizeVer < canvasVerSize){
-        FPDFBitmap_FillRect( pdfBitmap, 0, 0, canvasHorSize, canvasVerSize,
-                             0x848484FF); //Gray
+    if(page == NULL || bitmap == NULL){
+        LOGE("Render page pointers invalid");
+        return;
     }
 
-    int baseHorSize = (canvasHorSize < drawSizeHor)? canvasHorSize : (int)drawSizeHor;
-    int baseVerSize = (canvasVerSize < drawSizeVer)? canvasVerSize : (int)drawSizeVer;
-    int baseX = (startX < 0)? 0 : (int)startX;
-    int baseY = (startY < 0)? 0 : (int)startY;
+    AndroidBitmapInfo info;
+    void *addr = lockRenderBitmap(env, bitmap, &info);
+    if(addr == NULL) return;
+
     int flags = FPDF_REVERSE_BYTE_ORDER;
 
     if(renderAnnot) {
     	flags |= FPDF_ANNOT;
     }
 
-    FPDFBitmap_FillRect( pdfBitmap, baseX, baseY, baseHorSize, baseVerSize,
-                         0xFFFFFFFF); //White
+    TileCache &cache = TileCache::instance();
+    TileCache::Key key;
+    key.document = reinterpret_cast<const void*>(docPtr);
+    key.pageIndex = (int)pageIndex;
+    key.drawSizeHor = (int)drawSizeHor;
+    key.drawSizeVer = (int)drawSizeVer;
+    key.startX = (int)startX;
+    key.startY = (int)startY;
+    key.width = (int)info.width;
+    key.height = (int)info.height;
+    key.format = info.format;
+    key.flags = flags | (dither ? TileCache::FLAG_DITHER : 0);
+
+    if(!cache.copyTo(key, addr, (int)info.stride)){
+        renderPageBitmapInternal(page, addr, info,
+                                 (int)startX, (int)startY, (int)drawSizeHor, (int)drawSizeVer,
+                                 flags, (bool)dither, (int)bandSize);
+
+        int bytesPerPixel = (info.format == ANDROID_BITMAP_FORMAT_RGB_565)? 2 : 4;
+        cache.put(key, addr, (int)info.stride, (int)info.width * bytesPerPixel, (int)info.height);
+    }
 
-    FPDF_RenderPageBitmap( pdfBitmap, page,
-                           startX, startY,
-                           (int)drawSizeHor, (int)drawSizeVer,
-                           0, flags );
+    AndroidBitmap_unlockPixels(env, bitmap);
+}
+
+JNI_FUNC(void, PdfiumCore, nativeSetTileCacheBudget)(JNI_ARGS, jlong bytes){
+    TileCache::instance().setBudget(bytes > 0 ? (size_t)bytes : 0);
+}
+
+JNI_FUNC(void, PdfiumCore, nativeClearTileCache)(JNI_ARGS){
+    TileCache::instance().clear();
+}
+
+JNI_FUNC(jlongArray, PdfiumCore, nativeGetTileCacheStats)(JNI_ARGS){
+    TileCache::Stats stats = TileCache::instance().getStats();
+    jlong values[] = { (jlong)stats.hits, (jlong)stats.misses, (jlong)stats.evictions,
+                       (jlong)stats.bytes, (jlong)stats.budget, (jlong)stats.entries };
+
+    jlongArray result = env->NewLongArray(6);
+    env->SetLongArrayRegion(result, 0, 6, values);
+    return result;
+}
+
+JNI_FUNC(jlong, PdfiumCore, nativeStartRenderJob)(JNI_ARGS, jlong docPtr, jint pageIndex,
+                                             jobject bitmap, jint startX, jint startY,
+                                             jint drawSizeHor, jint drawSizeVer,
+                                             jboolean renderAnnot, jint sliceBudgetMs){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+
+    if(doc == NULL || doc->pdfDocument == NULL || bitmap == NULL){
+        LOGE("Render job pointers invalid");
+        return 0;
+    }
+
+    AndroidBitmapInfo info;
+    int ret;
+    if((ret = AndroidBitmap_getInfo(env, bitmap, &info)) < 0) {
+        LOGE("Fetching bitmap info failed: %s", strerror(ret * -1));
+        return 0;
+    }
+
+    if(info.format != ANDROID_BITMAP_FORMAT_RGBA_8888 && info.format != ANDROID_BITMAP_FORMAT_RGB_565){
+        LOGE("Bitmap format must be RGBA_8888 or RGB_565");
+        return 0;
+    }
+
+    int flags = FPDF_REVERSE_BYTE_ORDER;
+    if(renderAnnot) {
+        flags |= FPDF_ANNOT;
+    }
+
+    RenderJob *job = new RenderJob(doc->pdfDocument, (int)pageIndex,
+                                   info.format == ANDROID_BITMAP_FORMAT_RGB_565,
+                                   (int)info.width, (int)info.height,
+                                   (int)startX, (int)startY,
+                                   (int)drawSizeHor, (int)drawSizeVer,
+                                   flags, (int64_t)sliceBudgetMs * 1000000LL);
+    return reinterpret_cast<jlong>(job);
+}
+
+JNI_FUNC(jint, PdfiumCore, nativeContinueRenderJob)(JNI_ARGS, jlong jobPtr){
+    RenderJob *job = reinterpret_cast<RenderJob*>(jobPtr);
+    return (jint)job->resume();
+}
+
+JNI_FUNC(void, PdfiumCore, nativeCancelRenderJob)(JNI_ARGS, jlong jobPtr){
+    RenderJob *job = reinterpret_cast<RenderJob*>(jobPtr);
+    job->cancel();
+}
+
+JNI_FUNC(jboolean, PdfiumCore, nativeRenderJobToBitmap)(JNI_ARGS, jlong jobPtr, jobject bitmap){
+    RenderJob *job = reinterpret_cast<RenderJob*>(jobPtr);
+
+    AndroidBitmapInfo info;
+    int ret;
+    if((ret = AndroidBitmap_getInfo(env, bitmap, &info)) < 0) {
+        LOGE("Fetching bitmap info failed: %s", strerror(ret * -1));
+        return JNI_FALSE;
+    }
+
+    bool rgb565 = info.format == ANDROID_BITMAP_FORMAT_RGB_565;
+    if((int)info.width != job->getWidth() || (int)info.height != job->getHeight()
+            || rgb565 != job->isRgb565()){
+        LOGE("Bitmap does not match render job");
+        return JNI_FALSE;
+    }
+
+    void *addr;
+    if( (ret = AndroidBitmap_lockPixels(env, bitmap, &addr)) != 0 ){
+        LOGE("Locking bitmap failed: %s", strerror(ret * -1));
+        return JNI_FALSE;
+    }
+
+    job->copyTo(addr, (int)info.stride);
+
+    AndroidBitmap_unlockPixels(env, bitmap);
+    return JNI_TRUE;
+}
+
+JNI_FUNC(void, PdfiumCore, nativeCloseRenderJob)(JNI_ARGS, jlong jobPtr){
+    RenderJob *job = reinterpret_cast<RenderJob*>(jobPtr);
+    delete job;
+}
+
+JNI_FUNC(jlong, PdfiumCore, nativeOpenFrameScheduler)(JNI_ARGS){
+    return reinterpret_cast<jlong>(new FrameScheduler());
+}
+
+JNI_FUNC(void, PdfiumCore, nativeCloseFrameScheduler)(JNI_ARGS, jlong schedulerPtr){
+    FrameScheduler *scheduler = reinterpret_cast<FrameScheduler*>(schedulerPtr);
+    delete scheduler;
+}
+
+JNI_FUNC(jint, PdfiumCore, nativeRenderFrame)(JNI_ARGS, jlong schedulerPtr, jlongArray jobsPtr,
+                                              jlong deadlineNs, jintArray statusesOut){
+    FrameScheduler *scheduler = reinterpret_cast<FrameScheduler*>(schedulerPtr);
+    jsize count = env->GetArrayLength(jobsPtr);
+
+    std::vector<jlong> ptrs(count);
+    if(count > 0) env->GetLongArrayRegion(jobsPtr, 0, count, &ptrs[0]);
+    std::vector<RenderJob*> jobs(count);
+    for(jsize i = 0; i < count; i++){
+        jobs[i] = reinterpret_cast<RenderJob*>(ptrs[i]);
+    }
+
+    int incomplete = scheduler->renderFrame(count > 0 ? &jobs[0] : NULL, (int)count,
+                                            (int64_t)deadlineNs);
+
+    std::vector<jint> statuses(count);
+    for(jsize i = 0; i < count; i++){
+        int status = jobs[i] != NULL ? jobs[i]->getStatus() : FPDF_RENDER_FAILED;
+        //Jobs which got no slice yet are not started
+        if(status == FPDF_RENDER_READER) status = FPDF_RENDER_TOBECOUNTINUED;
+        statuses[i] = (jint)status;
+    }
+    if(count > 0) env->SetIntArrayRegion(statusesOut, 0, count, &statuses[0]);
+    return (jint)incomplete;
+}
+
+JNI_FUNC(jlongArray, PdfiumCore, nativeGetFrameTrace)(JNI_ARGS, jlong schedulerPtr){
+    FrameScheduler *scheduler = reinterpret_cast<FrameScheduler*>(schedulerPtr);
+    FrameScheduler::Trace trace = scheduler->getTrace();
+
+    //Totals followed by frame, overrun and pending jobs of every recent miss
+    std::vector<jlong> values;
+    values.push_back((jlong)trace.frames);
+    values.push_back((jlong)trace.misses);
+    values.push_back((jlong)trace.worstOverrunNs);
+    values.push_back((jlong)trace.totalOverrunNs);
+    for(size_t i = 0; i < trace.recent.size(); i++){
+        values.push_back((jlong)trace.recent[i].frame);
+        values.push_back((jlong)trace.recent[i].overrunNs);
+        values.push_back((jlong)trace.recent[i].pendingJobs);
+    }
+
+    jlongArray result = env->NewLongArray((jsize)values.size());
+    env->SetLongArrayRegion(result, 0, (jsize)values.size(), &values[0]);
+    return result;
+}
+
+JNI_FUNC(void, PdfiumCore, nativeResetFrameTrace)(JNI_ARGS, jlong schedulerPtr){
+    FrameScheduler *scheduler = reinterpret_cast<FrameScheduler*>(schedulerPtr);
+    scheduler->resetTrace();
+}
+
+JNI_FUNC(jlong, PdfiumCore, nativeOpenRenderScheduler)(JNI_ARGS, jlong docPtr, jint workerCount,
+                                                        jobject callback){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(doc == NULL || doc->pdfDocument == NULL) {
+        jniThrowException(env, "java/lang/IllegalStateException",
+                               "Document is not loaded");
+        return -1;
+    }
+
+    RenderScheduler *scheduler = new RenderScheduler(env, doc, (int)workerCount, callback);
+    if(scheduler->getWorkerCount() == 0) {
+        delete scheduler;
+        jniThrowException(env, "java/io/IOException",
+                               "cannot start render threads");
+        return -1;
+    }
+    LOGD("Render scheduler started with %d helpers", scheduler->getWorkerCount());
+
+    return reinterpret_cast<jlong>(scheduler);
+}
+
+JNI_FUNC(void, PdfiumCore, nativeCloseRenderScheduler)(JNI_ARGS, jlong schedulerPtr){
+    RenderScheduler *scheduler = reinterpret_cast<RenderScheduler*>(schedulerPtr);
+    delete scheduler;
+}
+
+JNI_FUNC(jlong, PdfiumCore, nativeSubmitRender)(JNI_ARGS, jlong schedulerPtr, jint pageIndex,
+                                             jobject bitmap, jint startX, jint startY,
+                                             jint drawSizeHor, jint drawSizeVer,
+                                             jboolean renderAnnot, jboolean dither,
+                                             jint priority){
+    RenderScheduler *scheduler = reinterpret_cast<RenderScheduler*>(schedulerPtr);
+    if(scheduler == NULL || bitmap == NULL) return 0;
+
+    int flags = FPDF_REVERSE_BYTE_ORDER;
+    if(renderAnnot) {
+        flags |= FPDF_ANNOT;
+    }
+
+    RenderScheduler::Request request;
+    request.pageIndex = (int)pageIndex;
+    request.startX = (int)startX;
+    request.startY = (int)startY;
+    request.drawSizeHor = (int)drawSizeHor;
+    request.drawSizeVer = (int)drawSizeVer;
+    request.flags = flags;
+    request.dither = (bool)dither;
+    request.priority = (int)priority;
+
+    return (jlong)scheduler->submit(env, request, bitmap);
+}
+
+JNI_FUNC(jboolean, PdfiumCore, nativeCancelRender)(JNI_ARGS, jlong schedulerPtr, jlong requestId){
+    RenderScheduler *scheduler = reinterpret_cast<RenderScheduler*>(schedulerPtr);
+    if(scheduler == NULL) return JNI_FALSE;
+    return scheduler->cancel(env, (int64_t)requestId) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNI_FUNC(jintArray, PdfiumCore, nativeRenderThumbnailAtlas)(JNI_ARGS, jlong docPtr,
+                                             jobject bitmap, jint fromIndex, jint toIndex,
+                                             jint cellWidth, jint cellHeight,
+                                             jboolean renderAnnot, jboolean dither){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+
+    if(!checkDocumentLoaded(env, doc)) return NULL;
+    if(bitmap == NULL){
+        LOGE("Render atlas arguments invalid");
+        return NULL;
+    }
+
+    AndroidBitmapInfo info;
+    void *addr = lockRenderBitmap(env, bitmap, &info);
+    if(addr == NULL) return NULL;
+
+    int flags = FPDF_REVERSE_BYTE_ORDER;
+    if(renderAnnot) {
+        flags |= FPDF_ANNOT;
+    }
+
+    ThumbnailAtlas atlas(addr, info.format == ANDROID_BITMAP_FORMAT_RGB_565, (int)info.stride,
+                         (int)info.width, (int)info.height,
+                         (int)cellWidth, (int)cellHeight, flags, dither);
+    atlas.render(doc->pdfDocument, (int)fromIndex, (int)toIndex);
+
+    AndroidBitmap_unlockPixels(env, bitmap);
+
+    //Empty for empty range or cells, nothing was rendered then
+    const std::vector<int> &rects = atlas.getRects();
+    jintArray result = env->NewIntArray(rects.size());
+    if(result == NULL) return NULL;
+    if(!rects.empty()){
+        env->SetIntArrayRegion(result, 0, rects.size(), (const jint*) &rects[0]);
+    }
+    return result;
+}
+
+JNI_FUNC(jstring, PdfiumCore, nativeGetDocumentFingerprint)(JNI_ARGS, jlong docPtr){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    DocumentFingerprint fingerprint;
+    if(!computeFingerprint(doc, &fingerprint)) {
+        return NULL;
+    }
+
+    char hex[33];
+    snprintf(hex, sizeof(hex), "%016llx%016llx",
+             (unsigned long long)fingerprint.fileSize, (unsigned long long)fingerprint.hash);
+    return env->NewStringUTF(hex);
+}
+
+JNI_FUNC(jfloatArray, PdfiumCore, nativeGetAllPageSizes)(JNI_ARGS, jlong docPtr){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(!checkDocumentLoaded(env, doc)) return NULL;
+
+    int pageCount;
+    std::vector<jfloat> sizes;
+    {
+        Mutex::Autolock lock(getLibraryLock());
+        pageCount = FPDF_GetPageCount(doc->pdfDocument);
+        if(pageCount < 0) pageCount = 0;
+        sizes.resize(pageCount * 2 + 1);
+        PageGeometry::computeSizes(doc->pdfDocument, &sizes[0], pageCount);
+    }
+
+    jfloatArray result = env->NewFloatArray(pageCount * 2);
+    env->SetFloatArrayRegion(result, 0, pageCount * 2, &sizes[0]);
+    return result;
+}
+
+JNI_FUNC(jfloatArray, PdfiumCore, nativeGetPageGeometry)(JNI_ARGS, jlong docPtr, jstring path){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(doc == NULL || doc->pdfDocument == NULL) return NULL;
+
+    const char *cpath = path != NULL ? env->GetStringUTFChars(path, NULL) : NULL;
+    PageGeometry *geometry = cpath != NULL ? PageGeometry::open(doc, cpath) : NULL;
+    if(geometry == NULL) {
+        geometry = PageGeometry::compute(doc);
+        if(geometry != NULL && cpath != NULL && !geometry->write(doc, cpath)) {
+            LOGE("Cannot write page geometry %s", cpath);
+        }
+    }
+    if(cpath != NULL) {
+        env->ReleaseStringUTFChars(path, cpath);
+    }
+    if(geometry == NULL) return NULL;
+
+    //Width, height and rotation of every page
+    int pageCount = geometry->getPageCount();
+    std::vector<jfloat> values(pageCount * 3 + 1);
+    const PageGeometry::Page *pages = geometry->getPages();
+    for(int i = 0; i < pageCount; i++){
+        values[i * 3] = pages[i].width;
+        values[i * 3 + 1] = pages[i].height;
+        values[i * 3 + 2] = (jfloat) pages[i].rotation;
+    }
+    delete geometry;
+
+    jfloatArray result = env->NewFloatArray(pageCount * 3);
+    if(result == NULL) return NULL;
+    env->SetFloatArrayRegion(result, 0, pageCount * 3, &values[0]);
+    return result;
+}
+
+//Hands extracted pages to PageTextCallback, stops when it returns false or throws
+class JavaTextSink : public TextExtractor::Sink {
+    public:
+    JavaTextSink(JNIEnv *env, jobject callback, jmethodID method)
+        : env(env), callback(callback), method(method) {}
+
+    virtual bool onPage(int pageIndex, const std::vector<uint16_t> &text) {
+        static const jchar empty = 0;
+        jstring string = env->NewString(text.empty() ? &empty : (const jchar*) &text[0],
+                                        (jsize) text.size());
+        if(string == NULL) return false;
+
+        jboolean more = env->CallBooleanMethod(callback, method, (jint) pageIndex, string);
+        env->DeleteLocalRef(string);
+        //Exception is left pending for caller of extractText
+        return !env->ExceptionCheck() && more;
+    }
+
+    private:
+    JNIEnv *env;
+    jobject callback;
+    jmethodID method;
+};
+
+JNI_FUNC(jint, PdfiumCore, nativeExtractText)(JNI_ARGS, jlong docPtr, jint fromIndex,
+                                             jint toIndex, jobject callback){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(doc == NULL || doc->pdfDocument == NULL || callback == NULL) return 0;
+
+    jclass cls = env->GetObjectClass(callback);
+    jmethodID method = env->GetMethodID(cls, "onPageText", "(ILjava/lang/String;)Z");
+    env->DeleteLocalRef(cls);
+    if(method == NULL) return 0;
+
+    JavaTextSink sink(env, callback, method);
+    TextExtractor extractor;
+    return (jint) extractor.extract(doc->pdfDocument, (int)fromIndex, (int)toIndex, &sink);
+}
+
+//Hands hits of every searched window to SearchCallback, stops when it returns false or throws
+class JavaSearchSink : public TextSearch::Sink {
+    public:
+    JavaSearchSink(JNIEnv *env, jobject callback, jmethodID method)
+        : env(env), callback(callback), method(method) {}
+
+    virtual bool onResults(int lastPageIndex, const std::vector<TextSearch::Hit> &hits,
+                           const std::vector<float> &rects) {
+        //Page index, char index, char count and rect count of every hit
+        jintArray hitArray = env->NewIntArray((jsize)(hits.size() * 4));
+        if(hitArray == NULL) return false;
+        if(!hits.empty()){
+            env->SetIntArrayRegion(hitArray, 0, (jsize)(hits.size() * 4),
+                                   (const jint*) &hits[0]);
+        }
+
+        jfloatArray rectArray = env->NewFloatArray((jsize) rects.size());
+        if(rectArray == NULL){
+            env->DeleteLocalRef(hitArray);
+            return false;
+        }
+        if(!rects.empty()){
+            env->SetFloatArrayRegion(rectArray, 0, (jsize) rects.size(), &rects[0]);
+        }
+
+        jboolean more = env->CallBooleanMethod(callback, method, (jint) lastPageIndex,
+                                               hitArray, rectArray);
+        env->DeleteLocalRef(hitArray);
+        env->DeleteLocalRef(rectArray);
+        //Exception is left pending for caller of searchText
+        return !env->ExceptionCheck() && more;
+    }
+
+    private:
+    JNIEnv *env;
+    jobject callback;
+    jmethodID method;
+};
+
+JNI_FUNC(jlong, PdfiumCore, nativeOpenTextSearch)(JNI_ARGS, jstring query,
+                                                 jboolean matchCase, jboolean wholeWord){
+    if(query == NULL) return 0;
+    const jchar *chars = env->GetStringChars(query, NULL);
+    if(chars == NULL) return 0;
+    TextSearch *search = new TextSearch((const uint16_t*) chars,
+                                        (size_t) env->GetStringLength(query),
+                                        matchCase == JNI_TRUE, wholeWord == JNI_TRUE);
+    env->ReleaseStringChars(query, chars);
+    return reinterpret_cast<jlong>(search);
+}
+
+JNI_FUNC(jint, PdfiumCore, nativeSearchText)(JNI_ARGS, jlong docPtr, jlong searchPtr,
+                                             jint fromIndex, jint toIndex, jobject callback){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    TextSearch *search = reinterpret_cast<TextSearch*>(searchPtr);
+    if(doc == NULL || doc->pdfDocument == NULL || search == NULL || callback == NULL) return 0;
+
+    jclass cls = env->GetObjectClass(callback);
+    jmethodID method = env->GetMethodID(cls, "onSearchResults", "(I[I[F)Z");
+    env->DeleteLocalRef(cls);
+    if(method == NULL) return 0;
+
+    JavaSearchSink sink(env, callback, method);
+    return (jint) search->search(doc->pdfDocument, (int)fromIndex, (int)toIndex, &sink);
+}
+
+JNI_FUNC(void, PdfiumCore, nativeCancelTextSearch)(JNI_ARGS, jlong searchPtr){
+    TextSearch *search = reinterpret_cast<TextSearch*>(searchPtr);
+    search->cancel();
+}
+
+JNI_FUNC(void, PdfiumCore, nativeCloseTextSearch)(JNI_ARGS, jlong searchPtr){
+    TextSearch *search = reinterpret_cast<TextSearch*>(searchPtr);
+    delete search;
+}
+
+JNI_FUNC(jboolean, PdfiumCore, nativeWriteTextIndex)(JNI_ARGS, jlong docPtr, jstring path){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(doc == NULL || doc->pdfDocument == NULL || path == NULL) return JNI_FALSE;
+
+    const char *cpath = env->GetStringUTFChars(path, NULL);
+    bool written = TextIndex::write(doc, cpath);
+    env->ReleaseStringUTFChars(path, cpath);
+
+    return written ? JNI_TRUE : JNI_FALSE;
+}
+
+JNI_FUNC(jlong, PdfiumCore, nativeOpenTextIndex)(JNI_ARGS, jlong docPtr, jstring path){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(doc == NULL || path == NULL) return 0;
+
+    const char *cpath = env->GetStringUTFChars(path, NULL);
+    TextIndex *index = TextIndex::open(doc, cpath);
+    env->ReleaseStringUTFChars(path, cpath);
+
+    return reinterpret_cast<jlong>(index);
+}
+
+JNI_FUNC(jintArray, PdfiumCore, nativeSearchTextIndex)(JNI_ARGS, jlong indexPtr, jstring query,
+                                             jint maxHits){
+    TextIndex *index = reinterpret_cast<TextIndex*>(indexPtr);
+    if(index == NULL || query == NULL) return NULL;
+
+    const jchar *chars = env->GetStringChars(query, NULL);
+    if(chars == NULL) return NULL;
+    jsize length = env->GetStringLength(query);
+    std::vector<TextIndex::Hit> hits;
+    bool found = index->find((const uint16_t*) chars, (size_t) length, (int) maxHits, &hits);
+    env->ReleaseStringChars(query, chars);
+    if(!found) {
+        jniThrowException(env, "java/io/IOException", "Text index is corrupted");
+        return NULL;
+    }
+
+    //Page index, char index and char count of every hit
+    std::vector<jint> values(hits.size() * 3 + 1);
+    for(size_t i = 0; i < hits.size(); i++){
+        values[i * 3] = hits[i].pageIndex;
+        values[i * 3 + 1] = hits[i].charIndex;
+        values[i * 3 + 2] = hits[i].charCount;
+    }
+
+    jintArray result = env->NewIntArray((jsize)(hits.size() * 3));
+    if(result == NULL) return NULL;
+    env->SetIntArrayRegion(result, 0, (jsize)(hits.size() * 3), &values[0]);
+    return result;
+}
+
+JNI_FUNC(void, PdfiumCore, nativeCloseTextIndex)(JNI_ARGS, jlong indexPtr){
+    TextIndex *index = reinterpret_cast<TextIndex*>(indexPtr);
+    delete index;
+}
+
+JNI_FUNC(jboolean, PdfiumCore, nativeWriteThumbnailStore)(JNI_ARGS, jlong docPtr, jstring path,
+                                             jint maxWidth, jint maxHeight,
+                                             jboolean rgb565, jboolean renderAnnot){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(!checkDocumentLoaded(env, doc)) return JNI_FALSE;
+    if(path == NULL) return JNI_FALSE;
+
+    int flags = FPDF_REVERSE_BYTE_ORDER;
+    if(renderAnnot) {
+        flags |= FPDF_ANNOT;
+    }
+
+    const char *cpath = env->GetStringUTFChars(path, NULL);
+    bool written = ThumbnailStore::write(doc, cpath, (int)maxWidth, (int)maxHeight,
+                                         rgb565 ? ThumbnailStore::FORMAT_RGB_565
+                                                : ThumbnailStore::FORMAT_RGBA_8888,
+                                         flags);
+    env->ReleaseStringUTFChars(path, cpath);
+
+    return written ? JNI_TRUE : JNI_FALSE;
+}
+
+JNI_FUNC(jlong, PdfiumCore, nativeOpenThumbnailStore)(JNI_ARGS, jlong docPtr, jstring path){
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(doc == NULL || path == NULL) return 0;
+
+    const char *cpath = env->GetStringUTFChars(path, NULL);
+    ThumbnailStore *store = ThumbnailStore::open(doc, cpath);
+    env->ReleaseStringUTFChars(path, cpath);
+
+    return reinterpret_cast<jlong>(store);
+}
 
-    if (info.format == ANDROID_BITMAP_FORMAT_RGB_565) {
-        rgbBitmapTo565(tmp, sourceStride, addr, &info);
-        free(tmp);
+JNI_FUNC(jboolean, PdfiumCore, nativeIsThumbnailStoreRgb565)(JNI_ARGS, jlong storePtr){
+    ThumbnailStore *store = reinterpret_cast<ThumbnailStore*>(storePtr);
+    return store->getFormat() == ThumbnailStore::FORMAT_RGB_565 ? JNI_TRUE : JNI_FALSE;
+}
+
+JNI_FUNC(jintArray, PdfiumCore, nativeGetThumbnailSizes)(JNI_ARGS, jlong storePtr){
+    ThumbnailStore *store = reinterpret_cast<ThumbnailStore*>(storePtr);
+    int pageCount = store->getPageCount();
+
+    std::vector<jint> sizes(pageCount * 2 + 1);
+    for(int i = 0; i < pageCount; i++){
+        int width = 0, height = 0;
+        store->getSize(i, &width, &height);
+        sizes[i * 2] = width;
+        sizes[i * 2 + 1] = height;
     }
 
+    jintArray result = env->NewIntArray(pageCount * 2);
+    env->SetIntArrayRegion(result, 0, pageCount * 2, &sizes[0]);
+    return result;
+}
+
+JNI_FUNC(jboolean, PdfiumCore, nativeThumbnailToBitmap)(JNI_ARGS, jlong storePtr, jint pageIndex,
+                                             jobject bitmap){
+    ThumbnailStore *store = reinterpret_cast<ThumbnailStore*>(storePtr);
+
+    int width, height;
+    if(!store->getSize((int)pageIndex, &width, &height)) return JNI_FALSE;
+
+    AndroidBitmapInfo info;
+    int ret;
+    if((ret = AndroidBitmap_getInfo(env, bitmap, &info)) < 0) {
+        LOGE("Fetching bitmap info failed: %s", strerror(ret * -1));
+        return JNI_FALSE;
+    }
+
+    if((uint32_t)info.format != store->getFormat()
+            || (int)info.width < width || (int)info.height < height){
+        LOGE("Bitmap does not match thumbnail");
+        return JNI_FALSE;
+    }
+
+    void *addr;
+    if( (ret = AndroidBitmap_lockPixels(env, bitmap, &addr)) != 0 ){
+        LOGE("Locking bitmap failed: %s", strerror(ret * -1));
+        return JNI_FALSE;
+    }
+
+    bool copied = store->copyTo((int)pageIndex, addr, (int)info.stride);
+
     AndroidBitmap_unlockPixels(env, bitmap);
+    return copied ? JNI_TRUE : JNI_FALSE;
+}
+
+JNI_FUNC(void, PdfiumCore, nativeCloseThumbnailStore)(JNI_ARGS, jlong storePtr){
+    ThumbnailStore *store = reinterpret_cast<ThumbnailStore*>(storePtr);
+    delete store;
 }
 
 JNI_FUNC(jstring, PdfiumCore, nativeGetDocumentMetaText)(JNI_ARGS, jlong docPtr, jstring tag) {
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(!checkDocumentLoaded(env, doc)) return NULL;
+
     const char *ctag = env->GetStringUTFChars(tag, NULL);
     if (ctag == NULL) {
         return env->NewStringUTF("");
     }
-    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
 
-    size_t bufferLen = FPDF_GetMetaText(doc->pdfDocument, ctag, NULL, 0);
+    size_t bufferLen;
+    std::wstring text;
+    {
+        Mutex::Autolock lock(getLibraryLock());
+        bufferLen = FPDF_GetMetaText(doc->pdfDocument, ctag, NULL, 0);
+        if (bufferLen > 2) {
+            FPDF_GetMetaText(doc->pdfDocument, ctag, WriteInto(&text, bufferLen + 1), bufferLen);
+        }
+    }
+    env->ReleaseStringUTFChars(tag, ctag);
     if (bufferLen <= 2) {
         return env->NewStringUTF("");
     }
-    std::wstring text;
-    FPDF_GetMetaText(doc->pdfDocument, ctag, WriteInto(&text, bufferLen + 1), bufferLen);
-    env->ReleaseStringUTFChars(tag, ctag);
     return env->NewString((jchar*) text.c_str(), bufferLen / 2 - 1);
 }
 
 JNI_FUNC(jobject, PdfiumCore, nativeGetFirstChildBookmark)(JNI_ARGS, jlong docPtr, jobject bookmarkPtr) {
     DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(!checkDocumentLoaded(env, doc)) return NULL;
     FPDF_BOOKMARK parent;
     if(bookmarkPtr == NULL) {
         parent = NULL;
     } else {
-        jclass longClass = env->GetObjectClass(bookmarkPtr);
-        jmethodID longValueMethod = env->GetMethodID(longClass, "longValue", "()J");
-
-        jlong ptr = env->CallLongMethod(bookmarkPtr, longValueMethod);
+        jlong ptr = env->CallLongMethod(bookmarkPtr, sJni.longValue);
         parent = reinterpret_cast<FPDF_BOOKMARK>(ptr);
     }
-    FPDF_BOOKMARK bookmark = FPDFBookmark_GetFirstChild(doc->pdfDocument, parent);
+    FPDF_BOOKMARK bookmark;
+    {
+        Mutex::Autolock lock(getLibraryLock());
+        bookmark = FPDFBookmark_GetFirstChild(doc->pdfDocument, parent);
+    }
     if (bookmark == NULL) {
         return NULL;
     }
@@ -592,28 +1531,43 @@ JNI_FUNC(jobject, PdfiumCore, nativeGetFirstChildBookmark)(JNI_ARGS, jlong docPt
 JNI_FUNC(jobject, PdfiumCore, nativeGetSiblingBookmark)(JNI_ARGS, jlong docPtr, jlong bookmarkPtr) {
     DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
     FPDF_BOOKMARK parent = reinterpret_cast<FPDF_BOOKMARK>(bookmarkPtr);
-    FPDF_BOOKMARK bookmark = FPDFBookmark_GetNextSibling(doc->pdfDocument, parent);
+    FPDF_BOOKMARK bookmark;
+    {
+        Mutex::Autolock lock(getLibraryLock());
+        bookmark = FPDFBookmark_GetNextSibling(doc->pdfDocument, parent);
+    }
     if (bookmark == NULL) {
         return NULL;
     }
     return NewLong(env, reinterpret_cast<jlong>(bookmark));
 }
 
-JNI_FUNC(jstring, PdfiumCore, nativeGetBookmarkTitle)(JNI_ARGS, jlong bookmarkPtr) {
-    FPDF_BOOKMARK bookmark = reinterpret_cast<FPDF_BOOKMARK>(bookmarkPtr);
-    size_t bufferLen = FPDFBookmark_GetTitle(bookmark, NULL, 0);
+static jstring getBookmarkTitle(JNIEnv *env, FPDF_BOOKMARK bookmark, std::wstring &buffer) {
+    size_t bufferLen;
+    {
+        Mutex::Autolock lock(getLibraryLock());
+        bufferLen = FPDFBookmark_GetTitle(bookmark, NULL, 0);
+        if (bufferLen > 2) {
+            FPDFBookmark_GetTitle(bookmark, WriteInto(&buffer, bufferLen + 1), bufferLen);
+        }
+    }
     if (bufferLen <= 2) {
         return env->NewStringUTF("");
     }
+    return env->NewString((jchar*) buffer.c_str(), bufferLen / 2 - 1);
+}
+
+JNI_FUNC(jstring, PdfiumCore, nativeGetBookmarkTitle)(JNI_ARGS, jlong bookmarkPtr) {
+    FPDF_BOOKMARK bookmark = reinterpret_cast<FPDF_BOOKMARK>(bookmarkPtr);
     std::wstring title;
-    FPDFBookmark_GetTitle(bookmark, WriteInto(&title, bufferLen + 1), bufferLen);
-    return env->NewString((jchar*) title.c_str(), bufferLen / 2 - 1);
+    return getBookmarkTitle(env, bookmark, title);
 }
 
 JNI_FUNC(jlong, PdfiumCore, nativeGetBookmarkDestIndex)(JNI_ARGS, jlong docPtr, jlong bookmarkPtr) {
     DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
     FPDF_BOOKMARK bookmark = reinterpret_cast<FPDF_BOOKMARK>(bookmarkPtr);
 
+    Mutex::Autolock lock(getLibraryLock());
     FPDF_DEST dest = FPDFBookmark_GetDest(doc->pdfDocument, bookmark);
     if (dest == NULL) {
         return -1;
@@ -621,13 +1575,105 @@ JNI_FUNC(jlong, PdfiumCore, nativeGetBookmarkDestIndex)(JNI_ARGS, jlong docPtr,
     return (jlong) FPDFDest_GetPageIndex(doc->pdfDocument, dest);
 }
 
+JNI_FUNC(jobjectArray, PdfiumCore, nativeGetTableOfContents)(JNI_ARGS, jlong docPtr) {
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    if(!checkDocumentLoaded(env, doc)) return NULL;
+
+    struct Pending {
+        FPDF_BOOKMARK bookmark;
+        jint parent;
+        jint depth;
+    };
+
+    //Preorder walk with explicit stack, outlines of manuals are too deep for recursion.
+    //Malformed outlines may link back to their ancestors, so every entry is visited once.
+    std::vector<FPDF_BOOKMARK> bookmarks;
+    std::vector<jint> parents;
+    std::vector<jint> depths;
+    std::unordered_set<FPDF_BOOKMARK> visited;
+    {
+        Mutex::Autolock lock(getLibraryLock());
+        std::vector<Pending> stack;
+        Pending root = { FPDFBookmark_GetFirstChild(doc->pdfDocument, NULL), -1, 0 };
+        stack.push_back(root);
+        while (!stack.empty()) {
+            Pending current = stack.back();
+            stack.pop_back();
+            if (current.bookmark == NULL || !visited.insert(current.bookmark).second) {
+                if (current.bookmark != NULL) LOGD("Cycle in document outline skipped");
+                continue;
+            }
+
+            jint index = (jint) bookmarks.size();
+            bookmarks.push_back(current.bookmark);
+            parents.push_back(current.parent);
+            depths.push_back(current.depth);
+
+            //Sibling is pushed first, so whole subtree of child comes before it
+            Pending sibling = { FPDFBookmark_GetNextSibling(doc->pdfDocument, current.bookmark),
+                                current.parent, current.depth };
+            Pending child = { FPDFBookmark_GetFirstChild(doc->pdfDocument, current.bookmark),
+                              index, current.depth + 1 };
+            stack.push_back(sibling);
+            stack.push_back(child);
+        }
+    }
+
+    jsize count = (jsize) bookmarks.size();
+    std::vector<jlong> pageIndices(count + 1);
+    std::vector<jlong> pointers(count + 1);
+    jobjectArray titles = env->NewObjectArray(count, sJni.stringClass, NULL);
+    if (titles == NULL) return NULL;
+
+    std::wstring buffer;
+    for (jsize i = 0; i < count; i++) {
+        {
+            Mutex::Autolock lock(getLibraryLock());
+            FPDF_DEST dest = FPDFBookmark_GetDest(doc->pdfDocument, bookmarks[i]);
+            pageIndices[i] = dest != NULL
+                    ? (jlong) FPDFDest_GetPageIndex(doc->pdfDocument, dest) : -1;
+        }
+        pointers[i] = reinterpret_cast<jlong>(bookmarks[i]);
+
+        jstring title = getBookmarkTitle(env, bookmarks[i], buffer);
+        env->SetObjectArrayElement(titles, i, title);
+        env->DeleteLocalRef(title);
+    }
+
+    jlongArray pageIndexArray = env->NewLongArray(count);
+    jintArray parentArray = env->NewIntArray(count);
+    jintArray depthArray = env->NewIntArray(count);
+    jlongArray pointerArray = env->NewLongArray(count);
+    jobjectArray result = env->NewObjectArray(5, sJni.objectClass, NULL);
+    if (pageIndexArray == NULL || parentArray == NULL || depthArray == NULL
+            || pointerArray == NULL || result == NULL) {
+        return NULL;
+    }
+    if (count > 0) {
+        env->SetLongArrayRegion(pageIndexArray, 0, count, &pageIndices[0]);
+        env->SetIntArrayRegion(parentArray, 0, count, &parents[0]);
+        env->SetIntArrayRegion(depthArray, 0, count, &depths[0]);
+        env->SetLongArrayRegion(pointerArray, 0, count, &pointers[0]);
+    }
+
+    env->SetObjectArrayElement(result, 0, titles);
+    env->SetObjectArrayElement(result, 1, pageIndexArray);
+    env->SetObjectArrayElement(result, 2, parentArray);
+    env->SetObjectArrayElement(result, 3, depthArray);
+    env->SetObjectArrayElement(result, 4, pointerArray);
+    return result;
+}
+
 JNI_FUNC(jlongArray, PdfiumCore, nativeGetPageLinks)(JNI_ARGS, jlong pagePtr) {
     FPDF_PAGE page = reinterpret_cast<FPDF_PAGE>(pagePtr);
     int pos = 0;
     std::vector<jlong> links;
     FPDF_LINK link;
-    while (FPDFLink_Enumerate(page, &pos, &link)) {
-        links.push_back(reinterpret_cast<jlong>(link));
+    {
+        Mutex::Autolock lock(getLibraryLock());
+        while (FPDFLink_Enumerate(page, &pos, &link)) {
+            links.push_back(reinterpret_cast<jlong>(link));
+        }
     }
 
     jlongArray result = env->NewLongArray(links.size());
@@ -635,57 +1681,315 @@ JNI_FUNC(jlongArray, PdfiumCore, nativeGetPageLinks)(JNI_ARGS, jlong pagePtr) {
     return result;
 }
 
+JNI_FUNC(jobject, PdfiumCore, nativeGetPageLinksPacked)(JNI_ARGS, jlong docPtr, jlong pagePtr) {
+    DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
+    FPDF_PAGE page = reinterpret_cast<FPDF_PAGE>(pagePtr);
+
+    std::vector<jfloat> rects;
+    std::vector<jint> destPageIndices;
+    std::vector<std::string> uris;
+    std::vector<bool> hasUri;
+    std::vector<jint> quadOffsets(1, 0);
+    std::vector<jfloat> quadPoints;
+
+    //Links are collected under the library lock, Java objects are created after it
+    {
+        Mutex::Autolock lock(getLibraryLock());
+        int pos = 0;
+        FPDF_LINK link;
+        while (FPDFLink_Enumerate(page, &pos, &link)) {
+            FS_RECTF rect;
+            if (!FPDFLink_GetAnnotRect(link, &rect)) continue;
+
+            jint destIndex = -1;
+            FPDF_DEST dest = FPDFLink_GetDest(doc->pdfDocument, link);
+            if (dest != NULL) {
+                destIndex = (jint) FPDFDest_GetPageIndex(doc->pdfDocument, dest);
+            }
+
+            FPDF_ACTION action = FPDFLink_GetAction(link);
+            std::string uri;
+            if (action != NULL) {
+                size_t bufferLen = FPDFAction_GetURIPath(doc->pdfDocument, action, NULL, 0);
+                if (bufferLen > 0) {
+                    FPDFAction_GetURIPath(doc->pdfDocument, action, WriteInto(&uri, bufferLen), bufferLen);
+                }
+            }
+            //Same links as getPageLinks, which skips links going nowhere
+            if (dest == NULL && action == NULL) continue;
+
+            rects.push_back(rect.left);
+            rects.push_back(rect.top);
+            rects.push_back(rect.right);
+            rects.push_back(rect.bottom);
+            destPageIndices.push_back(destIndex);
+            uris.push_back(uri);
+            hasUri.push_back(action != NULL);
+
+            int quadCount = FPDFLink_CountQuadPoints(link);
+            int quadsAdded = 0;
+            for (int i = 0; i < quadCount; i++) {
+                FS_QUADPOINTSF quad;
+                if (!FPDFLink_GetQuadPoints(link, i, &quad)) continue;
+                const jfloat points[] = { quad.x1, quad.y1, quad.x2, quad.y2,
+                                          quad.x3, quad.y3, quad.x4, quad.y4 };
+                quadPoints.insert(quadPoints.end(), points, points + 8);
+                quadsAdded++;
+            }
+            quadOffsets.push_back(quadOffsets.back() + quadsAdded);
+        }
+    }
+
+    jsize count = (jsize) destPageIndices.size();
+    jfloatArray rectsArray = env->NewFloatArray(count * 4);
+    jintArray destArray = env->NewIntArray(count);
+    jobjectArray uriArray = env->NewObjectArray(count, sJni.stringClass, NULL);
+    jintArray offsetsArray = env->NewIntArray(count + 1);
+    jfloatArray quadsArray = env->NewFloatArray(quadPoints.size());
+    if (rectsArray == NULL || destArray == NULL || uriArray == NULL || offsetsArray == NULL
+            || quadsArray == NULL) {
+        return NULL;
+    }
+
+    if (count > 0) {
+        env->SetFloatArrayRegion(rectsArray, 0, count * 4, &rects[0]);
+        env->SetIntArrayRegion(destArray, 0, count, &destPageIndices[0]);
+    }
+    env->SetIntArrayRegion(offsetsArray, 0, count + 1, &quadOffsets[0]);
+    if (!quadPoints.empty()) {
+        env->SetFloatArrayRegion(quadsArray, 0, quadPoints.size(), &quadPoints[0]);
+    }
+    for (jsize i = 0; i < count; i++) {
+        if (!hasUri[i]) continue;
+        jstring uri = env->NewStringUTF(uris[i].c_str());
+        env->SetObjectArrayElement(uriArray, i, uri);
+        env->DeleteLocalRef(uri);
+    }
+
+    return env->NewObject(sJni.pageLinksClass, sJni.pageLinksInit, rectsArray, destArray,
+                          uriArray, offsetsArray, quadsArray);
+}
+
 JNI_FUNC(jobject, PdfiumCore, nativeGetDestPageIndex)(JNI_ARGS, jlong docPtr, jlong linkPtr) {
     DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
     FPDF_LINK link = reinterpret_cast<FPDF_LINK>(linkPtr);
-    FPDF_DEST dest = FPDFLink_GetDest(doc->pdfDocument, link);
-    if (dest == NULL) {
-        return NULL;
+    unsigned long index;
+    {
+        Mutex::Autolock lock(getLibraryLock());
+        FPDF_DEST dest = FPDFLink_GetDest(doc->pdfDocument, link);
+        if (dest == NULL) {
+            return NULL;
+        }
+        index = FPDFDest_GetPageIndex(doc->pdfDocument, dest);
     }
-    unsigned long index = FPDFDest_GetPageIndex(doc->pdfDocument, dest);
     return NewInteger(env, (jint) index);
 }
 
 JNI_FUNC(jstring, PdfiumCore, nativeGetLinkURI)(JNI_ARGS, jlong docPtr, jlong linkPtr){
     DocumentFile *doc = reinterpret_cast<DocumentFile*>(docPtr);
     FPDF_LINK link = reinterpret_cast<FPDF_LINK>(linkPtr);
-    FPDF_ACTION action = FPDFLink_GetAction(link);
-    if (action == NULL) {
-        return NULL;
+    size_t bufferLen;
+    std::string uri;
+    {
+        Mutex::Autolock lock(getLibraryLock());
+        FPDF_ACTION action = FPDFLink_GetAction(link);
+        if (action == NULL) {
+            return NULL;
+        }
+        bufferLen = FPDFAction_GetURIPath(doc->pdfDocument, action, NULL, 0);
+        if (bufferLen > 0) {
+            FPDFAction_GetURIPath(doc->pdfDocument, action, WriteInto(&uri, bufferLen), bufferLen);
+        }
     }
-    size_t bufferLen = FPDFAction_GetURIPath(doc->pdfDocument, action, NULL, 0);
     if (bufferLen <= 0) {
         return env->NewStringUTF("");
     }
-    std::string uri;
-    FPDFAction_GetURIPath(doc->pdfDocument, action, WriteInto(&uri, bufferLen), bufferLen);
     return env->NewStringUTF(uri.c_str());
 }
 
 JNI_FUNC(jobject, PdfiumCore, nativeGetLinkRect)(JNI_ARGS, jlong linkPtr) {
     FPDF_LINK link = reinterpret_cast<FPDF_LINK>(linkPtr);
     FS_RECTF fsRectF;
-    FPDF_BOOL result = FPDFLink_GetAnnotRect(link, &fsRectF);
+    FPDF_BOOL result;
+    {
+        Mutex::Autolock lock(getLibraryLock());
+        result = FPDFLink_GetAnnotRect(link, &fsRectF);
+    }
 
     if (!result) {
         return NULL;
     }
 
-    jclass clazz = env->FindClass("android/graphics/RectF");
-    jmethodID constructorID = env->GetMethodID(clazz, "<init>", "(FFFF)V");
-    return env->NewObject(clazz, constructorID, fsRectF.left, fsRectF.top, fsRectF.right, fsRectF.bottom);
+    return env->NewObject(sJni.rectFClass, sJni.rectFInit,
+                          fsRectF.left, fsRectF.top, fsRectF.right, fsRectF.bottom);
 }
 
 JNI_FUNC(jobject, PdfiumCore, nativePageCoordsToDevice)(JNI_ARGS, jlong pagePtr, jint startX, jint startY, jint sizeX,
                                             jint sizeY, jint rotate, jdouble pageX, jdouble pageY) {
     FPDF_PAGE page = reinterpret_cast<FPDF_PAGE>(pagePtr);
     int deviceX, deviceY;
+    {
+        Mutex::Autolock lock(getLibraryLock());
+        FPDF_PageToDevice(page, startX, startY, sizeX, sizeY, rotate, pageX, pageY,
+                          &deviceX, &deviceY);
+    }
+
+    return env->NewObject(sJni.pointClass, sJni.pointInit, deviceX, deviceY);
+}
 
-    FPDF_PageToDevice(page, startX, startY, sizeX, sizeY, rotate, pageX, pageY, &deviceX, &deviceY);
+//Maps x, y pairs, or left, top, right, bottom rects, with one transform for the whole batch
+static void mapCoords(JNIEnv *env, jlong pagePtr, jint startX, jint startY, jint sizeX, jint sizeY,
+                      jint rotate, jfloatArray coords, jfloatArray out, jboolean rects,
+                      bool toDevice) {
+    FPDF_PAGE page = reinterpret_cast<FPDF_PAGE>(pagePtr);
+    jsize length = env->GetArrayLength(coords);
+    if (env->GetArrayLength(out) < length) {
+        jniThrowException(env, "java/lang/IllegalArgumentException", "Output array too small");
+        return;
+    }
 
-    jclass clazz = env->FindClass("android/graphics/Point");
-    jmethodID constructorID = env->GetMethodID(clazz, "<init>", "(II)V");
-    return env->NewObject(clazz, constructorID, deviceX, deviceY);
+    PageTransform pageToDevice, deviceToPage;
+    bool valid;
+    {
+        //Transform is derived from PDFium once, applying it does not need the lock
+        Mutex::Autolock lock(getLibraryLock());
+        valid = PageTransform::fromViewport(page, startX, startY, sizeX, sizeY, rotate,
+                                            &pageToDevice, &deviceToPage);
+    }
+    if (!valid) {
+        jniThrowException(env, "java/lang/IllegalArgumentException", "Invalid page or viewport");
+        return;
+    }
+
+    size_t pointCount = length / 2;
+    if (pointCount == 0) return;
+    std::vector<float> buffer(pointCount * 2);
+    env->GetFloatArrayRegion(coords, 0, pointCount * 2, buffer.data());
+
+    (toDevice ? pageToDevice : deviceToPage).apply(buffer.data(), buffer.data(), pointCount);
+    if (rects) normalizeRects(buffer.data(), pointCount / 2);
+
+    env->SetFloatArrayRegion(out, 0, pointCount * 2, buffer.data());
+}
+
+JNI_FUNC(void, PdfiumCore, nativeMapPageCoordsToDevice)(JNI_ARGS, jlong pagePtr, jint startX, jint startY,
+                                            jint sizeX, jint sizeY, jint rotate,
+                                            jfloatArray coords, jfloatArray out, jboolean rects) {
+    mapCoords(env, pagePtr, startX, startY, sizeX, sizeY, rotate, coords, out, rects, true);
+}
+
+JNI_FUNC(void, PdfiumCore, nativeMapDeviceCoordsToPage)(JNI_ARGS, jlong pagePtr, jint startX, jint startY,
+                                            jint sizeX, jint sizeY, jint rotate,
+                                            jfloatArray coords, jfloatArray out, jboolean rects) {
+    mapCoords(env, pagePtr, startX, startY, sizeX, sizeY, rotate, coords, out, rects, false);
 }
 
 }//extern C
+
+//Every native of PdfiumCore, bound explicitly instead of by symbol lookup on first call
+static const JNINativeMethod sPdfiumCoreMethods[] = {
+    JNI_METHOD(PdfiumCore, nativeOpenDocument, "(ILjava/lang/String;IIII)J"),
+    JNI_METHOD(PdfiumCore, nativeGetBlockCacheStats, "(J)[J"),
+    JNI_METHOD(PdfiumCore, nativeSetDocumentPoolLimits, "(IJ)V"),
+    JNI_METHOD(PdfiumCore, nativeTrimDocumentPool, "(Z)V"),
+    JNI_METHOD(PdfiumCore, nativeGetDocumentPoolStats, "()[J"),
+    JNI_METHOD(PdfiumCore, nativeOpenProgressiveDocument, "(IJLjava/lang/String;)J"),
+    JNI_METHOD(PdfiumCore, nativeUpdateDocumentAvailability, "(JJ)I"),
+    JNI_METHOD(PdfiumCore, nativeIsPageAvailable, "(JI)I"),
+    JNI_METHOD(PdfiumCore, nativeIsLinearized, "(J)I"),
+    JNI_METHOD(PdfiumCore, nativeGetFirstAvailablePage, "(J)I"),
+    JNI_METHOD(PdfiumCore, nativeGetNeededRanges, "(J)[J"),
+    JNI_METHOD(PdfiumCore, nativeOpenMemDocument, "([BLjava/lang/String;)J"),
+    JNI_METHOD(PdfiumCore, nativeOpenDirectBufferDocument, "(Ljava/nio/ByteBuffer;Ljava/lang/String;)J"),
+    JNI_METHOD(PdfiumCore, nativeOpenDataSourceDocument, "(Lcom/shockwave/pdfium/PdfDataSource;JLjava/lang/String;III)J"),
+    JNI_METHOD(PdfiumCore, nativeCloseDocument, "(J)V"),
+    JNI_METHOD(PdfiumCore, nativeGetPageCount, "(J)I"),
+    JNI_METHOD(PdfiumCore, nativeLoadPage, "(JI)J"),
+    JNI_METHOD(PdfiumCore, nativeLoadPages, "(JII)[J"),
+    JNI_METHOD(PdfiumCore, nativeClosePage, "(J)V"),
+    JNI_METHOD(PdfiumCore, nativeClosePages, "([J)V"),
+    JNI_METHOD(PdfiumCore, nativeGetPageWidthPixel, "(JI)I"),
+    JNI_METHOD(PdfiumCore, nativeGetPageHeightPixel, "(JI)I"),
+    JNI_METHOD(PdfiumCore, nativeGetPageWidthPoint, "(J)I"),
+    JNI_METHOD(PdfiumCore, nativeGetPageHeightPoint, "(J)I"),
+    JNI_METHOD(PdfiumCore, nativeRenderPage, "(JLandroid/view/Surface;IIIIIZ)V"),
+    JNI_METHOD(PdfiumCore, nativeRenderPageBitmap, "(JLandroid/graphics/Bitmap;IIIIIZZI)V"),
+    JNI_METHOD(PdfiumCore, nativeRenderPageBitmapCached, "(JIJLandroid/graphics/Bitmap;IIIIZZI)V"),
+    JNI_METHOD(PdfiumCore, nativeSetTileCacheBudget, "(J)V"),
+    JNI_METHOD(PdfiumCore, nativeClearTileCache, "()V"),
+    JNI_METHOD(PdfiumCore, nativeGetTileCacheStats, "()[J"),
+    JNI_METHOD(PdfiumCore, nativeStartRenderJob, "(JILandroid/graphics/Bitmap;IIIIZI)J"),
+    JNI_METHOD(PdfiumCore, nativeContinueRenderJob, "(J)I"),
+    JNI_METHOD(PdfiumCore, nativeCancelRenderJob, "(J)V"),
+    JNI_METHOD(PdfiumCore, nativeRenderJobToBitmap, "(JLandroid/graphics/Bitmap;)Z"),
+    JNI_METHOD(PdfiumCore, nativeCloseRenderJob, "(J)V"),
+    JNI_METHOD(PdfiumCore, nativeOpenFrameScheduler, "()J"),
+    JNI_METHOD(PdfiumCore, nativeCloseFrameScheduler, "(J)V"),
+    JNI_METHOD(PdfiumCore, nativeRenderFrame, "(J[JJ[I)I"),
+    JNI_METHOD(PdfiumCore, nativeGetFrameTrace, "(J)[J"),
+    JNI_METHOD(PdfiumCore, nativeResetFrameTrace, "(J)V"),
+    JNI_METHOD(PdfiumCore, nativeOpenRenderScheduler, "(JILcom/shockwave/pdfium/RenderCallback;)J"),
+    JNI_METHOD(PdfiumCore, nativeCloseRenderScheduler, "(J)V"),
+    JNI_METHOD(PdfiumCore, nativeSubmitRender, "(JILandroid/graphics/Bitmap;IIIIZZI)J"),
+    JNI_METHOD(PdfiumCore, nativeCancelRender, "(JJ)Z"),
+    JNI_METHOD(PdfiumCore, nativeRenderThumbnailAtlas, "(JLandroid/graphics/Bitmap;IIIIZZ)[I"),
+    JNI_METHOD(PdfiumCore, nativeGetDocumentFingerprint, "(J)Ljava/lang/String;"),
+    JNI_METHOD(PdfiumCore, nativeGetAllPageSizes, "(J)[F"),
+    JNI_METHOD(PdfiumCore, nativeGetPageGeometry, "(JLjava/lang/String;)[F"),
+    JNI_METHOD(PdfiumCore, nativeExtractText, "(JIILcom/shockwave/pdfium/PageTextCallback;)I"),
+    JNI_METHOD(PdfiumCore, nativeOpenTextSearch, "(Ljava/lang/String;ZZ)J"),
+    JNI_METHOD(PdfiumCore, nativeSearchText, "(JJIILcom/shockwave/pdfium/SearchCallback;)I"),
+    JNI_METHOD(PdfiumCore, nativeCancelTextSearch, "(J)V"),
+    JNI_METHOD(PdfiumCore, nativeCloseTextSearch, "(J)V"),
+    JNI_METHOD(PdfiumCore, nativeWriteTextIndex, "(JLjava/lang/String;)Z"),
+    JNI_METHOD(PdfiumCore, nativeOpenTextIndex, "(JLjava/lang/String;)J"),
+    JNI_METHOD(PdfiumCore, nativeSearchTextIndex, "(JLjava/lang/String;I)[I"),
+    JNI_METHOD(PdfiumCore, nativeCloseTextIndex, "(J)V"),
+    JNI_METHOD(PdfiumCore, nativeWriteThumbnailStore, "(JLjava/lang/String;IIZZ)Z"),
+    JNI_METHOD(PdfiumCore, nativeOpenThumbnailStore, "(JLjava/lang/String;)J"),
+    JNI_METHOD(PdfiumCore, nativeIsThumbnailStoreRgb565, "(J)Z"),
+    JNI_METHOD(PdfiumCore, nativeGetThumbnailSizes, "(J)[I"),
+    JNI_METHOD(PdfiumCore, nativeThumbnailToBitmap, "(JILandroid/graphics/Bitmap;)Z"),
+    JNI_METHOD(PdfiumCore, nativeCloseThumbnailStore, "(J)V"),
+    JNI_METHOD(PdfiumCore, nativeGetDocumentMetaText, "(JLjava/lang/String;)Ljava/lang/String;"),
+    JNI_METHOD(PdfiumCore, nativeGetFirstChildBookmark, "(JLjava/lang/Long;)Ljava/lang/Long;"),
+    JNI_METHOD(PdfiumCore, nativeGetSiblingBookmark, "(JJ)Ljava/lang/Long;"),
+    JNI_METHOD(PdfiumCore, nativeGetBookmarkTitle, "(J)Ljava/lang/String;"),
+    JNI_METHOD(PdfiumCore, nativeGetBookmarkDestIndex, "(JJ)J"),
+    JNI_METHOD(PdfiumCore, nativeGetPageSizeByIndex, "(JII)Lcom/shockwave/pdfium/util/Size;"),
+    JNI_METHOD(PdfiumCore, nativeGetTableOfContents, "(J)[Ljava/lang/Object;"),
+    JNI_METHOD(PdfiumCore, nativeGetPageLinks, "(J)[J"),
+    JNI_METHOD(PdfiumCore, nativeGetPageLinksPacked, "(JJ)Lcom/shockwave/pdfium/PageLinks;"),
+    JNI_METHOD(PdfiumCore, nativeGetDestPageIndex, "(JJ)Ljava/lang/Integer;"),
+    JNI_METHOD(PdfiumCore, nativeGetLinkURI, "(JJ)Ljava/lang/String;"),
+    JNI_METHOD(PdfiumCore, nativeGetLinkRect, "(J)Landroid/graphics/RectF;"),
+    JNI_METHOD(PdfiumCore, nativePageCoordsToDevice, "(JIIIIIDD)Landroid/graphics/Point;"),
+    JNI_METHOD(PdfiumCore, nativeMapPageCoordsToDevice, "(JIIIII[F[FZ)V"),
+    JNI_METHOD(PdfiumCore, nativeMapDeviceCoordsToPage, "(JIIIII[F[FZ)V"),
+};
+
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *reserved) {
+    JNIEnv *env = NULL;
+    if (vm->GetEnv((void**) &env, JNI_VERSION_1_6) != JNI_OK) {
+        return JNI_ERR;
+    }
+
+    if (!cacheClasses(env)) {
+        LOGE("Cannot resolve classes used by native code");
+        return JNI_ERR;
+    }
+
+    jclass coreClass = env->FindClass("com/shockwave/pdfium/PdfiumCore");
+    if (coreClass == NULL) {
+        LOGE("Unable to find class PdfiumCore");
+        return JNI_ERR;
+    }
+    jint methodCount = sizeof(sPdfiumCoreMethods) / sizeof(sPdfiumCoreMethods[0]);
+    if (env->RegisterNatives(coreClass, sPdfiumCoreMethods, methodCount) != JNI_OK) {
+        LOGE("Cannot register natives of PdfiumCore");
+        return JNI_ERR;
+    }
+    env->DeleteLocalRef(coreClass);
+
+    return JNI_VERSION_1_6;
+}
@@ -0,0 +1,105 @@
+#include "util.hpp"
+#include "pageBitmap.hpp"
+#include "bitmapUtil.hpp"
+#include "documentFile.hpp"
+
+#include <stdlib.h>
+
+/**
+ * Render rows [bandY, bandY + bitmap height) of canvas into pdfBitmap,
+ * page is drawn as if bitmap covered the whole canvas.
+ */
+static void renderBitmapBand(FPDF_PAGE page, FPDF_BITMAP pdfBitmap, int bandY,
+                             int canvasHorSize, int canvasVerSize,
+                             int startX, int startY, int drawSizeHor, int drawSizeVer,
+                             int flags){
+    int bandHeight = FPDFBitmap_GetHeight(pdfBitmap);
+
+    if(drawSizeHor < canvasHorSize || drawSizeVer < canvasVerSize){
+        FPDFBitmap_FillRect( pdfBitmap, 0, 0, canvasHorSize, bandHeight,
+                             0x848484FF); //Gray
+    }
+
+    int baseHorSize = (canvasHorSize < drawSizeHor)? canvasHorSize : drawSizeHor;
+    int baseVerSize = (canvasVerSize < drawSizeVer)? canvasVerSize : drawSizeVer;
+    int baseX = (startX < 0)? 0 : startX;
+    int baseY = (startY < 0)? 0 : startY;
+
+    FPDFBitmap_FillRect( pdfBitmap, baseX, baseY - bandY, baseHorSize, baseVerSize,
+                         0xFFFFFFFF); //White
+
+    FPDF_RenderPageBitmap( pdfBitmap, page,
+                           startX, startY - bandY,
+                           drawSizeHor, drawSizeVer,
+                           0, flags );
+}
+
+void renderPageBitmapInternal(FPDF_PAGE page, void *addr, const AndroidBitmapInfo &info,
+                              int startX, int startY, int drawSizeHor, int drawSizeVer,
+                              int flags, bool dither, int bandSize){
+    int canvasHorSize = info.width;
+    int canvasVerSize = info.height;
+
+    /*LOGD("Start X: %d", startX);
+    LOGD("Start Y: %d", startY);
+    LOGD("Canvas Hor: %d", canvasHorSize);
+    LOGD("Canvas Ver: %d", canvasVerSize);
+    LOGD("Draw Hor: %d", drawSizeHor);
+    LOGD("Draw Ver: %d", drawSizeVer);*/
+
+    if (info.format != ANDROID_BITMAP_FORMAT_RGB_565) {
+        renderPageBuffer(page, addr, info.stride, canvasHorSize, canvasVerSize, false,
+                         startX, startY, drawSizeHor, drawSizeVer, flags);
+        return;
+    }
+
+    //Render strips of bandHeight rows into small scratch buffer and convert each one
+    //straight into bitmap pixels, instead of allocating BGR copy of whole bitmap
+    int sourceStride = canvasHorSize * sizeof(rgb);
+    int bandHeight = canvasVerSize;
+    if (bandSize > 0) {
+        bandHeight = bandSize / sourceStride;
+        if (bandHeight < 1) bandHeight = 1;
+        if (bandHeight > canvasVerSize) bandHeight = canvasVerSize;
+    }
+
+    void *tmp = malloc((size_t)bandHeight * sourceStride);
+    if (tmp == NULL) {
+        LOGE("Cannot allocate band buffer");
+        return;
+    }
+
+    for (int bandY = 0; bandY < canvasVerSize; bandY += bandHeight) {
+        int height = (bandY + bandHeight > canvasVerSize)? canvasVerSize - bandY : bandHeight;
+        {
+            //Conversion of previous band does not need PDFium, only rendering is locked
+            android::Mutex::Autolock lock(getLibraryLock());
+            FPDF_BITMAP pdfBitmap = FPDFBitmap_CreateEx( canvasHorSize, height,
+                                                         FPDFBitmap_BGR, tmp, sourceStride);
+            renderBitmapBand(page, pdfBitmap, bandY,
+                             canvasHorSize, canvasVerSize,
+                             startX, startY, drawSizeHor, drawSizeVer, flags);
+            FPDFBitmap_Destroy(pdfBitmap);
+        }
+
+        void *dest = (char*) addr + (size_t)bandY * info.stride;
+        if (dither) {
+            rgbBitmapTo565Dither(tmp, sourceStride, dest, info.stride,
+                                 canvasHorSize, height, 0, bandY);
+        } else {
+            rgbBitmapTo565(tmp, sourceStride, dest, info.stride, canvasHorSize, height);
+        }
+    }
+    free(tmp);
+}
+
+void renderPageBuffer(FPDF_PAGE page, void *buffer, int stride, int width, int height, bool rgb,
+                      int startX, int startY, int drawSizeHor, int drawSizeVer, int flags){
+    android::Mutex::Autolock lock(getLibraryLock());
+    FPDF_BITMAP pdfBitmap = FPDFBitmap_CreateEx( width, height,
+                                                 rgb ? FPDFBitmap_BGR : FPDFBitmap_BGRA,
+                                                 buffer, stride);
+    renderBitmapBand(page, pdfBitmap, 0, width, height,
+                     startX, startY, drawSizeHor, drawSizeVer, flags);
+    FPDFBitmap_Destroy(pdfBitmap);
+}
@@ -0,0 +1,23 @@
+#ifndef _PAGE_BITMAP_HPP_
+#define _PAGE_BITMAP_HPP_
+
+#include <android/bitmap.h>
+#include <fpdfview.h>
+
+/**
+ * Render page fragment into locked pixels of RGBA_8888 or RGB_565 bitmap.
+ * RGB_565 is rendered in bands of at most bandSize bytes, 0 renders it at once.
+ * Takes the library lock around PDFium calls, so caller must not hold it.
+ */
+void renderPageBitmapInternal(FPDF_PAGE page, void *addr, const AndroidBitmapInfo &info,
+                              int startX, int startY, int drawSizeHor, int drawSizeVer,
+                              int flags, bool dither, int bandSize);
+
+/**
+ * Render page fragment into buffer of width x height pixels, in pixel layout of RGBA_8888
+ * bitmap, or BGR for conversion to RGB_565 when rgb is true. Takes the library lock.
+ */
+void renderPageBuffer(FPDF_PAGE page, void *buffer, int stride, int width, int height, bool rgb,
+                      int startX, int startY, int drawSizeHor, int drawSizeVer, int flags);
+
+#endif
@@ -0,0 +1,122 @@
+#include "util.hpp"
+#include "pageGeometry.hpp"
+
+#include <fpdf_edit.h>
+
+extern "C" {
+    #include <string.h>
+}
+
+static const char GEOMETRY_MAGIC[4] = { 'P', 'D', 'G', 'I' };
+static const uint32_t GEOMETRY_VERSION = 1;
+
+static void measurePage(FPDF_DOCUMENT pdfDocument, int pageIndex, PageGeometry::Page *out) {
+    double width, height;
+    if (!FPDF_GetPageSizeByIndex(pdfDocument, pageIndex, &width, &height)) {
+        width = 0;
+        height = 0;
+    }
+    out->width = (float) width;
+    out->height = (float) height;
+    out->rotation = 0;
+
+    FPDF_PAGE page = FPDF_LoadPage(pdfDocument, pageIndex);
+    if (page == NULL) {
+        LOGE("Cannot load page %d for geometry", pageIndex);
+        return;
+    }
+    out->rotation = FPDFPage_GetRotation(page);
+    FPDF_ClosePage(page);
+}
+
+void PageGeometry::computeSizes(FPDF_DOCUMENT pdfDocument, float *out, int pageCount) {
+    for (int i = 0; i < pageCount; i++) {
+        double width, height;
+        if (!FPDF_GetPageSizeByIndex(pdfDocument, i, &width, &height)) {
+            width = 0;
+            height = 0;
+        }
+        out[i * 2] = (float) width;
+        out[i * 2 + 1] = (float) height;
+    }
+}
+
+PageGeometry* PageGeometry::compute(DocumentFile *doc) {
+    int count;
+    {
+        android::Mutex::Autolock lock(getLibraryLock());
+        count = FPDF_GetPageCount(doc->pdfDocument);
+    }
+    if (count < 0) return NULL;
+
+    PageGeometry *geometry = new PageGeometry();
+    geometry->computed.resize(count);
+    geometry->pageCount = count;
+    geometry->pages = count > 0 ? &geometry->computed[0] : NULL;
+    if (count == 0) return geometry;
+
+    android::Mutex::Autolock lock(getLibraryLock());
+    for (int i = 0; i < count; i++) {
+        measurePage(doc->pdfDocument, i, &geometry->computed[i]);
+    }
+    return geometry;
+}
+
+PageGeometry* PageGeometry::open(DocumentFile *doc, const char *path) {
+    DocumentFingerprint fingerprint;
+    if (!computeFingerprint(doc, &fingerprint)) return NULL;
+
+    int documentPageCount;
+    {
+        android::Mutex::Autolock lock(getLibraryLock());
+        documentPageCount = doc->pdfDocument != NULL ? FPDF_GetPageCount(doc->pdfDocument) : -1;
+    }
+    if (documentPageCount < 0) return NULL;
+
+    PageGeometry *geometry = new PageGeometry();
+    if (!geometry->file.open(path) || geometry->file.size() < sizeof(Header)) {
+        delete geometry;
+        return NULL;
+    }
+
+    //Table size is computed in 64 bits, size_t product wraps on 32-bit devices
+    uint64_t fileSize = geometry->file.size();
+    const Header *header = reinterpret_cast<const Header*>(geometry->file.data());
+    if (memcmp(header->magic, GEOMETRY_MAGIC, sizeof(header->magic)) != 0
+            || header->version != GEOMETRY_VERSION
+            || header->fileSize != fingerprint.fileSize || header->hash != fingerprint.hash
+            || header->entrySize != sizeof(Page)
+            || header->pageCount != (uint32_t)documentPageCount
+            || (uint64_t)header->pageCount * sizeof(Page) != fileSize - sizeof(Header)) {
+        LOGD("Page geometry %s does not match document", path);
+        delete geometry;
+        return NULL;
+    }
+
+    geometry->pageCount = (int) header->pageCount;
+    geometry->pages = reinterpret_cast<const Page*>(geometry->file.data() + sizeof(Header));
+    return geometry;
+}
+
+bool PageGeometry::write(DocumentFile *doc, const char *path) const {
+    DocumentFingerprint fingerprint;
+    if (!computeFingerprint(doc, &fingerprint)) {
+        LOGE("Cannot compute document fingerprint");
+        return false;
+    }
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GEOMETRY_MAGIC, sizeof(header.magic));
+    header.version = GEOMETRY_VERSION;
+    header.fileSize = fingerprint.fileSize;
+    header.hash = fingerprint.hash;
+    header.pageCount = pageCount;
+    header.entrySize = sizeof(Page);
+
+    SidecarWriter writer;
+    if (!writer.open(path)) return false;
+    if (!writer.write(&header, sizeof(header))) return false;
+    if (pageCount > 0 && !writer.write(pages, (size_t)pageCount * sizeof(Page))) return false;
+    return writer.commit();
+}
@@ -0,0 +1,59 @@
+#ifndef _PAGE_GEOMETRY_HPP_
+#define _PAGE_GEOMETRY_HPP_
+
+#include "documentFile.hpp"
+#include "sidecar.hpp"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Size in points, with rotation applied, and rotation of every page of document.
+ * Rotation is known only after page is loaded, so table is computed once and
+ * persisted in sidecar file (header followed by one entry per page), which is
+ * memory mapped when document is opened again.
+ */
+class PageGeometry {
+    public:
+    struct Page {
+        float width;
+        float height;
+        //Clockwise quarter turns, as returned by FPDFPage_GetRotation
+        int32_t rotation;
+    };
+
+    /**
+     * Fill width and height in points of pages [0, pageCount) into out, without loading
+     * pages. Lookups are cheap and PDFium is serialized anyway, so it runs on the calling
+     * thread, which must hold the library lock.
+     */
+    static void computeSizes(FPDF_DOCUMENT pdfDocument, float *out, int pageCount);
+    /** Load every page on the calling thread */
+    static PageGeometry* compute(DocumentFile *doc);
+    /** Map sidecar, returns NULL if file is missing, corrupted or made for other document */
+    static PageGeometry* open(DocumentFile *doc, const char *path);
+
+    bool write(DocumentFile *doc, const char *path) const;
+
+    int getPageCount() const { return pageCount; }
+    const Page* getPages() const { return pages; }
+
+    private:
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t fileSize;
+        uint64_t hash;
+        uint32_t pageCount;
+        uint32_t entrySize;
+    };
+
+    PageGeometry() {}
+
+    std::vector<Page> computed;
+    MappedFile file;
+    const Page *pages = NULL;
+    int pageCount = 0;
+};
+
+#endif
@@ -0,0 +1,99 @@
+#include "util.hpp"
+#include "progressiveLoader.hpp"
+
+#include <algorithm>
+#include <utility>
+
+ProgressiveLoader::ProgressiveLoader(const DocumentFile *doc)
+    : fileSize(doc->fileSize), availableBytes(0) {
+    doc->fillLoader(&loader);
+
+    fileAvail.version = 1;
+    fileAvail.IsDataAvail = &isDataAvail;
+    fileAvail.owner = this;
+
+    hints.version = 1;
+    hints.AddSegment = &addSegment;
+    hints.owner = this;
+
+    {
+        android::Mutex::Autolock lock(getLibraryLock());
+        avail = FPDFAvail_Create(&fileAvail, &loader);
+    }
+    if (avail == NULL) {
+        LOGE("Cannot create availability provider");
+    }
+}
+
+ProgressiveLoader::~ProgressiveLoader() {
+    if (avail != NULL) {
+        android::Mutex::Autolock lock(getLibraryLock());
+        FPDFAvail_Destroy(avail);
+    }
+}
+
+void ProgressiveLoader::setAvailableBytes(uint64_t bytes) {
+    availableBytes = bytes < fileSize ? bytes : fileSize;
+}
+
+FPDF_BOOL ProgressiveLoader::isDataAvail(FX_FILEAVAIL *pThis, size_t offset, size_t size) {
+    const ProgressiveLoader *owner = static_cast<FileAvail*>(pThis)->owner;
+    uint64_t available = owner->availableBytes;
+    return offset <= available && size <= available - offset;
+}
+
+void ProgressiveLoader::addSegment(FX_DOWNLOADHINTS *pThis, size_t offset, size_t size) {
+    ProgressiveLoader *owner = static_cast<DownloadHints*>(pThis)->owner;
+    owner->segments.push_back(offset);
+    owner->segments.push_back(size);
+}
+
+int ProgressiveLoader::isDocumentAvailable() {
+    android::Mutex::Autolock lock(getLibraryLock());
+    segments.clear();
+    return FPDFAvail_IsDocAvail(avail, &hints);
+}
+
+int ProgressiveLoader::isPageAvailable(int pageIndex) {
+    android::Mutex::Autolock lock(getLibraryLock());
+    segments.clear();
+    return FPDFAvail_IsPageAvail(avail, pageIndex, &hints);
+}
+
+int ProgressiveLoader::isLinearized() {
+    android::Mutex::Autolock lock(getLibraryLock());
+    return FPDFAvail_IsLinearized(avail);
+}
+
+FPDF_DOCUMENT ProgressiveLoader::loadDocument(const char *password) {
+    return FPDFAvail_GetDocument(avail, password);
+}
+
+std::vector<uint64_t> ProgressiveLoader::getNeededRanges() const {
+    //Hints are not exact and may overlap or cover data which already arrived
+    std::vector<std::pair<uint64_t, uint64_t> > ranges;
+    uint64_t available = availableBytes;
+    //Segments are filled by PDFium callbacks under the library lock
+    android::Mutex::Autolock lock(getLibraryLock());
+    for (size_t i = 0; i + 1 < segments.size(); i += 2) {
+        uint64_t start = std::max(segments[i], available);
+        uint64_t end = std::min(segments[i] + segments[i + 1], fileSize);
+        if (start < end) {
+            ranges.push_back(std::make_pair(start, end));
+        }
+    }
+    std::sort(ranges.begin(), ranges.end());
+
+    std::vector<uint64_t> result;
+    for (size_t i = 0; i < ranges.size(); i++) {
+        size_t count = result.size();
+        if (count > 0 && ranges[i].first <= result[count - 2] + result[count - 1]) {
+            uint64_t end = std::max(result[count - 2] + result[count - 1], ranges[i].second);
+            result[count - 1] = end - result[count - 2];
+        } else {
+            result.push_back(ranges[i].first);
+            result.push_back(ranges[i].second - ranges[i].first);
+        }
+    }
+    return result;
+}
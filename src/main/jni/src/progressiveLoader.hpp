@@ -0,0 +1,66 @@
+#ifndef _PROGRESSIVE_LOADER_HPP_
+#define _PROGRESSIVE_LOADER_HPP_
+
+#include "documentFile.hpp"
+
+#include <fpdfview.h>
+#include <fpdf_dataavail.h>
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * Availability provider of document which is still being written to its file,
+ * e.g. by downloader. Bytes below available count are considered present,
+ * ranges PDFium needs next are collected from download hints of the last check.
+ * Owned by DocumentFile and destroyed after its FPDF_DOCUMENT is closed.
+ */
+class ProgressiveLoader {
+    public:
+    /** Reads through loader of doc, which must use plain file access */
+    ProgressiveLoader(const DocumentFile *doc);
+    ~ProgressiveLoader();
+
+    bool isValid() const { return avail != NULL; }
+
+    void setAvailableBytes(uint64_t bytes);
+    uint64_t getAvailableBytes() const { return availableBytes; }
+    bool isComplete() const { return availableBytes >= fileSize; }
+
+    //Checks and needed ranges take the library lock, loadDocument expects caller to hold it
+
+    /** PDF_DATA_* of document header, trailer and first page */
+    int isDocumentAvailable();
+    /** PDF_DATA_* of page, document must be loaded */
+    int isPageAvailable(int pageIndex);
+    /** PDF_LINEARIZED, PDF_NOT_LINEARIZED or PDF_LINEARIZATION_UNKNOWN */
+    int isLinearized();
+    /** Load document once isDocumentAvailable returned PDF_DATA_AVAIL, under library lock */
+    FPDF_DOCUMENT loadDocument(const char *password);
+
+    /** Offset and size pairs reported by last check, sorted and merged */
+    std::vector<uint64_t> getNeededRanges() const;
+
+    private:
+    struct FileAvail : FX_FILEAVAIL {
+        ProgressiveLoader *owner;
+    };
+    struct DownloadHints : FX_DOWNLOADHINTS {
+        ProgressiveLoader *owner;
+    };
+
+    static FPDF_BOOL isDataAvail(FX_FILEAVAIL *pThis, size_t offset, size_t size);
+    static void addSegment(FX_DOWNLOADHINTS *pThis, size_t offset, size_t size);
+
+    //PDFium keeps pointers to these for the life of avail
+    FPDF_FILEACCESS loader;
+    FileAvail fileAvail;
+    DownloadHints hints;
+    FPDF_AVAIL avail = NULL;
+
+    uint64_t fileSize;
+    std::atomic<uint64_t> availableBytes;
+    std::vector<uint64_t> segments;
+};
+
+#endif
@@ -0,0 +1,124 @@
+#include "util.hpp"
+#include "renderJob.hpp"
+#include "documentFile.hpp"
+#include "bitmapUtil.hpp"
+
+extern "C" {
+    #include <string.h>
+    #include <time.h>
+}
+
+static int64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+RenderJob::RenderJob(FPDF_DOCUMENT pdfDocument, int pageIndex, bool rgb565,
+                     int canvasHorSize, int canvasVerSize,
+                     int startX, int startY, int drawSizeHor, int drawSizeVer,
+                     int flags, int64_t sliceBudgetNs)
+    : pdfDocument(pdfDocument), pageIndex(pageIndex), rgb565(rgb565),
+      canvasHorSize(canvasHorSize), canvasVerSize(canvasVerSize),
+      startX(startX), startY(startY), drawSizeHor(drawSizeHor), drawSizeVer(drawSizeVer),
+      flags(flags), sliceBudgetNs(sliceBudgetNs), cancelled(false) {
+
+    pause.version = 1;
+    pause.NeedToPauseNow = &RenderJob::needToPauseNow;
+    pause.user = this;
+
+    stride = canvasHorSize * (rgb565 ? sizeof(rgb) : 4);
+    buffer.resize((size_t)stride * canvasVerSize);
+}
+
+RenderJob::~RenderJob() {
+    android::Mutex::Autolock lock(getLibraryLock());
+    if(started && page != NULL){
+        FPDF_RenderPage_Close(page);
+    }
+    if(page != NULL){
+        FPDF_ClosePage(page);
+    }
+    if(pdfBitmap != NULL){
+        FPDFBitmap_Destroy(pdfBitmap);
+    }
+}
+
+FPDF_BOOL RenderJob::needToPauseNow(IFSDK_PAUSE *pause) {
+    RenderJob *job = reinterpret_cast<RenderJob*>(pause->user);
+    if(job->cancelled.load()) return 1;
+    return monotonicNs() >= job->sliceDeadlineNs;
+}
+
+void RenderJob::beginSlice() {
+    sliceDeadlineNs = monotonicNs() + sliceBudgetNs;
+}
+
+int RenderJob::start() {
+    if(started || status == FPDF_RENDER_FAILED) return status;
+    if(cancelled.load()) return status = RENDER_JOB_CANCELLED;
+
+    android::Mutex::Autolock lock(getLibraryLock());
+    page = FPDF_LoadPage(pdfDocument, pageIndex);
+    if(page == NULL){
+        LOGE("Render job cannot load page %d", pageIndex);
+        return status = FPDF_RENDER_FAILED;
+    }
+    pdfBitmap = FPDFBitmap_CreateEx(canvasHorSize, canvasVerSize,
+                                    rgb565 ? FPDFBitmap_BGR : FPDFBitmap_BGRA,
+                                    &buffer[0], stride);
+
+    if(drawSizeHor < canvasHorSize || drawSizeVer < canvasVerSize){
+        FPDFBitmap_FillRect( pdfBitmap, 0, 0, canvasHorSize, canvasVerSize,
+                             0x848484FF); //Gray
+    }
+
+    int baseHorSize = (canvasHorSize < drawSizeHor)? canvasHorSize : drawSizeHor;
+    int baseVerSize = (canvasVerSize < drawSizeVer)? canvasVerSize : drawSizeVer;
+    int baseX = (startX < 0)? 0 : startX;
+    int baseY = (startY < 0)? 0 : startY;
+
+    FPDFBitmap_FillRect( pdfBitmap, baseX, baseY, baseHorSize, baseVerSize,
+                         0xFFFFFFFF); //White
+
+    beginSlice();
+    started = true;
+    status = FPDF_RenderPageBitmap_Start( pdfBitmap, page,
+                                          startX, startY,
+                                          drawSizeHor, drawSizeVer,
+                                          0, flags, &pause );
+    if(status == FPDF_RENDER_TOBECOUNTINUED && cancelled.load()){
+        status = RENDER_JOB_CANCELLED;
+    }
+    return status;
+}
+
+int RenderJob::resume() {
+    if(!started) return start();
+    if(status != FPDF_RENDER_TOBECOUNTINUED) return status;
+    if(cancelled.load()) return status = RENDER_JOB_CANCELLED;
+
+    android::Mutex::Autolock lock(getLibraryLock());
+    beginSlice();
+    status = FPDF_RenderPage_Continue(page, &pause);
+    if(status == FPDF_RENDER_TOBECOUNTINUED && cancelled.load()){
+        status = RENDER_JOB_CANCELLED;
+    }
+    return status;
+}
+
+void RenderJob::copyTo(void *dest, int destStride) const {
+    if(rgb565){
+        rgbBitmapTo565((void*) &buffer[0], stride, dest, destStride,
+                       canvasHorSize, canvasVerSize);
+        return;
+    }
+
+    const uint8_t *src = &buffer[0];
+    uint8_t *dst = (uint8_t*) dest;
+    for(int y = 0; y < canvasVerSize; y++){
+        memcpy(dst, src, stride);
+        src += stride;
+        dst += destStride;
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef _RENDER_JOB_HPP_
+#define _RENDER_JOB_HPP_
+
+#include <fpdfview.h>
+#include <fpdf_progressive.h>
+#include <atomic>
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+/** Returned when render job was cancelled, extends FPDF_RENDER_* statuses */
+#define RENDER_JOB_CANCELLED 4
+
+/**
+ * Progressive page render driven in time slices through fpdf_progressive.h.
+ * Page is rendered into buffer owned by the job, so target bitmap does not
+ * have to stay locked between slices. PDFium keeps progressive render state
+ * on FPDF_PAGE, so every job loads its own page, independent of pages opened
+ * through Java and of other jobs of the same page. Slices are run under the
+ * library lock.
+ */
+class RenderJob {
+    public:
+    /** Document must stay open until job is destroyed */
+    RenderJob(FPDF_DOCUMENT pdfDocument, int pageIndex, bool rgb565,
+              int canvasHorSize, int canvasVerSize,
+              int startX, int startY, int drawSizeHor, int drawSizeVer,
+              int flags, int64_t sliceBudgetNs);
+    ~RenderJob();
+
+    /** Run first slice, returns one of FPDF_RENDER_* or RENDER_JOB_CANCELLED */
+    int start();
+    /** Run next slice, returns one of FPDF_RENDER_* or RENDER_JOB_CANCELLED */
+    int resume();
+    /** Budget of following slices, e.g. share of frame left for this job */
+    void setSliceBudget(int64_t budgetNs) { sliceBudgetNs = budgetNs; }
+    /** May be called from any thread, running slice pauses on next check */
+    void cancel() { cancelled.store(true); }
+    bool isCancelled() const { return cancelled.load(); }
+    /** Report unfinished job cancelled between slices as RENDER_JOB_CANCELLED */
+    void markCancelled() {
+        if(status <= FPDF_RENDER_TOBECOUNTINUED) status = RENDER_JOB_CANCELLED;
+    }
+    int getStatus() const { return status; }
+    int getWidth() const { return canvasHorSize; }
+    int getHeight() const { return canvasVerSize; }
+    bool isRgb565() const { return rgb565; }
+
+    /** Copy rendered pixels into locked bitmap of the same size as canvas */
+    void copyTo(void *dest, int destStride) const;
+
+    private:
+    static FPDF_BOOL needToPauseNow(IFSDK_PAUSE *pause);
+    void beginSlice();
+
+    IFSDK_PAUSE pause;
+    FPDF_DOCUMENT pdfDocument;
+    int pageIndex;
+    FPDF_PAGE page = NULL;
+    FPDF_BITMAP pdfBitmap = NULL;
+    std::vector<uint8_t> buffer;
+    bool rgb565;
+    int canvasHorSize, canvasVerSize;
+    int stride;
+    int startX, startY;
+    int drawSizeHor, drawSizeVer;
+    int flags;
+    int64_t sliceBudgetNs;
+    int64_t sliceDeadlineNs = 0;
+    bool started = false;
+    int status = FPDF_RENDER_READER;
+    std::atomic<bool> cancelled;
+};
+
+#endif
@@ -0,0 +1,395 @@
+#include "util.hpp"
+#include "renderScheduler.hpp"
+#include "javaDataSource.hpp"
+#include "pageBitmap.hpp"
+#include "renderJob.hpp"
+#include "bitmapUtil.hpp"
+
+extern "C" {
+    #include <unistd.h>
+    #include <string.h>
+}
+
+#include <android/bitmap.h>
+
+using namespace android;
+
+RenderScheduler::RenderScheduler(JNIEnv *env, DocumentFile *doc, int workerCount, jobject callback)
+    : document(doc), pdfDocument(doc->pdfDocument) {
+    if(env->GetJavaVM(&javaVm) != JNI_OK) return;
+
+    jclass cls = env->GetObjectClass(callback);
+    completeMethod = env->GetMethodID(cls, "onRenderComplete", "(JI)V");
+    env->DeleteLocalRef(cls);
+    if(completeMethod == NULL){
+        env->ExceptionClear();
+        LOGE("Render callback has no onRenderComplete(long, int) method");
+        return;
+    }
+    callbackRef = env->NewGlobalRef(callback);
+
+    if(workerCount <= 0){
+        workerCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        if(workerCount <= 0) workerCount = 1;
+    }
+
+    if(pthread_create(&renderThread, NULL, &RenderScheduler::renderLoop, this) != 0){
+        LOGE("Cannot start render thread");
+        return;
+    }
+    renderThreadStarted = true;
+
+    for(int i = 0; i < workerCount; i++){
+        pthread_t thread;
+        if(pthread_create(&thread, NULL, &RenderScheduler::helperLoop, this) != 0){
+            LOGE("Cannot start render helper %d", i);
+            break;
+        }
+        Mutex::Autolock guard(lock);
+        helpers.push_back(thread);
+        //Render thread may take work once there is helper for its result
+        workAvailable.signal();
+    }
+}
+
+RenderScheduler::~RenderScheduler() {
+    std::vector<Target> dropped;
+    {
+        Mutex::Autolock guard(lock);
+        stopping = true;
+        for(int i = 0; i < PRIORITY_COUNT; i++){
+            for(WorkList::iterator it = queues[i].begin(); it != queues[i].end(); ++it){
+                Work *work = *it;
+                dropped.insert(dropped.end(), work->targets.begin(), work->targets.end());
+                workByKey.erase(work->key);
+                for(size_t t = 0; t < work->targets.size(); t++){
+                    workById.erase(work->targets[t].id);
+                }
+                delete work;
+            }
+            queues[i].clear();
+        }
+        workAvailable.broadcast();
+    }
+
+    //Running request is finished by render thread and completed by a helper
+    if(renderThreadStarted){
+        pthread_join(renderThread, NULL);
+    }
+    {
+        Mutex::Autolock guard(lock);
+        renderStopped = true;
+        renderedAvailable.broadcast();
+    }
+    for(size_t i = 0; i < helpers.size(); i++){
+        pthread_join(helpers[i], NULL);
+    }
+    if(page != NULL){
+        Mutex::Autolock libraryLock(getLibraryLock());
+        FPDF_ClosePage(page);
+    }
+
+    if(javaVm == NULL) return;
+    ScopedJniEnv scoped(javaVm);
+    JNIEnv *env = scoped.get();
+    if(env == NULL) return;
+    complete(env, dropped, RENDER_JOB_CANCELLED);
+    if(callbackRef != NULL) env->DeleteGlobalRef(callbackRef);
+}
+
+int64_t RenderScheduler::submit(JNIEnv *env, const Request &request, jobject bitmap) {
+    AndroidBitmapInfo info;
+    int ret;
+    if((ret = AndroidBitmap_getInfo(env, bitmap, &info)) < 0) {
+        LOGE("Fetching bitmap info failed: %s", strerror(ret * -1));
+        return 0;
+    }
+    if(info.format != ANDROID_BITMAP_FORMAT_RGBA_8888 && info.format != ANDROID_BITMAP_FORMAT_RGB_565){
+        LOGE("Bitmap format must be RGBA_8888 or RGB_565");
+        return 0;
+    }
+
+    TileCache::Key key;
+    key.document = document;
+    key.pageIndex = request.pageIndex;
+    key.drawSizeHor = request.drawSizeHor;
+    key.drawSizeVer = request.drawSizeVer;
+    key.startX = request.startX;
+    key.startY = request.startY;
+    key.width = (int)info.width;
+    key.height = (int)info.height;
+    key.format = info.format;
+    key.flags = request.flags | (request.dither ? TileCache::FLAG_DITHER : 0);
+
+    int priority = request.priority;
+    if(priority < PRIORITY_VISIBLE) priority = PRIORITY_VISIBLE;
+    if(priority >= PRIORITY_COUNT) priority = PRIORITY_COUNT - 1;
+
+    Mutex::Autolock guard(lock);
+    if(stopping || helpers.empty() || callbackRef == NULL) return 0;
+
+    Target target;
+    target.id = nextId++;
+    target.bitmap = env->NewGlobalRef(bitmap);
+    target.cancelled = false;
+
+    Work *work;
+    std::unordered_map<TileCache::Key, Work*, TileCache::KeyHash>::iterator found = workByKey.find(key);
+    if(found != workByKey.end()){
+        //Same fragment is queued or rendering, requester gets copy of its pixels
+        work = found->second;
+        work->targets.push_back(target);
+        if(!work->running && priority < work->request.priority){
+            queues[work->request.priority].erase(work->queuePosition);
+            work->request.priority = priority;
+            queues[priority].push_back(work);
+            work->queuePosition = --queues[priority].end();
+        }
+    }else{
+        work = new Work();
+        work->key = key;
+        work->request = request;
+        work->request.priority = priority;
+        work->targets.push_back(target);
+        work->running = false;
+        queues[priority].push_back(work);
+        work->queuePosition = --queues[priority].end();
+        workByKey[key] = work;
+        workAvailable.signal();
+    }
+    workById[target.id] = work;
+
+    return target.id;
+}
+
+bool RenderScheduler::cancel(JNIEnv *env, int64_t id) {
+    std::vector<Target> cancelled;
+    {
+        Mutex::Autolock guard(lock);
+        std::unordered_map<int64_t, Work*>::iterator found = workById.find(id);
+        if(found == workById.end()) return false;
+        Work *work = found->second;
+
+        for(size_t i = 0; i < work->targets.size(); i++){
+            if(work->targets[i].id != id) continue;
+
+            if(work->running){
+                //Bitmap may be written right now, helper completes it as cancelled
+                work->targets[i].cancelled = true;
+                return true;
+            }
+            cancelled.push_back(work->targets[i]);
+            work->targets.erase(work->targets.begin() + i);
+            break;
+        }
+        workById.erase(found);
+
+        if(work->targets.empty()){
+            queues[work->request.priority].erase(work->queuePosition);
+            workByKey.erase(work->key);
+            delete work;
+        }
+    }
+
+    complete(env, cancelled, RENDER_JOB_CANCELLED);
+    return true;
+}
+
+RenderScheduler::Work* RenderScheduler::takeWork() {
+    for(int i = 0; i < PRIORITY_COUNT; i++){
+        if(queues[i].empty()) continue;
+
+        Work *work = queues[i].front();
+        queues[i].pop_front();
+        work->running = true;
+        return work;
+    }
+    return NULL;
+}
+
+/** Copy pixels between bitmaps of the same size and format */
+static void copyBitmap(JNIEnv *env, jobject source, jobject dest) {
+    AndroidBitmapInfo sourceInfo, destInfo;
+    if(AndroidBitmap_getInfo(env, source, &sourceInfo) < 0
+            || AndroidBitmap_getInfo(env, dest, &destInfo) < 0) return;
+    if(sourceInfo.width != destInfo.width || sourceInfo.height != destInfo.height
+            || sourceInfo.format != destInfo.format) return;
+
+    void *sourceAddr, *destAddr;
+    if(AndroidBitmap_lockPixels(env, source, &sourceAddr) != 0) return;
+    if(AndroidBitmap_lockPixels(env, dest, &destAddr) != 0){
+        AndroidBitmap_unlockPixels(env, source);
+        return;
+    }
+
+    int bytesPerPixel = (sourceInfo.format == ANDROID_BITMAP_FORMAT_RGB_565)? 2 : 4;
+    size_t rowBytes = (size_t)sourceInfo.width * bytesPerPixel;
+    for(uint32_t y = 0; y < sourceInfo.height; y++){
+        memcpy((char*) destAddr + (size_t)y * destInfo.stride,
+               (const char*) sourceAddr + (size_t)y * sourceInfo.stride, rowBytes);
+    }
+
+    AndroidBitmap_unlockPixels(env, dest);
+    AndroidBitmap_unlockPixels(env, source);
+}
+
+void RenderScheduler::render(Work *work) {
+    const TileCache::Key &key = work->key;
+    const Request &request = work->request;
+    int bytesPerPixel = (key.format == ANDROID_BITMAP_FORMAT_RGB_565)? 2 : 4;
+    work->status = FPDF_RENDER_FAILED;
+    work->rgb = false;
+    work->cached = false;
+
+    TileCache &cache = TileCache::instance();
+    if(cache.isEnabled()){
+        work->stride = key.width * bytesPerPixel;
+        work->pixels.resize((size_t)work->stride * key.height);
+        if(cache.copyTo(key, &work->pixels[0], work->stride)){
+            work->cached = true;
+            work->status = FPDF_RENDER_DONE;
+            return;
+        }
+    }
+
+    if(pageIndex != request.pageIndex){
+        Mutex::Autolock libraryLock(getLibraryLock());
+        if(page != NULL) FPDF_ClosePage(page);
+        page = FPDF_LoadPage(pdfDocument, request.pageIndex);
+        pageIndex = (page != NULL)? request.pageIndex : -1;
+    }
+    if(page == NULL){
+        LOGE("Render thread cannot load page %d", request.pageIndex);
+        return;
+    }
+
+    //RGB_565 is converted from BGR by helper, RGBA_8888 is rendered in its final layout
+    work->rgb = (key.format == ANDROID_BITMAP_FORMAT_RGB_565);
+    work->stride = key.width * (work->rgb ? 3 : 4);
+    work->pixels.resize((size_t)work->stride * key.height);
+    renderPageBuffer(page, &work->pixels[0], work->stride, key.width, key.height, work->rgb,
+                     request.startX, request.startY, request.drawSizeHor, request.drawSizeVer,
+                     request.flags);
+    work->status = FPDF_RENDER_DONE;
+}
+
+int RenderScheduler::deliver(JNIEnv *env, Work *work, jobject bitmap) {
+    if(work->status != FPDF_RENDER_DONE) return work->status;
+    const TileCache::Key &key = work->key;
+
+    AndroidBitmapInfo info;
+    void *addr;
+    if(AndroidBitmap_getInfo(env, bitmap, &info) < 0) return FPDF_RENDER_FAILED;
+    if((int)info.width != key.width || (int)info.height != key.height || info.format != key.format){
+        LOGE("Bitmap was reconfigured after render was requested");
+        return FPDF_RENDER_FAILED;
+    }
+    if(AndroidBitmap_lockPixels(env, bitmap, &addr) != 0) return FPDF_RENDER_FAILED;
+
+    int bytesPerPixel = (info.format == ANDROID_BITMAP_FORMAT_RGB_565)? 2 : 4;
+    int rowBytes = (int)info.width * bytesPerPixel;
+    if(!work->rgb){
+        for(uint32_t y = 0; y < info.height; y++){
+            memcpy((char*) addr + (size_t)y * info.stride,
+                   &work->pixels[(size_t)y * work->stride], rowBytes);
+        }
+    }else if(work->request.dither){
+        rgbBitmapTo565Dither(&work->pixels[0], work->stride, addr, info.stride,
+                             info.width, info.height, 0, 0);
+    }else{
+        rgbBitmapTo565(&work->pixels[0], work->stride, addr, info.stride, info.width, info.height);
+    }
+
+    TileCache &cache = TileCache::instance();
+    if(!work->cached && cache.isEnabled()){
+        cache.put(key, addr, (int)info.stride, rowBytes, (int)info.height);
+    }
+
+    AndroidBitmap_unlockPixels(env, bitmap);
+    return FPDF_RENDER_DONE;
+}
+
+void RenderScheduler::complete(JNIEnv *env, const std::vector<Target> &targets, int status) {
+    for(size_t i = 0; i < targets.size(); i++){
+        const Target &target = targets[i];
+        env->CallVoidMethod(callbackRef, completeMethod, (jlong)target.id,
+                            (jint)(target.cancelled ? RENDER_JOB_CANCELLED : status));
+        if(env->ExceptionCheck()){
+            //Exception of one callback must not skip completion of others
+            env->ExceptionDescribe();
+            env->ExceptionClear();
+        }
+        env->DeleteGlobalRef(target.bitmap);
+    }
+}
+
+void* RenderScheduler::renderLoop(void *param) {
+    RenderScheduler *owner = reinterpret_cast<RenderScheduler*>(param);
+
+    Mutex::Autolock guard(owner->lock);
+    while(true){
+        Work *work = NULL;
+        while(!owner->stopping && (owner->inFlight >= (int)owner->helpers.size()
+                                   || (work = owner->takeWork()) == NULL)){
+            owner->workAvailable.wait(owner->lock);
+        }
+        if(work == NULL) break;
+        owner->inFlight++;
+
+        owner->lock.unlock();
+        owner->render(work);
+        owner->lock.lock();
+
+        owner->rendered.push_back(work);
+        owner->renderedAvailable.signal();
+    }
+    return NULL;
+}
+
+void* RenderScheduler::helperLoop(void *param) {
+    RenderScheduler *owner = reinterpret_cast<RenderScheduler*>(param);
+
+    //Helper stays attached, it locks bitmaps and calls back for every request
+    ScopedJniEnv scoped(owner->javaVm);
+    JNIEnv *env = scoped.get();
+    if(env == NULL) return NULL;
+
+    Mutex::Autolock guard(owner->lock);
+    while(true){
+        while(owner->rendered.empty() && !owner->renderStopped){
+            owner->renderedAvailable.wait(owner->lock);
+        }
+        if(owner->rendered.empty()) break;
+        Work *work = owner->rendered.front();
+        owner->rendered.pop_front();
+
+        //Targets are only marked cancelled while running, first one is written to
+        jobject bitmap = work->targets[0].bitmap;
+
+        owner->lock.unlock();
+        int status = owner->deliver(env, work, bitmap);
+        owner->lock.lock();
+
+        owner->workByKey.erase(work->key);
+        std::vector<Target> targets;
+        targets.swap(work->targets);
+        for(size_t i = 0; i < targets.size(); i++){
+            owner->workById.erase(targets[i].id);
+        }
+
+        owner->lock.unlock();
+        if(status == FPDF_RENDER_DONE){
+            for(size_t i = 1; i < targets.size(); i++){
+                if(!targets[i].cancelled) copyBitmap(env, bitmap, targets[i].bitmap);
+            }
+        }
+        owner->complete(env, targets, status);
+        delete work;
+        owner->lock.lock();
+
+        //Slot of helper is free only once callbacks returned
+        owner->inFlight--;
+        owner->workAvailable.signal();
+    }
+    return NULL;
+}
@@ -0,0 +1,123 @@
+#ifndef _RENDER_SCHEDULER_HPP_
+#define _RENDER_SCHEDULER_HPP_
+
+#include "documentFile.hpp"
+#include "tileCache.hpp"
+
+#include <jni.h>
+#include <utils/Mutex.h>
+#include <utils/Condition.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Asynchronous renderer of page fragments into Java bitmaps. PDFium calls are serialized
+ * by the library lock anyway, so one render thread renders on the document's own
+ * FPDF_DOCUMENT into scratch buffers, and helper threads convert them into bitmaps, copy
+ * them to merged requests and call back. Render thread takes requests by priority instead
+ * of arrival order, and only while a helper is free to take the result, so requests queue
+ * up by priority instead of in finished buffers. Requests for the same fragment are
+ * rendered once for all requesters. Every submitted request is completed exactly once
+ * through RenderCallback.onRenderComplete(long, int), on a helper thread or on the thread
+ * which cancelled it.
+ */
+class RenderScheduler {
+    public:
+    enum Priority {
+        PRIORITY_VISIBLE = 0,
+        PRIORITY_PREFETCH = 1,
+        PRIORITY_THUMBNAIL = 2,
+        PRIORITY_COUNT = 3
+    };
+
+    struct Request {
+        int pageIndex;
+        int startX, startY;
+        int drawSizeHor, drawSizeVer;
+        int flags;
+        bool dither;
+        int priority;
+    };
+
+    /** workerCount helpers, <= 0 uses one per online CPU */
+    RenderScheduler(JNIEnv *env, DocumentFile *doc, int workerCount, jobject callback);
+    ~RenderScheduler();
+
+    /** Number of helpers, 0 if threads could not be started */
+    int getWorkerCount() const { return (int)helpers.size(); }
+
+    /**
+     * Queue render of page fragment into bitmap, which is referenced until completion.
+     * Returns id of request, 0 if it cannot be queued.
+     */
+    int64_t submit(JNIEnv *env, const Request &request, jobject bitmap);
+    /** Complete request as cancelled, false if it is already completed */
+    bool cancel(JNIEnv *env, int64_t id);
+
+    private:
+    struct Target {
+        int64_t id;
+        jobject bitmap;
+        bool cancelled;
+    };
+
+    struct Work;
+    typedef std::list<Work*> WorkList;
+
+    /** One fragment to render, shared by every request for it */
+    struct Work {
+        TileCache::Key key;
+        Request request;
+        std::vector<Target> targets;
+        bool running;
+        WorkList::iterator queuePosition;
+
+        //Filled by render thread: bitmap pixels, or BGR to convert to RGB_565 if rgb is set
+        int status;
+        std::vector<uint8_t> pixels;
+        int stride;
+        bool rgb;
+        bool cached;
+    };
+
+    static void* renderLoop(void *param);
+    static void* helperLoop(void *param);
+    Work* takeWork();
+    void render(Work *work);
+    int deliver(JNIEnv *env, Work *work, jobject bitmap);
+    void complete(JNIEnv *env, const std::vector<Target> &targets, int status);
+
+    JavaVM *javaVm = NULL;
+    jobject callbackRef = NULL;
+    jmethodID completeMethod = NULL;
+    const void *document;
+    FPDF_DOCUMENT pdfDocument;
+
+    //Owned by render thread, page is kept loaded as tiles of one page come in runs
+    FPDF_PAGE page = NULL;
+    int pageIndex = -1;
+
+    pthread_t renderThread;
+    bool renderThreadStarted = false;
+    std::vector<pthread_t> helpers;
+
+    android::Mutex lock;
+    //Render thread waits for queued work and free helper
+    android::Condition workAvailable;
+    //Helpers wait for rendered work
+    android::Condition renderedAvailable;
+    WorkList queues[PRIORITY_COUNT];
+    WorkList rendered;
+    //Works taken by render thread and not completed by helper yet
+    int inFlight = 0;
+    std::unordered_map<TileCache::Key, Work*, TileCache::KeyHash> workByKey;
+    std::unordered_map<int64_t, Work*> workById;
+    int64_t nextId = 1;
+    bool stopping = false;
+    bool renderStopped = false;
+};
+
+#endif
@@ -0,0 +1,132 @@
+#include "util.hpp"
+#include "sidecar.hpp"
+
+extern "C" {
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <errno.h>
+    #include <string.h>
+    #include <stdio.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+}
+
+#include <vector>
+
+static const size_t FINGERPRINT_CHUNK = 64 * 1024;
+
+uint64_t fnv1a64(const void *data, size_t size, uint64_t hash) {
+    const uint8_t *bytes = (const uint8_t*) data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool computeFingerprint(const DocumentFile *doc, DocumentFingerprint *fingerprint) {
+    if (doc == NULL || !doc->hasCompleteSource()) return false;
+
+    uint64_t fileSize = doc->fileSize;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = fnv1a64(&fileSize, sizeof(fileSize), hash);
+
+    size_t headSize = fileSize < FINGERPRINT_CHUNK ? (size_t)fileSize : FINGERPRINT_CHUNK;
+    std::vector<uint8_t> buffer(headSize);
+    if (!doc->read(0, &buffer[0], headSize)) return false;
+    hash = fnv1a64(&buffer[0], headSize, hash);
+
+    if (fileSize > headSize) {
+        size_t tailSize = (fileSize - headSize) < FINGERPRINT_CHUNK ?
+                          (size_t)(fileSize - headSize) : FINGERPRINT_CHUNK;
+        if (!doc->read(fileSize - tailSize, &buffer[0], tailSize)) return false;
+        hash = fnv1a64(&buffer[0], tailSize, hash);
+    }
+
+    fingerprint->fileSize = fileSize;
+    fingerprint->hash = hash;
+    return true;
+}
+
+MappedFile::~MappedFile() {
+    if (base != NULL) {
+        munmap(base, length);
+    }
+}
+
+bool MappedFile::open(const char *path) {
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat fileState;
+    if (fstat(fd, &fileState) < 0 || fileState.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+
+    void *mapped = mmap(NULL, (size_t)fileState.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        LOGE("Cannot map %s. Error:%d", path, errno);
+        return false;
+    }
+
+    base = (uint8_t*) mapped;
+    length = (size_t)fileState.st_size;
+    return true;
+}
+
+SidecarWriter::~SidecarWriter() {
+    if (fd >= 0) {
+        close(fd);
+        unlink(tempPath.c_str());
+    }
+}
+
+bool SidecarWriter::open(const char *path) {
+    targetPath = path;
+    tempPath = targetPath + ".tmp";
+    fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        LOGE("Cannot create %s. Error:%d", tempPath.c_str(), errno);
+        return false;
+    }
+    return true;
+}
+
+bool SidecarWriter::write(const void *data, size_t size) {
+    if (!writeAt(data, size, written)) return false;
+    written += size;
+    return true;
+}
+
+bool SidecarWriter::writeAt(const void *data, size_t size, uint64_t offset) {
+    if (fd < 0 || failed) return false;
+    const uint8_t *bytes = (const uint8_t*) data;
+    while (size > 0) {
+        ssize_t count = pwrite(fd, bytes, size, offset);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) {
+            LOGE("Cannot write %s. Error:%d", tempPath.c_str(), errno);
+            failed = true;
+            return false;
+        }
+        bytes += count;
+        size -= count;
+        offset += count;
+    }
+    return true;
+}
+
+bool SidecarWriter::commit() {
+    if (fd < 0 || failed) return false;
+    bool ok = fsync(fd) == 0;
+    ok = (close(fd) == 0) && ok;
+    fd = -1;
+    if (ok && rename(tempPath.c_str(), targetPath.c_str()) == 0) {
+        return true;
+    }
+    LOGE("Cannot commit %s. Error:%d", targetPath.c_str(), errno);
+    unlink(tempPath.c_str());
+    return false;
+}
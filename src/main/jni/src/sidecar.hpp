@@ -0,0 +1,75 @@
+#ifndef _SIDECAR_HPP_
+#define _SIDECAR_HPP_
+
+#include "documentFile.hpp"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+/** Identity of document content, used to validate sidecar files */
+struct DocumentFingerprint {
+    uint64_t fileSize;
+    uint64_t hash;
+
+    bool operator==(const DocumentFingerprint &other) const {
+        return fileSize == other.fileSize && hash == other.hash;
+    }
+    bool operator!=(const DocumentFingerprint &other) const { return !(*this == other); }
+};
+
+/**
+ * Hash of size, head and tail of document file. Head holds header and
+ * (for linearized files) first page, tail holds trailer with /ID and xref,
+ * which change on every save.
+ */
+bool computeFingerprint(const DocumentFile *doc, DocumentFingerprint *fingerprint);
+
+uint64_t fnv1a64(const void *data, size_t size, uint64_t hash);
+
+/** Read-only mapping of whole file */
+class MappedFile {
+    public:
+    MappedFile() {}
+    ~MappedFile();
+
+    bool open(const char *path);
+    const uint8_t* data() const { return base; }
+    size_t size() const { return length; }
+
+    private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    uint8_t *base = NULL;
+    size_t length = 0;
+};
+
+/**
+ * Writes sidecar into temporary file which replaces target only on commit,
+ * so readers never map partially written file.
+ */
+class SidecarWriter {
+    public:
+    SidecarWriter() {}
+    ~SidecarWriter();
+
+    bool open(const char *path);
+    bool write(const void *data, size_t size);
+    /** Overwrite already written bytes at offset, e.g. table filled in after data */
+    bool writeAt(const void *data, size_t size, uint64_t offset);
+    uint64_t position() const { return written; }
+    bool commit();
+
+    private:
+    SidecarWriter(const SidecarWriter&);
+    SidecarWriter& operator=(const SidecarWriter&);
+
+    int fd = -1;
+    uint64_t written = 0;
+    bool failed = false;
+    std::string targetPath;
+    std::string tempPath;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#include "util.hpp"
+#include "textExtractor.hpp"
+#include "documentFile.hpp"
+
+#include <fpdf_text.h>
+
+bool TextExtractor::extractPage(FPDF_DOCUMENT pdfDocument, int pageIndex,
+                                std::vector<uint16_t> *out) {
+    out->clear();
+    FPDF_PAGE page = FPDF_LoadPage(pdfDocument, pageIndex);
+    if(page == NULL){
+        LOGE("Text extractor cannot load page %d", pageIndex);
+        return false;
+    }
+
+    FPDF_TEXTPAGE textPage = FPDFText_LoadPage(page);
+    if(textPage == NULL){
+        FPDF_ClosePage(page);
+        return false;
+    }
+
+    int count = FPDFText_CountChars(textPage);
+    if(count > 0){
+        //GetText writes terminating zero after requested chars
+        out->resize(count + 1);
+        int written = FPDFText_GetText(textPage, 0, count, &(*out)[0]);
+        out->resize(written > 0 ? written - 1 : 0);
+    }
+
+    FPDFText_ClosePage(textPage);
+    FPDF_ClosePage(page);
+    return true;
+}
+
+int TextExtractor::extract(FPDF_DOCUMENT pdfDocument, int fromIndex, int toIndex,
+                           Sink *sink) {
+    int delivered = 0;
+    for(int pageIndex = fromIndex; pageIndex <= toIndex; pageIndex++){
+        {
+            android::Mutex::Autolock lock(getLibraryLock());
+            extractPage(pdfDocument, pageIndex, &text);
+        }
+        delivered++;
+        if(!sink->onPage(pageIndex, text)) break;
+    }
+    return delivered;
+}
@@ -0,0 +1,36 @@
+#ifndef _TEXT_EXTRACTOR_HPP_
+#define _TEXT_EXTRACTOR_HPP_
+
+#include <fpdfview.h>
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Extracts UTF-16 text of page range through fpdf_text.h. Pages are extracted one after
+ * another on calling thread and handed to sink in page order, so only text of one page
+ * is kept at a time.
+ */
+class TextExtractor {
+    public:
+    class Sink {
+        public:
+        virtual ~Sink() {}
+        /** Text of page, empty if page cannot be loaded. Return false to stop extraction */
+        virtual bool onPage(int pageIndex, const std::vector<uint16_t> &text) = 0;
+    };
+
+    /** Text of one page, false if page cannot be loaded */
+    static bool extractPage(FPDF_DOCUMENT pdfDocument, int pageIndex, std::vector<uint16_t> *out);
+
+    /**
+     * Extract pages [fromIndex, toIndex] of pdfDocument. Library lock is held while page
+     * is extracted, not while sink runs. Returns number of pages handed to sink.
+     */
+    int extract(FPDF_DOCUMENT pdfDocument, int fromIndex, int toIndex, Sink *sink);
+
+    private:
+    std::vector<uint16_t> text;
+};
+
+#endif
@@ -0,0 +1,407 @@
+#include "util.hpp"
+#include "textIndex.hpp"
+#include "textExtractor.hpp"
+
+extern "C" {
+    #include <string.h>
+}
+
+#include <algorithm>
+#include <unordered_map>
+
+static const char INDEX_MAGIC[4] = { 'P', 'D', 'T', 'X' };
+static const uint32_t INDEX_VERSION = 1;
+
+/** Ideographs and kana are written without spaces, every one is term of its own */
+static bool isStandalone(uint16_t c) {
+    return (c >= 0x3040 && c <= 0x30FF) || (c >= 0x3400 && c <= 0x4DBF)
+           || (c >= 0x4E00 && c <= 0x9FFF) || (c >= 0xF900 && c <= 0xFAFF);
+}
+
+static bool isTermChar(uint16_t c) {
+    if (c < 0x80) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+    if (c < 0xC0) return false;
+    if (c == 0xD7 || c == 0xF7) return false;
+    //General punctuation up to box drawing and symbols, CJK and fullwidth punctuation
+    if (c >= 0x2000 && c <= 0x2BFF) return false;
+    if (c >= 0x3000 && c <= 0x303F) return false;
+    if (c >= 0xFE30 && c <= 0xFE4F) return false;
+    if (c >= 0xFF00 && c <= 0xFF0F) return false;
+    return c != 0xFFFD && c != 0xFFFE && c != 0xFFFF;
+}
+
+/** Simple one to one folding of Latin, Greek and Cyrillic, keeps char offsets of terms */
+static uint16_t foldCase(uint16_t c) {
+    if (c < 0x80) return (c >= 'A' && c <= 'Z') ? c + 0x20 : c;
+    if (c >= 0xC0 && c <= 0xDE && c != 0xD7) return c + 0x20;
+    if (c >= 0x100 && c <= 0x137) return c | 1;
+    if (c >= 0x139 && c <= 0x148) return (c & 1) ? c + 1 : c;
+    if (c >= 0x14A && c <= 0x177) return c | 1;
+    if (c >= 0x179 && c <= 0x17E) return (c & 1) ? c + 1 : c;
+    if (c >= 0x391 && c <= 0x3A9 && c != 0x3A2) return c + 0x20;
+    if (c >= 0x400 && c <= 0x40F) return c + 0x50;
+    if (c >= 0x410 && c <= 0x42F) return c + 0x20;
+    return c;
+}
+
+/** Find next term at or after *pos, false if there is none */
+static bool nextTerm(const uint16_t *text, size_t length, size_t *pos, size_t *start, size_t *end) {
+    size_t i = *pos;
+    while (i < length && !isTermChar(text[i])) i++;
+    if (i >= length) return false;
+
+    *start = i;
+    if (isStandalone(text[i])) {
+        i++;
+    } else {
+        while (i < length && isTermChar(text[i]) && !isStandalone(text[i])) i++;
+    }
+    *end = i;
+    *pos = i;
+    return true;
+}
+
+static void putVarint(std::vector<uint8_t> *out, uint32_t value) {
+    while (value >= 0x80) {
+        out->push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out->push_back((uint8_t) value);
+}
+
+static int compareTerms(const uint16_t *a, size_t aLength, const uint16_t *b, size_t bLength) {
+    size_t length = aLength < bLength ? aLength : bLength;
+    for (size_t i = 0; i < length; i++) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    if (aLength == bLength) return 0;
+    return aLength < bLength ? -1 : 1;
+}
+
+struct Posting {
+    int32_t pageIndex;
+    int32_t position;
+    int32_t charIndex;
+};
+
+/**
+ * Posting is page delta, then position and char offset, as deltas from previous posting
+ * on the same page or absolute on page change.
+ */
+class TextIndex::PostingReader {
+    public:
+    PostingReader(const uint8_t *data, size_t size, uint32_t count)
+        : data(data), size(size), remaining(count) {}
+
+    bool next(Posting *out) {
+        if (remaining == 0) return false;
+        uint32_t pageDelta, position, charIndex;
+        if (!getVarint(&pageDelta) || !getVarint(&position) || !getVarint(&charIndex)) {
+            corrupted = true;
+            return false;
+        }
+        if (pageDelta != 0) {
+            last.pageIndex += pageDelta;
+            last.position = position;
+            last.charIndex = charIndex;
+        } else {
+            last.position += position;
+            last.charIndex += charIndex;
+        }
+        remaining--;
+        *out = last;
+        return true;
+    }
+
+    bool isCorrupted() const { return corrupted; }
+
+    private:
+    bool getVarint(uint32_t *value) {
+        uint32_t result = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            if (offset >= size) return false;
+            uint8_t byte = data[offset++];
+            result |= (uint32_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                *value = result;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const uint8_t *data;
+    size_t size;
+    size_t offset = 0;
+    uint32_t remaining;
+    Posting last = { 0, 0, 0 };
+    bool corrupted = false;
+};
+
+class TextIndex::Builder : public TextExtractor::Sink {
+    public:
+    struct Postings {
+        std::vector<uint8_t> data;
+        uint32_t count = 0;
+        Posting last = { 0, 0, 0 };
+    };
+
+    struct TermHash {
+        size_t operator()(const std::vector<uint16_t> &term) const {
+            return (size_t) fnv1a64(term.data(), term.size() * sizeof(uint16_t),
+                                    0xcbf29ce484222325ULL);
+        }
+    };
+
+    typedef std::unordered_map<std::vector<uint16_t>, Postings, TermHash> TermMap;
+    typedef TermMap::value_type Entry;
+
+    static bool less(const Entry *a, const Entry *b) {
+        return compareTerms(a->first.data(), a->first.size(),
+                            b->first.data(), b->first.size()) < 0;
+    }
+
+    virtual bool onPage(int pageIndex, const std::vector<uint16_t> &pageText) {
+        const uint16_t *chars = pageText.empty() ? NULL : &pageText[0];
+        size_t pos = 0, start, end;
+        int32_t position = 0;
+        while (nextTerm(chars, pageText.size(), &pos, &start, &end)) {
+            //Skipped terms still take position, so phrases do not join across them
+            if (end - start <= MAX_TERM_LENGTH) {
+                term.resize(end - start);
+                for (size_t i = start; i < end; i++) term[i - start] = foldCase(chars[i]);
+                add(terms[term], pageIndex, position, (int32_t) start);
+            }
+            position++;
+        }
+        return true;
+    }
+
+    TermMap terms;
+
+    private:
+    static void add(Postings &postings, int32_t pageIndex, int32_t position, int32_t charIndex) {
+        Posting &last = postings.last;
+        if (pageIndex != last.pageIndex) {
+            putVarint(&postings.data, (uint32_t)(pageIndex - last.pageIndex));
+            putVarint(&postings.data, (uint32_t) position);
+            putVarint(&postings.data, (uint32_t) charIndex);
+        } else {
+            putVarint(&postings.data, 0);
+            putVarint(&postings.data, (uint32_t)(position - last.position));
+            putVarint(&postings.data, (uint32_t)(charIndex - last.charIndex));
+        }
+        last.pageIndex = pageIndex;
+        last.position = position;
+        last.charIndex = charIndex;
+        postings.count++;
+    }
+
+    std::vector<uint16_t> term;
+};
+
+bool TextIndex::write(DocumentFile *doc, const char *path) {
+    DocumentFingerprint fingerprint;
+    if (!computeFingerprint(doc, &fingerprint)) {
+        LOGE("Cannot compute document fingerprint");
+        return false;
+    }
+
+    int pageCount;
+    {
+        android::Mutex::Autolock lock(getLibraryLock());
+        pageCount = FPDF_GetPageCount(doc->pdfDocument);
+    }
+    if (pageCount < 0) return false;
+
+    Builder builder;
+    TextExtractor extractor;
+    extractor.extract(doc->pdfDocument, 0, pageCount - 1, &builder);
+
+    std::vector<const Builder::Entry*> sorted;
+    sorted.reserve(builder.terms.size());
+    for (Builder::TermMap::const_iterator it = builder.terms.begin();
+         it != builder.terms.end(); ++it) {
+        sorted.push_back(&*it);
+    }
+    std::sort(sorted.begin(), sorted.end(), Builder::less);
+
+    std::vector<Term> table(sorted.size());
+    uint64_t textLength = 0;
+    uint64_t postingsSize = 0;
+    for (size_t i = 0; i < sorted.size(); i++) {
+        const Builder::Postings &postings = sorted[i]->second;
+        if (postings.data.size() > UINT32_MAX) {
+            LOGE("Text index postings of term are too large");
+            return false;
+        }
+        table[i].postingsOffset = postingsSize;
+        table[i].postingsSize = (uint32_t) postings.data.size();
+        table[i].postingCount = postings.count;
+        table[i].textOffset = (uint32_t) textLength;
+        table[i].textLength = (uint32_t) sorted[i]->first.size();
+        textLength += sorted[i]->first.size();
+        postingsSize += postings.data.size();
+    }
+    if (textLength > UINT32_MAX) {
+        LOGE("Text index term table is too large");
+        return false;
+    }
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.fileSize = fingerprint.fileSize;
+    header.hash = fingerprint.hash;
+    header.pageCount = pageCount;
+    header.termCount = (uint32_t) table.size();
+    header.entrySize = sizeof(Term);
+    header.textLength = (uint32_t) textLength;
+    header.postingsSize = postingsSize;
+
+    SidecarWriter writer;
+    if (!writer.open(path)) return false;
+    if (!writer.write(&header, sizeof(header))) return false;
+    if (!table.empty() && !writer.write(&table[0], table.size() * sizeof(Term))) return false;
+    for (size_t i = 0; i < sorted.size(); i++) {
+        const std::vector<uint16_t> &term = sorted[i]->first;
+        if (!writer.write(&term[0], term.size() * sizeof(uint16_t))) return false;
+    }
+    for (size_t i = 0; i < sorted.size(); i++) {
+        const std::vector<uint8_t> &data = sorted[i]->second.data;
+        if (!writer.write(&data[0], data.size())) return false;
+    }
+    return writer.commit();
+}
+
+TextIndex* TextIndex::open(DocumentFile *doc, const char *path) {
+    DocumentFingerprint fingerprint;
+    if (!computeFingerprint(doc, &fingerprint)) return NULL;
+
+    TextIndex *index = new TextIndex();
+    if (!index->file.open(path) || index->file.size() < sizeof(Header)) {
+        delete index;
+        return NULL;
+    }
+
+    const Header *header = reinterpret_cast<const Header*>(index->file.data());
+    if (memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) != 0
+            || header->version != INDEX_VERSION
+            || header->fileSize != fingerprint.fileSize || header->hash != fingerprint.hash
+            || header->entrySize != sizeof(Term)
+            || sizeof(Header) + (uint64_t)header->termCount * sizeof(Term)
+               + (uint64_t)header->textLength * sizeof(uint16_t)
+               + header->postingsSize != index->file.size()) {
+        LOGD("Text index %s does not match document", path);
+        delete index;
+        return NULL;
+    }
+
+    const uint8_t *data = index->file.data() + sizeof(Header);
+    index->pageCount = (int) header->pageCount;
+    index->termCount = header->termCount;
+    index->terms = reinterpret_cast<const Term*>(data);
+    data += (size_t)header->termCount * sizeof(Term);
+    index->textLength = header->textLength;
+    index->text = reinterpret_cast<const uint16_t*>(data);
+    data += (size_t)header->textLength * sizeof(uint16_t);
+    index->postingsSize = header->postingsSize;
+    index->postings = data;
+    return index;
+}
+
+const TextIndex::Term* TextIndex::findTerm(const uint16_t *term, size_t length) const {
+    uint32_t low = 0, high = termCount;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        const Term &entry = terms[middle];
+        if ((uint64_t)entry.textOffset + entry.textLength > textLength) return NULL;
+
+        int order = compareTerms(text + entry.textOffset, entry.textLength, term, length);
+        if (order == 0) return &entry;
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return NULL;
+}
+
+bool TextIndex::find(const uint16_t *query, size_t length, int maxHits,
+                     std::vector<Hit> *out) const {
+    out->clear();
+
+    std::vector<const Term*> phrase;
+    std::vector<uint16_t> term;
+    size_t pos = 0, start, end;
+    while (nextTerm(query, length, &pos, &start, &end)) {
+        if (end - start > MAX_TERM_LENGTH) return true;
+        term.resize(end - start);
+        for (size_t i = start; i < end; i++) term[i - start] = foldCase(query[i]);
+
+        const Term *entry = findTerm(&term[0], term.size());
+        if (entry == NULL) return true;
+        if (entry->postingsOffset + entry->postingsSize > postingsSize) return false;
+        phrase.push_back(entry);
+    }
+    if (phrase.empty()) return true;
+
+    //Candidates are postings of first term, narrowed by each following term
+    struct Candidate {
+        Posting start;
+        int32_t endChar;
+    };
+    std::vector<Candidate> candidates;
+    bool single = phrase.size() == 1;
+
+    const Term *first = phrase[0];
+    PostingReader reader(postings + first->postingsOffset, first->postingsSize,
+                         first->postingCount);
+    Posting posting;
+    while (reader.next(&posting)) {
+        Candidate candidate = { posting, posting.charIndex + (int32_t) first->textLength };
+        candidates.push_back(candidate);
+        if (single && maxHits > 0 && (int) candidates.size() >= maxHits) break;
+    }
+    if (reader.isCorrupted()) return false;
+
+    for (size_t k = 1; k < phrase.size() && !candidates.empty(); k++) {
+        const Term *next = phrase[k];
+        PostingReader nextReader(postings + next->postingsOffset, next->postingsSize,
+                                 next->postingCount);
+        size_t kept = 0;
+        bool more = nextReader.next(&posting);
+        //Both lists are ordered by page and position, term k follows k positions after first
+        for (size_t i = 0; i < candidates.size() && more; i++) {
+            Candidate &candidate = candidates[i];
+            int32_t position = candidate.start.position + (int32_t) k;
+            while (more && (posting.pageIndex < candidate.start.pageIndex
+                            || (posting.pageIndex == candidate.start.pageIndex
+                                && posting.position < position))) {
+                more = nextReader.next(&posting);
+            }
+            if (more && posting.pageIndex == candidate.start.pageIndex
+                    && posting.position == position) {
+                candidate.endChar = posting.charIndex + (int32_t) next->textLength;
+                candidates[kept++] = candidate;
+            }
+        }
+        if (nextReader.isCorrupted()) return false;
+        candidates.resize(kept);
+    }
+
+    size_t count = candidates.size();
+    if (maxHits > 0 && count > (size_t) maxHits) count = maxHits;
+    out->resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const Candidate &candidate = candidates[i];
+        (*out)[i].pageIndex = candidate.start.pageIndex;
+        (*out)[i].charIndex = candidate.start.charIndex;
+        (*out)[i].charCount = candidate.endChar - candidate.start.charIndex;
+    }
+    return true;
+}
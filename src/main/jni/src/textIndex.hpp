@@ -0,0 +1,83 @@
+#ifndef _TEXT_INDEX_HPP_
+#define _TEXT_INDEX_HPP_
+
+#include "documentFile.hpp"
+#include "sidecar.hpp"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/**
+ * Inverted index of text layer of document, persisted in sidecar file and memory mapped,
+ * so term and phrase queries are answered without loading any page.
+ *
+ * Text is split into terms (runs of letters and digits, single CJK ideographs) folded to
+ * lower case. Every term maps to postings (page, position of term on page, char offset),
+ * stored as deltas in varints. File is header, term table sorted by term, UTF-16 text of
+ * terms and postings. Char offsets index page text as returned by FPDFText_GetText.
+ */
+class TextIndex {
+    public:
+    struct Hit {
+        int32_t pageIndex;
+        int32_t charIndex;
+        int32_t charCount;
+    };
+
+    /** Longer runs are not indexed, they are rarely words and bloat term table */
+    static const size_t MAX_TERM_LENGTH = 64;
+
+    /** Extract text of all pages on calling thread and write index */
+    static bool write(DocumentFile *doc, const char *path);
+    /** Map sidecar, returns NULL if file is missing, corrupted or made for other document */
+    static TextIndex* open(DocumentFile *doc, const char *path);
+
+    int getPageCount() const { return pageCount; }
+
+    /**
+     * Find occurrences of query, which is single term or phrase of terms following each
+     * other on page, in page order. Stops after maxHits when it is positive.
+     * Returns false if index data is corrupted.
+     */
+    bool find(const uint16_t *query, size_t length, int maxHits, std::vector<Hit> *out) const;
+
+    private:
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t fileSize;
+        uint64_t hash;
+        uint32_t pageCount;
+        uint32_t termCount;
+        uint32_t entrySize;
+        //In UTF-16 units
+        uint32_t textLength;
+        uint64_t postingsSize;
+    };
+
+    struct Term {
+        uint64_t postingsOffset;
+        uint32_t postingsSize;
+        uint32_t postingCount;
+        uint32_t textOffset;
+        uint32_t textLength;
+    };
+
+    class Builder;
+    class PostingReader;
+
+    TextIndex() {}
+    const Term* findTerm(const uint16_t *term, size_t length) const;
+
+    MappedFile file;
+    const Term *terms = NULL;
+    uint32_t termCount = 0;
+    const uint16_t *text = NULL;
+    uint32_t textLength = 0;
+    const uint8_t *postings = NULL;
+    uint64_t postingsSize = 0;
+    int pageCount = 0;
+};
+
+#endif
@@ -0,0 +1,78 @@
+#include "util.hpp"
+#include "textSearch.hpp"
+#include "documentFile.hpp"
+
+#include <fpdf_text.h>
+
+TextSearch::TextSearch(const uint16_t *query, size_t length, bool matchCase, bool wholeWord)
+    : query(query, query + length), flags(0), cancelled(false) {
+    this->query.push_back(0);
+    if(matchCase) flags |= FPDF_MATCHCASE;
+    if(wholeWord) flags |= FPDF_MATCHWHOLEWORD;
+}
+
+bool TextSearch::searchPage(FPDF_DOCUMENT pdfDocument, int pageIndex, const uint16_t *query,
+                            int flags, std::vector<Hit> *hits, std::vector<float> *rects) {
+    FPDF_PAGE page = FPDF_LoadPage(pdfDocument, pageIndex);
+    if(page == NULL){
+        LOGE("Text search cannot load page %d", pageIndex);
+        return false;
+    }
+
+    FPDF_TEXTPAGE textPage = FPDFText_LoadPage(page);
+    if(textPage == NULL){
+        FPDF_ClosePage(page);
+        return false;
+    }
+
+    FPDF_SCHHANDLE search = FPDFText_FindStart(textPage, (FPDF_WIDESTRING) query,
+                                               (unsigned long) flags, 0);
+    if(search != NULL){
+        while(FPDFText_FindNext(search)){
+            Hit hit;
+            hit.pageIndex = pageIndex;
+            hit.charIndex = FPDFText_GetSchResultIndex(search);
+            hit.charCount = FPDFText_GetSchCount(search);
+            hit.rectCount = FPDFText_CountRects(textPage, hit.charIndex, hit.charCount);
+            if(hit.rectCount < 0) hit.rectCount = 0;
+
+            for(int i = 0; i < hit.rectCount; i++){
+                double left, top, right, bottom;
+                FPDFText_GetRect(textPage, i, &left, &top, &right, &bottom);
+                rects->push_back((float) left);
+                rects->push_back((float) top);
+                rects->push_back((float) right);
+                rects->push_back((float) bottom);
+            }
+            hits->push_back(hit);
+        }
+        FPDFText_FindClose(search);
+    }
+
+    FPDFText_ClosePage(textPage);
+    FPDF_ClosePage(page);
+    return true;
+}
+
+int TextSearch::search(FPDF_DOCUMENT pdfDocument, int fromIndex, int toIndex, Sink *sink) {
+    //Empty query would match at every char
+    if(query.size() <= 1) return 0;
+
+    int delivered = 0;
+    for(int windowStart = fromIndex; windowStart <= toIndex; windowStart += PAGES_PER_WINDOW){
+        int windowEnd = windowStart + PAGES_PER_WINDOW - 1;
+        if(windowEnd > toIndex) windowEnd = toIndex;
+
+        hits.clear();
+        rects.clear();
+        for(int pageIndex = windowStart; pageIndex <= windowEnd; pageIndex++){
+            if(isCancelled()) return delivered;
+            android::Mutex::Autolock lock(getLibraryLock());
+            searchPage(pdfDocument, pageIndex, &query[0], flags, &hits, &rects);
+        }
+
+        delivered += windowEnd - windowStart + 1;
+        if(!sink->onResults(windowEnd, hits, rects)) break;
+    }
+    return delivered;
+}
@@ -0,0 +1,72 @@
+#ifndef _TEXT_SEARCH_HPP_
+#define _TEXT_SEARCH_HPP_
+
+#include <fpdfview.h>
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * Finds all occurrences of query in page range through fpdf_text.h search, with bounding
+ * rectangles of every hit. Pages are searched one after another on calling thread and hits
+ * of every window of few pages are handed to sink in page order, so first hits are known
+ * long before whole range is searched. Search may be cancelled from another thread, it
+ * stops before next page.
+ */
+class TextSearch {
+    public:
+    /** Pages searched before their hits are handed to sink */
+    static const int PAGES_PER_WINDOW = 4;
+
+    struct Hit {
+        int32_t pageIndex;
+        int32_t charIndex;
+        int32_t charCount;
+        //Rectangles of hit follow rectangles of previous hits
+        int32_t rectCount;
+    };
+
+    class Sink {
+        public:
+        virtual ~Sink() {}
+        /**
+         * Hits on pages of window ending with lastPageIndex, possibly none, and their
+         * rectangles as left, top, right, bottom in page coordinates.
+         * Return false to stop search.
+         */
+        virtual bool onResults(int lastPageIndex, const std::vector<Hit> &hits,
+                               const std::vector<float> &rects) = 0;
+    };
+
+    TextSearch(const uint16_t *query, size_t length, bool matchCase, bool wholeWord);
+
+    /**
+     * Append hits on page, false if page cannot be loaded. query is zero terminated,
+     * flags are FPDF_MATCHCASE and FPDF_MATCHWHOLEWORD.
+     */
+    static bool searchPage(FPDF_DOCUMENT pdfDocument, int pageIndex, const uint16_t *query,
+                           int flags, std::vector<Hit> *hits, std::vector<float> *rects);
+
+    /**
+     * Search pages [fromIndex, toIndex] of pdfDocument. Library lock is held while page is
+     * searched, not while sink runs. Window in progress when search is cancelled is not
+     * handed to sink. Returns number of pages handed to sink.
+     */
+    int search(FPDF_DOCUMENT pdfDocument, int fromIndex, int toIndex, Sink *sink);
+
+    /** May be called from any thread, search stops before next page */
+    void cancel() { cancelled.store(true); }
+    bool isCancelled() const { return cancelled.load(); }
+
+    private:
+    //Zero terminated, as FPDF_WIDESTRING
+    std::vector<uint16_t> query;
+    int flags;
+    std::atomic<bool> cancelled;
+    std::vector<Hit> hits;
+    std::vector<float> rects;
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "util.hpp"
+#include "thumbnailAtlas.hpp"
+#include "documentFile.hpp"
+#include "bitmapUtil.hpp"
+
+ThumbnailAtlas::ThumbnailAtlas(void *buffer, bool rgb565, int stride, int width, int height,
+                               int cellWidth, int cellHeight, int flags, bool dither)
+    : buffer((uint8_t*) buffer), rgb565(rgb565), stride(stride), width(width), height(height),
+      cellWidth(cellWidth), cellHeight(cellHeight), flags(flags), dither(dither) {
+}
+
+void ThumbnailAtlas::render(FPDF_DOCUMENT pdfDocument, int from, int to) {
+    rects.clear();
+    if(to < from || cellWidth <= 0 || cellHeight <= 0) return;
+
+    fromIndex = from;
+    int count = to - from + 1;
+    rects.resize(count * 4, 0);
+
+    int columns = width / cellWidth;
+    int capacity = columns * (height / cellHeight);
+    int renderCount = count < capacity ? count : capacity;
+
+    layout(pdfDocument, renderCount, columns);
+
+    for(int i = 0; i < renderCount; i++){
+        {
+            android::Mutex::Autolock lock(getLibraryLock());
+            renderPage(pdfDocument, i);
+        }
+        composite(i);
+    }
+    scratch.clear();
+}
+
+void ThumbnailAtlas::layout(FPDF_DOCUMENT pdfDocument, int renderCount, int columns) {
+    android::Mutex::Autolock lock(getLibraryLock());
+    for(int i = 0; i < renderCount; i++){
+        double pageWidth, pageHeight;
+        if(!FPDF_GetPageSizeByIndex(pdfDocument, fromIndex + i, &pageWidth, &pageHeight)
+                || pageWidth <= 0 || pageHeight <= 0){
+            continue;
+        }
+
+        double scaleX = cellWidth / pageWidth;
+        double scaleY = cellHeight / pageHeight;
+        double scale = scaleX < scaleY ? scaleX : scaleY;
+        int thumbWidth = (int)(pageWidth * scale + 0.5);
+        int thumbHeight = (int)(pageHeight * scale + 0.5);
+        if(thumbWidth < 1) thumbWidth = 1;
+        if(thumbHeight < 1) thumbHeight = 1;
+        if(thumbWidth > cellWidth) thumbWidth = cellWidth;
+        if(thumbHeight > cellHeight) thumbHeight = cellHeight;
+
+        int left = (i % columns) * cellWidth + (cellWidth - thumbWidth) / 2;
+        int top = (i / columns) * cellHeight + (cellHeight - thumbHeight) / 2;
+        rects[i * 4] = left;
+        rects[i * 4 + 1] = top;
+        rects[i * 4 + 2] = left + thumbWidth;
+        rects[i * 4 + 3] = top + thumbHeight;
+    }
+}
+
+void ThumbnailAtlas::renderPage(FPDF_DOCUMENT pdfDocument, int item) {
+    int *rect = &rects[item * 4];
+    int thumbWidth = rect[2] - rect[0];
+    int thumbHeight = rect[3] - rect[1];
+    if(thumbWidth <= 0 || thumbHeight <= 0) return;
+
+    FPDF_PAGE page = FPDF_LoadPage(pdfDocument, fromIndex + item);
+    if(page == NULL){
+        LOGE("Cannot load page %d for atlas", fromIndex + item);
+        rect[0] = rect[1] = rect[2] = rect[3] = 0;
+        return;
+    }
+
+    FPDF_BITMAP pdfBitmap;
+    if(rgb565){
+        //Composited into atlas by composite(), outside of library lock
+        scratch.resize((size_t)thumbWidth * thumbHeight * sizeof(rgb));
+        pdfBitmap = FPDFBitmap_CreateEx(thumbWidth, thumbHeight, FPDFBitmap_BGR,
+                                        &scratch[0], thumbWidth * sizeof(rgb));
+    }else{
+        uint8_t *target = buffer + (size_t)rect[1] * stride + rect[0] * 4;
+        pdfBitmap = FPDFBitmap_CreateEx(thumbWidth, thumbHeight, FPDFBitmap_BGRA,
+                                        target, stride);
+    }
+
+    FPDFBitmap_FillRect(pdfBitmap, 0, 0, thumbWidth, thumbHeight, 0xFFFFFFFF); //White
+    FPDF_RenderPageBitmap(pdfBitmap, page, 0, 0, thumbWidth, thumbHeight, 0, flags);
+    FPDFBitmap_Destroy(pdfBitmap);
+    FPDF_ClosePage(page);
+}
+
+void ThumbnailAtlas::composite(int item) {
+    const int *rect = &rects[item * 4];
+    int thumbWidth = rect[2] - rect[0];
+    int thumbHeight = rect[3] - rect[1];
+    if(!rgb565 || thumbWidth <= 0 || thumbHeight <= 0) return;
+
+    uint8_t *target = buffer + (size_t)rect[1] * stride + rect[0] * sizeof(uint16_t);
+    if(dither){
+        rgbBitmapTo565Dither(&scratch[0], thumbWidth * sizeof(rgb), target, stride,
+                             thumbWidth, thumbHeight, rect[0], rect[1]);
+    }else{
+        rgbBitmapTo565(&scratch[0], thumbWidth * sizeof(rgb), target, stride,
+                       thumbWidth, thumbHeight);
+    }
+}
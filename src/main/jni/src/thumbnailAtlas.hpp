@@ -0,0 +1,46 @@
+#ifndef _THUMBNAIL_ATLAS_HPP_
+#define _THUMBNAIL_ATLAS_HPP_
+
+#include <fpdfview.h>
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Renders thumbnails of page range into grid of equal cells of one bitmap.
+ * Every thumbnail keeps aspect ratio of its page and is centered in its cell.
+ * PDFium calls of every page run under the library lock, RGB_565 conversion
+ * of finished thumbnail runs outside of it.
+ */
+class ThumbnailAtlas {
+    public:
+    ThumbnailAtlas(void *buffer, bool rgb565, int stride, int width, int height,
+                   int cellWidth, int cellHeight, int flags, bool dither);
+
+    /** Render pages [fromIndex, toIndex], as many as fit in atlas, on calling thread */
+    void render(FPDF_DOCUMENT pdfDocument, int fromIndex, int toIndex);
+
+    /** left, top, right, bottom of every page of range, zeros for pages not rendered */
+    const std::vector<int>& getRects() const { return rects; }
+
+    private:
+    /** Compute rect of every page which fits, under library lock */
+    void layout(FPDF_DOCUMENT pdfDocument, int renderCount, int columns);
+    /** Render item into atlas, or into scratch for RGB_565, under library lock */
+    void renderPage(FPDF_DOCUMENT pdfDocument, int item);
+    /** Convert RGB_565 thumbnail of item from scratch into atlas */
+    void composite(int item);
+
+    uint8_t *buffer;
+    bool rgb565;
+    int stride;
+    int width, height;
+    int cellWidth, cellHeight;
+    int flags;
+    bool dither;
+    int fromIndex = 0;
+    std::vector<int> rects;
+    std::vector<uint8_t> scratch;
+};
+
+#endif
@@ -0,0 +1,213 @@
+#include "util.hpp"
+#include "thumbnailStore.hpp"
+#include "bitmapUtil.hpp"
+
+extern "C" {
+    #include <string.h>
+}
+
+#include <vector>
+
+static const char THUMBNAIL_MAGIC[4] = { 'P', 'D', 'T', 'S' };
+static const uint32_t THUMBNAIL_VERSION = 1;
+
+static void fitPage(double pageWidth, double pageHeight, int maxWidth, int maxHeight,
+                    int *width, int *height) {
+    if (pageWidth <= 0 || pageHeight <= 0) {
+        *width = 0;
+        *height = 0;
+        return;
+    }
+    double scaleX = maxWidth / pageWidth;
+    double scaleY = maxHeight / pageHeight;
+    double scale = scaleX < scaleY ? scaleX : scaleY;
+    *width = (int)(pageWidth * scale + 0.5);
+    *height = (int)(pageHeight * scale + 0.5);
+    if (*width < 1) *width = 1;
+    if (*height < 1) *height = 1;
+}
+
+static bool renderThumbnail(FPDF_DOCUMENT pdfDocument, int pageIndex, int width, int height,
+                            uint32_t format, int flags, std::vector<uint8_t> &scratch,
+                            uint8_t *out) {
+    bool rgb565 = format == ThumbnailStore::FORMAT_RGB_565;
+    int stride = width * (rgb565 ? sizeof(rgb) : 4);
+    uint8_t *target = out;
+    if (rgb565) {
+        scratch.resize((size_t)stride * height);
+        target = &scratch[0];
+    }
+
+    {
+        android::Mutex::Autolock lock(getLibraryLock());
+        FPDF_PAGE page = FPDF_LoadPage(pdfDocument, pageIndex);
+        if (page == NULL) {
+            LOGE("Cannot load page %d for thumbnail", pageIndex);
+            return false;
+        }
+
+        FPDF_BITMAP pdfBitmap = FPDFBitmap_CreateEx(width, height,
+                                                    rgb565 ? FPDFBitmap_BGR : FPDFBitmap_BGRA,
+                                                    target, stride);
+        FPDFBitmap_FillRect(pdfBitmap, 0, 0, width, height, 0xFFFFFFFF); //White
+        FPDF_RenderPageBitmap(pdfBitmap, page, 0, 0, width, height, 0, flags);
+        FPDFBitmap_Destroy(pdfBitmap);
+        FPDF_ClosePage(page);
+    }
+
+    if (rgb565) {
+        rgbBitmapTo565(target, stride, out, width * 2, width, height);
+    }
+    return true;
+}
+
+bool ThumbnailStore::write(DocumentFile *doc, const char *path, int maxWidth, int maxHeight,
+                           uint32_t format, int flags) {
+    if (maxWidth <= 0 || maxHeight <= 0) return false;
+    if (format != FORMAT_RGBA_8888 && format != FORMAT_RGB_565) return false;
+
+    DocumentFingerprint fingerprint;
+    if (!computeFingerprint(doc, &fingerprint)) {
+        LOGE("Cannot compute document fingerprint");
+        return false;
+    }
+
+    int pageCount;
+    {
+        android::Mutex::Autolock lock(getLibraryLock());
+        pageCount = FPDF_GetPageCount(doc->pdfDocument);
+    }
+    if (pageCount < 0) return false;
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, THUMBNAIL_MAGIC, sizeof(header.magic));
+    header.version = THUMBNAIL_VERSION;
+    header.fileSize = fingerprint.fileSize;
+    header.hash = fingerprint.hash;
+    header.pageCount = pageCount;
+    header.format = format;
+    header.maxWidth = maxWidth;
+    header.maxHeight = maxHeight;
+
+    SidecarWriter writer;
+    if (!writer.open(path)) return false;
+
+    //Table is written after pixels, when offsets are known
+    std::vector<Entry> table(pageCount);
+    if (!writer.write(&header, sizeof(header))) return false;
+    if (pageCount > 0 && !writer.write(&table[0], table.size() * sizeof(Entry))) return false;
+
+    std::vector<uint8_t> pixels, scratch;
+    for (int i = 0; i < pageCount; i++) {
+        double pageWidth, pageHeight;
+        int width = 0, height = 0;
+        bool measured;
+        {
+            android::Mutex::Autolock lock(getLibraryLock());
+            measured = FPDF_GetPageSizeByIndex(doc->pdfDocument, i, &pageWidth, &pageHeight);
+        }
+        if (measured) {
+            fitPage(pageWidth, pageHeight, maxWidth, maxHeight, &width, &height);
+        }
+
+        size_t size = (size_t)width * height * bytesPerPixel(format);
+        pixels.resize(size);
+        if (size == 0 || !renderThumbnail(doc->pdfDocument, i, width, height, format, flags,
+                                          scratch, &pixels[0])) {
+            table[i].offset = 0;
+            table[i].width = 0;
+            table[i].height = 0;
+            continue;
+        }
+
+        table[i].offset = writer.position();
+        table[i].width = width;
+        table[i].height = height;
+        if (!writer.write(&pixels[0], size)) return false;
+    }
+
+    if (pageCount > 0 && !writer.writeAt(&table[0], table.size() * sizeof(Entry), sizeof(header))) {
+        return false;
+    }
+    return writer.commit();
+}
+
+ThumbnailStore* ThumbnailStore::open(DocumentFile *doc, const char *path) {
+    DocumentFingerprint fingerprint;
+    if (!computeFingerprint(doc, &fingerprint)) return NULL;
+
+    int documentPageCount;
+    {
+        android::Mutex::Autolock lock(getLibraryLock());
+        documentPageCount = doc->pdfDocument != NULL ? FPDF_GetPageCount(doc->pdfDocument) : -1;
+    }
+    if (documentPageCount < 0) return NULL;
+
+    ThumbnailStore *store = new ThumbnailStore();
+    if (!store->file.open(path) || store->file.size() < sizeof(Header)) {
+        delete store;
+        return NULL;
+    }
+
+    //Every size and offset is checked in 64 bits against size of mapped file before use
+    uint64_t fileSize = store->file.size();
+    const Header *header = reinterpret_cast<const Header*>(store->file.data());
+    if (memcmp(header->magic, THUMBNAIL_MAGIC, sizeof(header->magic)) != 0
+            || header->version != THUMBNAIL_VERSION
+            || header->fileSize != fingerprint.fileSize || header->hash != fingerprint.hash
+            || (header->format != FORMAT_RGBA_8888 && header->format != FORMAT_RGB_565)
+            || header->pageCount != (uint32_t)documentPageCount
+            || header->maxWidth > (uint32_t)INT32_MAX || header->maxHeight > (uint32_t)INT32_MAX
+            || header->pageCount > (fileSize - sizeof(Header)) / sizeof(Entry)) {
+        LOGD("Thumbnail store %s does not match document", path);
+        delete store;
+        return NULL;
+    }
+
+    uint64_t tableEnd = sizeof(Header) + (uint64_t)header->pageCount * sizeof(Entry);
+    const Entry *entries = reinterpret_cast<const Entry*>(store->file.data() + sizeof(Header));
+    for (uint32_t i = 0; i < header->pageCount; i++) {
+        const Entry &entry = entries[i];
+        if (entry.width == 0 || entry.height == 0) continue;
+
+        uint64_t rowBytes = (uint64_t)entry.width * bytesPerPixel(header->format);
+        bool valid = entry.width <= header->maxWidth && entry.height <= header->maxHeight
+                && entry.height <= fileSize / rowBytes
+                && entry.offset >= tableEnd && entry.offset <= fileSize
+                && rowBytes * entry.height <= fileSize - entry.offset;
+        if (!valid) {
+            LOGE("Thumbnail store %s is corrupted", path);
+            delete store;
+            return NULL;
+        }
+    }
+
+    store->header = header;
+    store->entries = entries;
+    return store;
+}
+
+bool ThumbnailStore::getSize(int pageIndex, int *width, int *height) const {
+    if (pageIndex < 0 || pageIndex >= getPageCount()) return false;
+    const Entry &entry = entries[pageIndex];
+    if (entry.width == 0 || entry.height == 0) return false;
+    *width = entry.width;
+    *height = entry.height;
+    return true;
+}
+
+bool ThumbnailStore::copyTo(int pageIndex, void *dest, int destStride) const {
+    int width, height;
+    if (!getSize(pageIndex, &width, &height)) return false;
+
+    size_t rowBytes = (size_t)width * bytesPerPixel(header->format);
+    const uint8_t *src = file.data() + entries[pageIndex].offset;
+    uint8_t *dst = (uint8_t*) dest;
+    for (int y = 0; y < height; y++) {
+        memcpy(dst, src, rowBytes);
+        src += rowBytes;
+        dst += destStride;
+    }
+    return true;
+}
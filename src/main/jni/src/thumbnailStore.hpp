@@ -0,0 +1,60 @@
+#ifndef _THUMBNAIL_STORE_HPP_
+#define _THUMBNAIL_STORE_HPP_
+
+#include "documentFile.hpp"
+#include "sidecar.hpp"
+
+#include <stdint.h>
+
+/**
+ * Sidecar file with thumbnails of all pages of document. Layout:
+ * header, table of one entry per page, raw pixels of every thumbnail
+ * (rows packed, RGBA_8888 or RGB_565). File is memory mapped when opened,
+ * so showing thumbnails does not touch PDFium.
+ */
+class ThumbnailStore {
+    public:
+    //Values match ANDROID_BITMAP_FORMAT_*
+    static const uint32_t FORMAT_RGBA_8888 = 1;
+    static const uint32_t FORMAT_RGB_565 = 4;
+
+    /** Render thumbnails of all pages fitting maxWidth x maxHeight and write store */
+    static bool write(DocumentFile *doc, const char *path, int maxWidth, int maxHeight,
+                      uint32_t format, int flags);
+    /** Map store, returns NULL if file is missing, corrupted or made for other document */
+    static ThumbnailStore* open(DocumentFile *doc, const char *path);
+
+    int getPageCount() const { return (int)header->pageCount; }
+    uint32_t getFormat() const { return header->format; }
+    bool getSize(int pageIndex, int *width, int *height) const;
+    /** Copy thumbnail rows into dest, which must be at least thumbnail size */
+    bool copyTo(int pageIndex, void *dest, int destStride) const;
+
+    private:
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t fileSize;
+        uint64_t hash;
+        uint32_t pageCount;
+        uint32_t format;
+        uint32_t maxWidth;
+        uint32_t maxHeight;
+    };
+
+    struct Entry {
+        uint64_t offset;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    static int bytesPerPixel(uint32_t format) { return format == FORMAT_RGB_565 ? 2 : 4; }
+
+    ThumbnailStore() {}
+
+    MappedFile file;
+    const Header *header = NULL;
+    const Entry *entries = NULL;
+};
+
+#endif
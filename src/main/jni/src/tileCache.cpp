@@ -0,0 +1,138 @@
+#include "util.hpp"
+#include "tileCache.hpp"
+
+extern "C" {
+    #include <string.h>
+}
+
+using namespace android;
+
+bool TileCache::Key::operator==(const Key &other) const {
+    return document == other.document && pageIndex == other.pageIndex
+        && drawSizeHor == other.drawSizeHor && drawSizeVer == other.drawSizeVer
+        && startX == other.startX && startY == other.startY
+        && width == other.width && height == other.height
+        && format == other.format && flags == other.flags;
+}
+
+size_t TileCache::KeyHash::operator()(const Key &key) const {
+    size_t hash = std::hash<const void*>()(key.document);
+    const int values[] = { key.pageIndex, key.drawSizeHor, key.drawSizeVer,
+                           key.startX, key.startY, key.width, key.height,
+                           key.format, key.flags };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        hash = hash * 31 + std::hash<int>()(values[i]);
+    }
+    return hash;
+}
+
+TileCache& TileCache::instance() {
+    static TileCache cache;
+    return cache;
+}
+
+void TileCache::setBudget(size_t bytes) {
+    Mutex::Autolock guard(lock);
+    budget = bytes;
+    evictToBudget();
+}
+
+size_t TileCache::getBudget() {
+    Mutex::Autolock guard(lock);
+    return budget;
+}
+
+bool TileCache::copyTo(const Key &key, void *dest, int destStride) {
+    Mutex::Autolock guard(lock);
+    auto found = index.find(key);
+    if (found == index.end()) {
+        misses++;
+        return false;
+    }
+    hits++;
+
+    //Move to front of LRU list, iterators stay valid
+    entries.splice(entries.begin(), entries, found->second);
+
+    const Entry &entry = *found->second;
+    const uint8_t *src = &entry.pixels[0];
+    uint8_t *dst = (uint8_t*) dest;
+    for (int y = 0; y < key.height; y++) {
+        memcpy(dst, src, entry.rowBytes);
+        src += entry.rowBytes;
+        dst += destStride;
+    }
+    return true;
+}
+
+void TileCache::put(const Key &key, const void *src, int srcStride, int rowBytes, int height) {
+    size_t size = (size_t)rowBytes * height;
+
+    Mutex::Autolock guard(lock);
+    if (size == 0 || size > budget) return;
+
+    auto found = index.find(key);
+    if (found != index.end()) {
+        removeEntry(found->second);
+    }
+
+    entries.push_front(Entry());
+    Entry &entry = entries.front();
+    entry.key = key;
+    entry.rowBytes = rowBytes;
+    entry.pixels.resize(size);
+
+    const uint8_t *srcLine = (const uint8_t*) src;
+    for (int y = 0; y < height; y++) {
+        memcpy(&entry.pixels[(size_t)y * rowBytes], srcLine, rowBytes);
+        srcLine += srcStride;
+    }
+
+    index[key] = entries.begin();
+    bytes += size;
+    evictToBudget();
+}
+
+void TileCache::removeDocument(const void *document) {
+    Mutex::Autolock guard(lock);
+    for (EntryList::iterator it = entries.begin(); it != entries.end();) {
+        EntryList::iterator current = it++;
+        if (current->key.document == document) {
+            removeEntry(current);
+        }
+    }
+}
+
+void TileCache::clear() {
+    Mutex::Autolock guard(lock);
+    entries.clear();
+    index.clear();
+    bytes = 0;
+}
+
+TileCache::Stats TileCache::getStats() {
+    Mutex::Autolock guard(lock);
+    Stats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.evictions = evictions;
+    stats.bytes = bytes;
+    stats.budget = budget;
+    stats.entries = (int)index.size();
+    return stats;
+}
+
+void TileCache::evictToBudget() {
+    while (bytes > budget && !entries.empty()) {
+        EntryList::iterator last = entries.end();
+        --last;
+        removeEntry(last);
+        evictions++;
+    }
+}
+
+void TileCache::removeEntry(EntryList::iterator it) {
+    bytes -= it->pixels.size();
+    index.erase(it->key);
+    entries.erase(it);
+}
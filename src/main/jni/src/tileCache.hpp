@@ -0,0 +1,87 @@
+#ifndef _TILE_CACHE_HPP_
+#define _TILE_CACHE_HPP_
+
+#include <utils/Mutex.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Process wide LRU cache of rendered bitmap fragments limited by byte budget.
+ * Entries are owned by document and must be dropped when document is closed.
+ */
+class TileCache {
+    public:
+    struct Key {
+        const void *document;
+        int pageIndex;
+        //Zoom of page, size of whole page in pixels
+        int drawSizeHor, drawSizeVer;
+        //Tile rect in page pixel space
+        int startX, startY;
+        int width, height;
+        int format;
+        int flags;
+
+        bool operator==(const Key &other) const;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const;
+    };
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        size_t bytes;
+        size_t budget;
+        int entries;
+    };
+
+    /** Set in Key::flags for dithered RGB_565 fragments */
+    static const int FLAG_DITHER = 1 << 24;
+
+    static TileCache& instance();
+
+    /** 0 disables caching and drops all entries */
+    void setBudget(size_t bytes);
+    size_t getBudget();
+    bool isEnabled() { return getBudget() > 0; }
+
+    /** Copy cached pixels into dest on hit, counts hit or miss */
+    bool copyTo(const Key &key, void *dest, int destStride);
+    /** Store rows of rowBytes bytes, replacing existing entry */
+    void put(const Key &key, const void *src, int srcStride, int rowBytes, int height);
+
+    void removeDocument(const void *document);
+    void clear();
+    Stats getStats();
+
+    private:
+
+    struct Entry {
+        Key key;
+        int rowBytes;
+        std::vector<uint8_t> pixels;
+    };
+
+    typedef std::list<Entry> EntryList;
+
+    TileCache() {}
+    void evictToBudget();
+    void removeEntry(EntryList::iterator it);
+
+    android::Mutex lock;
+    EntryList entries;
+    std::unordered_map<Key, EntryList::iterator, KeyHash> index;
+    size_t budget = 0;
+    size_t bytes = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+};
+
+#endif
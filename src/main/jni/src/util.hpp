@@ -10,6 +10,8 @@ extern "C" {
 
 #define JNI_FUNC(retType, bindClass, name)  JNIEXPORT retType JNICALL Java_com_shockwave_pdfium_##bindClass##_##name
 #define JNI_ARGS    JNIEnv *env, jobject thiz
+//Entry of RegisterNatives table bound to function defined with JNI_FUNC
+#define JNI_METHOD(bindClass, name, signature)  { #name, signature, (void*) Java_com_shockwave_pdfium_##bindClass##_##name }
 
 #define LOG_TAG "jniPdfium"
 #define LOGI(...)   __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -0,0 +1,87 @@
+#include "bitmapUtil.hpp"
+
+#include <cpu-features.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+/*
+ * Throughput of RGB_565 row kernels on a 1080x1920 frame, scalar against the SIMD kernel
+ * of host CPU. Usage: bitmapUtilBenchmark [iterations]
+ */
+
+static const int WIDTH = 1080;
+static const int HEIGHT = 1920;
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint16_t sink = 0;
+
+template <typename Convert>
+static void measure(const char *name, int iterations, Convert convert) {
+    convert();
+    double start = nowSeconds();
+    for (int i = 0; i < iterations; i++) {
+        convert();
+    }
+    double seconds = nowSeconds() - start;
+    printf("%-16s %8.1f Mpx/s %8.3f ms/frame\n", name,
+           (double) WIDTH * HEIGHT * iterations / seconds / 1e6, seconds * 1000 / iterations);
+}
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 50;
+    if (iterations <= 0) iterations = 50;
+
+    std::vector<uint8_t> src((size_t) WIDTH * HEIGHT * 3);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = (uint8_t) rand();
+    }
+    std::vector<uint16_t> dst((size_t) WIDTH * HEIGHT);
+    const uint8_t *source = &src[0];
+    uint16_t *dest = &dst[0];
+
+    struct Kernel {
+        const char *name;
+        RowTo565 convert;
+        RowTo565Dither convertDither;
+    };
+    std::vector<Kernel> kernels;
+    Kernel scalar = { "scalar", &rowTo565Scalar, &rowTo565DitherScalar };
+    kernels.push_back(scalar);
+#if defined(HAVE_ROW_TO_565_SSSE3)
+    Kernel simd = { "ssse3", &rowTo565Ssse3, &rowTo565DitherSsse3 };
+    if (android_getCpuFeatures() & ANDROID_CPU_X86_FEATURE_SSSE3) kernels.push_back(simd);
+#elif defined(HAVE_ROW_TO_565_NEON)
+    Kernel simd = { "neon", &rowTo565Neon, &rowTo565DitherNeon };
+    kernels.push_back(simd);
+#endif
+
+    for (size_t k = 0; k < kernels.size(); k++) {
+        const Kernel &kernel = kernels[k];
+        char name[32];
+
+        snprintf(name, sizeof(name), "%s", kernel.name);
+        measure(name, iterations, [&]() {
+            for (int y = 0; y < HEIGHT; y++) {
+                kernel.convert(source + (size_t) y * WIDTH * 3, dest + (size_t) y * WIDTH, WIDTH);
+            }
+            sink ^= dest[WIDTH * HEIGHT / 2];
+        });
+
+        snprintf(name, sizeof(name), "%s dither", kernel.name);
+        measure(name, iterations, [&]() {
+            for (int y = 0; y < HEIGHT; y++) {
+                kernel.convertDither(source + (size_t) y * WIDTH * 3, dest + (size_t) y * WIDTH,
+                                     WIDTH, 0, y);
+            }
+            sink ^= dest[WIDTH * HEIGHT / 2];
+        });
+    }
+    return sink == 0xFFFF ? 1 : 0;
+}
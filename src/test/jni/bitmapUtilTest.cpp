@@ -0,0 +1,145 @@
+#include "bitmapUtil.hpp"
+
+#include <cpu-features.h>
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <vector>
+
+//Same CPU checks as runtime dispatch, kernels are only compiled for their architecture
+#if defined(HAVE_ROW_TO_565_SSSE3)
+static const RowTo565 simdRowTo565 = &rowTo565Ssse3;
+static const RowTo565Dither simdRowTo565Dither = &rowTo565DitherSsse3;
+static bool hasSimdKernel() {
+    return (android_getCpuFeatures() & ANDROID_CPU_X86_FEATURE_SSSE3) != 0;
+}
+#elif defined(HAVE_ROW_TO_565_NEON)
+static const RowTo565 simdRowTo565 = &rowTo565Neon;
+static const RowTo565Dither simdRowTo565Dither = &rowTo565DitherNeon;
+static bool hasSimdKernel() {
+    return android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM64
+           || (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0;
+}
+#else
+static const RowTo565 simdRowTo565 = &rowTo565Scalar;
+static const RowTo565Dither simdRowTo565Dither = &rowTo565DitherScalar;
+static bool hasSimdKernel() {
+    return false;
+}
+#endif
+
+//Widths cover empty rows, tails shorter than one block and several blocks with tails
+static const int MAX_WIDTH = 100;
+//Written past end of row, kernels must leave it untouched
+static const uint16_t GUARD = 0xA5A5;
+
+static std::vector<uint8_t> randomPixels(int count, unsigned seed) {
+    std::vector<uint8_t> pixels(count * 3);
+    srand(seed);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = (uint8_t) (rand() & 0xFF);
+    }
+    return pixels;
+}
+
+class RowKernelTest : public ::testing::Test {
+    protected:
+    void SetUp() override {
+        if (!hasSimdKernel()) GTEST_SKIP() << "No SIMD kernel for this CPU";
+    }
+};
+
+TEST_F(RowKernelTest, ConvertMatchesScalar) {
+    //Source offset makes loads unaligned
+    std::vector<uint8_t> src = randomPixels(MAX_WIDTH + 3, 1);
+    for (int offset = 0; offset < 3; offset++) {
+        for (int width = 0; width <= MAX_WIDTH; width++) {
+            std::vector<uint16_t> expected(width + 1, GUARD);
+            std::vector<uint16_t> actual(width + 1, GUARD);
+            rowTo565Scalar(&src[offset], &expected[0], width);
+            simdRowTo565(&src[offset], &actual[0], width);
+            ASSERT_EQ(expected, actual) << "width " << width << ", offset " << offset;
+        }
+    }
+}
+
+TEST_F(RowKernelTest, DitherMatchesScalar) {
+    std::vector<uint8_t> src = randomPixels(MAX_WIDTH, 2);
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            for (int width = 0; width <= MAX_WIDTH; width++) {
+                std::vector<uint16_t> expected(width + 1, GUARD);
+                std::vector<uint16_t> actual(width + 1, GUARD);
+                rowTo565DitherScalar(&src[0], &expected[0], width, x, y);
+                simdRowTo565Dither(&src[0], &actual[0], width, x, y);
+                ASSERT_EQ(expected, actual) << "width " << width << " at " << x << ", " << y;
+            }
+        }
+    }
+}
+
+TEST_F(RowKernelTest, EveryChannelValueMatchesScalar) {
+    //Each row holds 256 gray levels shifted per channel, dither saturates near 255
+    const int width = 256;
+    std::vector<uint8_t> src(width * 3);
+    for (int shift = 0; shift < 3; shift++) {
+        for (int i = 0; i < width; i++) {
+            src[i * 3] = (uint8_t) i;
+            src[i * 3 + 1] = (uint8_t) (i + shift * 85);
+            src[i * 3 + 2] = (uint8_t) (255 - i);
+        }
+        std::vector<uint16_t> expected(width), actual(width);
+        rowTo565Scalar(&src[0], &expected[0], width);
+        simdRowTo565(&src[0], &actual[0], width);
+        ASSERT_EQ(expected, actual);
+
+        for (int y = 0; y < 4; y++) {
+            rowTo565DitherScalar(&src[0], &expected[0], width, 0, y);
+            simdRowTo565Dither(&src[0], &actual[0], width, 0, y);
+            ASSERT_EQ(expected, actual) << "row " << y;
+        }
+    }
+}
+
+TEST(BitmapTo565Test, MatchesScalarPerPixel) {
+    const int width = 37, height = 11, srcStride = width * 3 + 5, dstStride = width + 3;
+    std::vector<uint8_t> src = randomPixels(srcStride * height / 3 + 1, 3);
+    std::vector<uint16_t> dst(dstStride * height, GUARD);
+    rgbBitmapTo565(&src[0], srcStride, &dst[0], dstStride * 2, width, height);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            rgb *color = (rgb*) &src[y * srcStride + x * 3];
+            ASSERT_EQ(rgbTo565(color), dst[y * dstStride + x]) << x << ", " << y;
+        }
+        for (int x = width; x < dstStride; x++) {
+            ASSERT_EQ(GUARD, dst[y * dstStride + x]);
+        }
+    }
+}
+
+TEST(BitmapTo565Test, DitherPatternStaysAlignedAcrossTiles) {
+    //Converting bitmap in tiles with their origins must equal converting it at once
+    const int width = 50, height = 23, tile = 16;
+    std::vector<uint8_t> src = randomPixels(width * height, 4);
+    std::vector<uint16_t> whole(width * height), tiled(width * height);
+    rgbBitmapTo565Dither(&src[0], width * 3, &whole[0], width * 2, width, height, 0, 0);
+
+    for (int y = 0; y < height; y += tile) {
+        for (int x = 0; x < width; x += tile) {
+            int tileWidth = x + tile > width ? width - x : tile;
+            int tileHeight = y + tile > height ? height - y : tile;
+            rgbBitmapTo565Dither(&src[(y * width + x) * 3], width * 3,
+                                 &tiled[y * width + x], width * 2,
+                                 tileWidth, tileHeight, x, y);
+        }
+    }
+    ASSERT_EQ(whole, tiled);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            rgb *color = (rgb*) &src[(y * width + x) * 3];
+            ASSERT_EQ(rgbTo565Dither(color, x, y), whole[y * width + x]) << x << ", " << y;
+        }
+    }
+}
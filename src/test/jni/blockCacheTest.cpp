@@ -0,0 +1,143 @@
+#include "blockCache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+/*
+ * BlockCache over in-memory source which records every read, so tests can tell hits,
+ * which do not reach the source, from misses and read-ahead.
+ */
+
+static const size_t BLOCK_SIZE = 16;
+static const uint64_t FILE_SIZE = 10 * BLOCK_SIZE + 5;
+
+static uint8_t byteAt(uint64_t offset) {
+    return (uint8_t) (offset * 7 + 3);
+}
+
+struct Read {
+    uint64_t position;
+    size_t size;
+};
+
+class RecordingSource : public DataSource {
+    public:
+    RecordingSource(std::vector<Read> *reads) : reads(reads) {}
+
+    virtual long read(uint64_t position, uint8_t *buffer, size_t size) {
+        reads->push_back({ position, size });
+        if (position >= FILE_SIZE) return 0;
+        if (size > FILE_SIZE - position) size = (size_t) (FILE_SIZE - position);
+        for (size_t i = 0; i < size; i++) {
+            buffer[i] = byteAt(position + i);
+        }
+        return (long) size;
+    }
+
+    private:
+    std::vector<Read> *reads;
+};
+
+class BlockCacheTest : public ::testing::Test {
+    protected:
+    void TearDown() override {
+        delete cache;
+    }
+
+    void open(int maxBlocks, int readAheadBlocks) {
+        BlockCache::Config config = { BLOCK_SIZE, maxBlocks, readAheadBlocks };
+        cache = new BlockCache(new RecordingSource(&reads), FILE_SIZE, config);
+    }
+
+    //Reads range through cache and checks its bytes
+    void expectRead(uint64_t position, size_t size) {
+        std::vector<uint8_t> buffer(size);
+        ASSERT_TRUE(cache->read(position, &buffer[0], size));
+        for (size_t i = 0; i < size; i++) {
+            ASSERT_EQ(byteAt(position + i), buffer[i]) << "at " << position + i;
+        }
+    }
+
+    BlockCache *cache = NULL;
+    std::vector<Read> reads;
+};
+
+TEST_F(BlockCacheTest, RepeatedReadIsServedFromCache) {
+    open(4, 0);
+    expectRead(3, 10);
+    expectRead(5, 4);
+
+    ASSERT_EQ(1u, reads.size());
+    EXPECT_EQ(0u, reads[0].position);
+    EXPECT_EQ(BLOCK_SIZE, reads[0].size);
+
+    BlockCache::Stats stats = cache->getStats();
+    EXPECT_EQ(2u, stats.requests);
+    EXPECT_EQ(1u, stats.blockHits);
+    EXPECT_EQ(1u, stats.blockMisses);
+    EXPECT_EQ(BLOCK_SIZE, stats.bytesRead);
+}
+
+TEST_F(BlockCacheTest, ReadAcrossBlocksFetchesEach) {
+    open(4, 0);
+    expectRead(BLOCK_SIZE - 2, BLOCK_SIZE);
+
+    BlockCache::Stats stats = cache->getStats();
+    EXPECT_EQ(1u, stats.requests);
+    EXPECT_EQ(2u, stats.blockMisses);
+}
+
+TEST_F(BlockCacheTest, LeastRecentlyUsedBlockIsEvicted) {
+    open(2, 0);
+    expectRead(0, 1);
+    expectRead(4 * BLOCK_SIZE, 1);
+    //Touch block 0, so block 4 is the least recently used one
+    expectRead(1, 1);
+    expectRead(8 * BLOCK_SIZE, 1);
+    ASSERT_EQ(3u, reads.size());
+
+    expectRead(2, 1);
+    EXPECT_EQ(3u, reads.size());
+    expectRead(4 * BLOCK_SIZE + 1, 1);
+    ASSERT_EQ(4u, reads.size());
+    EXPECT_EQ(4 * BLOCK_SIZE, reads[3].position);
+
+    BlockCache::Stats stats = cache->getStats();
+    EXPECT_EQ(2u, stats.blockHits);
+    EXPECT_EQ(4u, stats.blockMisses);
+}
+
+TEST_F(BlockCacheTest, SequentialMissesReadAhead) {
+    open(8, 3);
+    expectRead(0, 1);
+    expectRead(BLOCK_SIZE, 1);
+
+    //Second consecutive miss reads blocks 1 to 4 in one call
+    ASSERT_EQ(2u, reads.size());
+    EXPECT_EQ(BLOCK_SIZE, reads[1].position);
+    EXPECT_EQ(4 * BLOCK_SIZE, reads[1].size);
+    expectRead(2 * BLOCK_SIZE, 3 * BLOCK_SIZE);
+    EXPECT_EQ(2u, reads.size());
+
+    BlockCache::Stats stats = cache->getStats();
+    EXPECT_EQ(3u, stats.readAheadBlocks);
+    EXPECT_EQ(3u, stats.blockHits);
+}
+
+TEST_F(BlockCacheTest, ReadAheadStopsAtEndOfFile) {
+    open(8, 4);
+    expectRead(8 * BLOCK_SIZE, 1);
+    expectRead(9 * BLOCK_SIZE, BLOCK_SIZE + 5);
+
+    ASSERT_EQ(2u, reads.size());
+    EXPECT_EQ(BLOCK_SIZE + 5, reads[1].size);
+}
+
+TEST_F(BlockCacheTest, ReadPastEndOfFileFails) {
+    open(4, 0);
+    uint8_t buffer[8];
+    EXPECT_FALSE(cache->read(FILE_SIZE - 4, buffer, sizeof(buffer)));
+    EXPECT_FALSE(cache->read(FILE_SIZE + 1, buffer, 1));
+    EXPECT_TRUE(reads.empty());
+}
@@ -0,0 +1,126 @@
+#include "coordinateMap.hpp"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+/*
+ * Points per second of mapping page points to device one PDFium call per point, as
+ * mapPageCoordsToDevice does, against one PageTransform batch over the same points.
+ * Fake PDFium below does only the arithmetic of the mapping, so per-point numbers are
+ * a lower bound of the real calls. Usage: coordinateMapBenchmark [iterations]
+ */
+
+static const int POINTS = 100000;
+static const double PAGE_WIDTH = 612;
+static const double PAGE_HEIGHT = 792;
+
+//Viewport position of page point as fractions u, v of viewport, for each rotation
+static void pageToUnit(int rotate, double x, double y, double *u, double *v) {
+    double px = x / PAGE_WIDTH, py = y / PAGE_HEIGHT;
+    switch (rotate) {
+        case 1: *u = py; *v = px; break;
+        case 2: *u = 1 - px; *v = py; break;
+        case 3: *u = 1 - py; *v = 1 - px; break;
+        default: *u = px; *v = 1 - py; break;
+    }
+}
+
+static void unitToPage(int rotate, double u, double v, double *x, double *y) {
+    double px, py;
+    switch (rotate) {
+        case 1: px = v; py = u; break;
+        case 2: px = 1 - u; py = v; break;
+        case 3: px = 1 - v; py = 1 - u; break;
+        default: px = u; py = 1 - v; break;
+    }
+    *x = px * PAGE_WIDTH;
+    *y = py * PAGE_HEIGHT;
+}
+
+void FPDF_DeviceToPage(FPDF_PAGE page, int start_x, int start_y, int size_x, int size_y,
+                       int rotate, int device_x, int device_y, double *page_x, double *page_y) {
+    unitToPage(rotate, (double) (device_x - start_x) / size_x,
+               (double) (device_y - start_y) / size_y, page_x, page_y);
+}
+
+void FPDF_PageToDevice(FPDF_PAGE page, int start_x, int start_y, int size_x, int size_y,
+                       int rotate, double page_x, double page_y, int *device_x, int *device_y) {
+    double u, v;
+    pageToUnit(rotate, page_x, page_y, &u, &v);
+    *device_x = start_x + (int) lround(u * size_x);
+    *device_y = start_y + (int) lround(v * size_y);
+}
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+template <typename Map>
+static double measure(const char *name, int iterations, Map map) {
+    map();
+    double start = nowSeconds();
+    for (int i = 0; i < iterations; i++) {
+        map();
+    }
+    double seconds = nowSeconds() - start;
+    double nsPerPoint = seconds * 1e9 / ((double) POINTS * iterations);
+    printf("%-22s %8.2f ns/point\n", name, nsPerPoint);
+    return nsPerPoint;
+}
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 50;
+    if (iterations <= 0) iterations = 50;
+
+    FPDF_PAGE page = reinterpret_cast<FPDF_PAGE>(&iterations);
+    const int startX = 10, startY = 20, sizeX = 1080, sizeY = 1400;
+
+    std::vector<float> points((size_t) POINTS * 2);
+    for (int i = 0; i < POINTS; i++) {
+        points[i * 2] = (float) (rand() % 6120) / 10;
+        points[i * 2 + 1] = (float) (rand() % 7920) / 10;
+    }
+    std::vector<float> batch(points.size());
+    std::vector<float> single(points.size());
+
+    for (int rotate = 0; rotate < 4; rotate++) {
+        printf("rotate %d\n", rotate);
+        PageTransform toDevice, toPage;
+        if (!PageTransform::fromViewport(page, startX, startY, sizeX, sizeY, rotate,
+                                         &toDevice, &toPage)) {
+            fprintf(stderr, "Cannot derive transform\n");
+            return 1;
+        }
+
+        double perPoint = measure("per point", iterations, [&]() {
+            for (int i = 0; i < POINTS; i++) {
+                int x, y;
+                FPDF_PageToDevice(page, startX, startY, sizeX, sizeY, rotate,
+                                  points[i * 2], points[i * 2 + 1], &x, &y);
+                single[i * 2] = (float) x;
+                single[i * 2 + 1] = (float) y;
+            }
+        });
+        double batched = measure("batch", iterations, [&]() {
+            toDevice.apply(&points[0], &batch[0], POINTS);
+        });
+
+        //Per-point API rounds to whole pixels, batch keeps fractions
+        double maxError = 0;
+        for (size_t i = 0; i < points.size(); i++) {
+            maxError = fmax(maxError, fabs(batch[i] - single[i]));
+        }
+        printf("%-22s %8.1fx, max difference %.3f px\n", "speedup", perPoint / batched,
+               maxError);
+        if (maxError > 0.51) {
+            fprintf(stderr, "Batch mapping differs from PDFium mapping\n");
+            return 1;
+        }
+    }
+    return 0;
+}
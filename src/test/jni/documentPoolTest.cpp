@@ -0,0 +1,168 @@
+#include "documentPool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/*
+ * DocumentPool over documents without PDFium handle. Every document owns duplicate of
+ * descriptor of one temporary file, so test tells it was destroyed by its descriptor
+ * being closed.
+ */
+
+class DocumentPoolTest : public ::testing::Test {
+    protected:
+    void SetUp() override {
+        char path[] = "/tmp/documentPoolTestXXXXXX";
+        fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        unlink(path);
+        ASSERT_EQ(4, write(fd, "%PDF", 4));
+        config = { 0, 0, 0 };
+    }
+
+    void TearDown() override {
+        //Pool is process wide, leave it disabled and empty for next test
+        DocumentPool::instance().setLimits(0, 0);
+        close(fd);
+    }
+
+    DocumentPool::Key key(const char *password, const BlockCache::Config &cacheConfig) {
+        DocumentPool::Key result;
+        EXPECT_TRUE(DocumentPool::makeKey(fd, password, ACCESS_PREAD, cacheConfig, &result));
+        return result;
+    }
+
+    DocumentFile* newDocument() {
+        DocumentFile *doc = new DocumentFile();
+        doc->fileFd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        doc->ownsFd = true;
+        return doc;
+    }
+
+    static bool isAlive(int docFd) {
+        return fcntl(docFd, F_GETFD) != -1;
+    }
+
+    int fd = -1;
+    BlockCache::Config config;
+};
+
+TEST_F(DocumentPoolTest, SameFileIsOpenedOnce) {
+    DocumentPool &pool = DocumentPool::instance();
+    pool.setLimits(2, 0);
+    DocumentPool::Stats before = pool.getStats();
+    DocumentPool::Key first = key(NULL, config);
+
+    EXPECT_EQ(NULL, pool.acquire(first));
+    DocumentFile *doc = newDocument();
+    ASSERT_TRUE(pool.add(first, doc));
+
+    EXPECT_EQ(doc, pool.acquire(key(NULL, config)));
+    //Counters are process wide, other tests of this binary add to them
+    DocumentPool::Stats stats = pool.getStats();
+    EXPECT_EQ(before.acquires + 2, stats.acquires);
+    EXPECT_EQ(before.hits + 1, stats.hits);
+    EXPECT_EQ(before.misses + 1, stats.misses);
+    EXPECT_EQ(1, stats.documents);
+
+    EXPECT_TRUE(pool.release(doc));
+    EXPECT_TRUE(pool.release(doc));
+}
+
+TEST_F(DocumentPoolTest, DocumentIsKeptUntilLastReferenceAndIdle) {
+    DocumentPool &pool = DocumentPool::instance();
+    pool.setLimits(2, 0);
+    DocumentPool::Key docKey = key(NULL, config);
+    DocumentFile *doc = newDocument();
+    int docFd = doc->fileFd;
+    ASSERT_TRUE(pool.add(docKey, doc));
+    ASSERT_EQ(doc, pool.acquire(docKey));
+
+    EXPECT_TRUE(pool.release(doc));
+    EXPECT_EQ(0, pool.getStats().idleDocuments);
+    EXPECT_TRUE(pool.release(doc));
+    EXPECT_EQ(1, pool.getStats().idleDocuments);
+    EXPECT_TRUE(isAlive(docFd));
+
+    //Idle document is handed out again
+    EXPECT_EQ(doc, pool.acquire(docKey));
+    EXPECT_TRUE(pool.release(doc));
+
+    pool.clear();
+    EXPECT_FALSE(isAlive(docFd));
+    EXPECT_EQ(0, pool.getStats().documents);
+}
+
+TEST_F(DocumentPoolTest, UnpooledDocumentIsNotReleased) {
+    DocumentPool &pool = DocumentPool::instance();
+    pool.setLimits(2, 0);
+    DocumentFile *doc = newDocument();
+    EXPECT_FALSE(pool.release(doc));
+    delete doc;
+}
+
+TEST_F(DocumentPoolTest, DifferentPasswordEvictsIdleDocument) {
+    DocumentPool &pool = DocumentPool::instance();
+    pool.setLimits(1, 0);
+    uint64_t evictions = pool.getStats().evictions;
+    DocumentPool::Key firstKey = key("first", config);
+    DocumentFile *first = newDocument();
+    int firstFd = first->fileFd;
+    ASSERT_TRUE(pool.add(firstKey, first));
+    ASSERT_TRUE(pool.release(first));
+
+    DocumentPool::Key secondKey = key("second", config);
+    EXPECT_EQ(NULL, pool.acquire(secondKey));
+    EXPECT_EQ(NULL, pool.acquire(key(NULL, config)));
+    DocumentFile *second = newDocument();
+    ASSERT_TRUE(pool.add(secondKey, second));
+
+    EXPECT_FALSE(isAlive(firstFd));
+    EXPECT_EQ(evictions + 1, pool.getStats().evictions);
+    EXPECT_EQ(second, pool.acquire(secondKey));
+    EXPECT_TRUE(pool.release(second));
+    EXPECT_TRUE(pool.release(second));
+}
+
+TEST_F(DocumentPoolTest, DifferentCacheConfigEvictsOnlyIdleDocument) {
+    DocumentPool &pool = DocumentPool::instance();
+    pool.setLimits(1, 0);
+    DocumentPool::Key firstKey = key(NULL, config);
+    DocumentFile *first = newDocument();
+    int firstFd = first->fileFd;
+    ASSERT_TRUE(pool.add(firstKey, first));
+
+    BlockCache::Config otherConfig = { 4096, 8, 2 };
+    DocumentPool::Key otherKey = key(NULL, otherConfig);
+    EXPECT_EQ(NULL, pool.acquire(otherKey));
+
+    //Documents in use are never evicted, so new one stays private to its opener
+    DocumentFile *other = newDocument();
+    EXPECT_FALSE(pool.add(otherKey, other));
+    EXPECT_TRUE(isAlive(firstFd));
+    EXPECT_FALSE(pool.release(other));
+    delete other;
+
+    ASSERT_TRUE(pool.release(first));
+    other = newDocument();
+    ASSERT_TRUE(pool.add(otherKey, other));
+    EXPECT_FALSE(isAlive(firstFd));
+    EXPECT_EQ(NULL, pool.acquire(firstKey));
+    EXPECT_TRUE(pool.release(other));
+}
+
+TEST_F(DocumentPoolTest, IdleDocumentTimesOut) {
+    DocumentPool &pool = DocumentPool::instance();
+    pool.setLimits(2, 1);
+    DocumentFile *doc = newDocument();
+    int docFd = doc->fileFd;
+    ASSERT_TRUE(pool.add(key(NULL, config), doc));
+    ASSERT_TRUE(pool.release(doc));
+
+    usleep(5000);
+    pool.trim();
+    EXPECT_FALSE(isAlive(docFd));
+}
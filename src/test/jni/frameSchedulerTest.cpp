@@ -0,0 +1,171 @@
+#include "frameScheduler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <time.h>
+
+#include <vector>
+
+/*
+ * FrameScheduler over fake progressive PDFium render. Page N takes steps[N] steps of
+ * STEP_NS each and checks for pause after every step, like PDFium does between page
+ * objects, so tests control which jobs fit before frame deadline.
+ */
+
+static const int64_t STEP_NS = 100000;
+static const int64_t MS = 1000000;
+
+struct FakePage {
+    int stepsLeft;
+};
+
+static std::vector<int> sSteps;
+static int sBitmap;
+
+static int64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+FPDF_PAGE FPDF_LoadPage(FPDF_DOCUMENT document, int page_index) {
+    if (page_index < 0 || page_index >= (int) sSteps.size()) return NULL;
+    FakePage *page = new FakePage();
+    page->stepsLeft = sSteps[page_index];
+    return page;
+}
+
+void FPDF_ClosePage(FPDF_PAGE page) {
+    delete reinterpret_cast<FakePage*>(page);
+}
+
+FPDF_BITMAP FPDFBitmap_CreateEx(int width, int height, int format, void *first_scan,
+                                int stride) {
+    return &sBitmap;
+}
+
+void FPDFBitmap_FillRect(FPDF_BITMAP bitmap, int left, int top, int width, int height,
+                         FPDF_DWORD color) {
+}
+
+void FPDFBitmap_Destroy(FPDF_BITMAP bitmap) {
+}
+
+int FPDF_RenderPage_Continue(FPDF_PAGE handle, IFSDK_PAUSE *pause) {
+    FakePage *page = reinterpret_cast<FakePage*>(handle);
+    while (page->stepsLeft > 0) {
+        int64_t stepEnd = nowNs() + STEP_NS;
+        while (nowNs() < stepEnd) {
+        }
+        page->stepsLeft--;
+        if (page->stepsLeft > 0 && pause->NeedToPauseNow(pause)) {
+            return FPDF_RENDER_TOBECOUNTINUED;
+        }
+    }
+    return FPDF_RENDER_DONE;
+}
+
+int FPDF_RenderPageBitmap_Start(FPDF_BITMAP bitmap, FPDF_PAGE page, int start_x, int start_y,
+                                int size_x, int size_y, int rotate, int flags,
+                                IFSDK_PAUSE *pause) {
+    return FPDF_RenderPage_Continue(page, pause);
+}
+
+void FPDF_RenderPage_Close(FPDF_PAGE page) {
+}
+
+class FrameSchedulerTest : public ::testing::Test {
+    protected:
+    void TearDown() override {
+        for (size_t i = 0; i < jobs.size(); i++) {
+            delete jobs[i];
+        }
+    }
+
+    RenderJob* addJob(int pageIndex) {
+        RenderJob *job = new RenderJob(NULL, pageIndex, false, 8, 8, 0, 0, 8, 8, 0, MS);
+        jobs.push_back(job);
+        return job;
+    }
+
+    int renderFrame(int64_t budgetNs) {
+        return scheduler.renderFrame(&jobs[0], (int) jobs.size(), nowNs() + budgetNs);
+    }
+
+    FrameScheduler scheduler;
+    std::vector<RenderJob*> jobs;
+};
+
+TEST_F(FrameSchedulerTest, JobsWhichFitFinishInOneFrame) {
+    sSteps = { 3, 5 };
+    addJob(0);
+    addJob(1);
+
+    EXPECT_EQ(0, renderFrame(500 * MS));
+    EXPECT_EQ(FPDF_RENDER_DONE, jobs[0]->getStatus());
+    EXPECT_EQ(FPDF_RENDER_DONE, jobs[1]->getStatus());
+}
+
+TEST_F(FrameSchedulerTest, UnfinishedJobsAreCountedAndContinueNextFrame) {
+    //Short job finishes in its first slice, long ones need many frames
+    sSteps = { 2000, 1, 2000 };
+    addJob(0);
+    addJob(1);
+    addJob(2);
+
+    EXPECT_EQ(2, renderFrame(5 * MS));
+    EXPECT_EQ(FPDF_RENDER_TOBECOUNTINUED, jobs[0]->getStatus());
+    EXPECT_EQ(FPDF_RENDER_DONE, jobs[1]->getStatus());
+    EXPECT_EQ(FPDF_RENDER_TOBECOUNTINUED, jobs[2]->getStatus());
+
+    EXPECT_EQ(2, renderFrame(5 * MS));
+    EXPECT_EQ(0, renderFrame(2000 * MS));
+    EXPECT_EQ(FPDF_RENDER_DONE, jobs[0]->getStatus());
+    EXPECT_EQ(FPDF_RENDER_DONE, jobs[2]->getStatus());
+}
+
+TEST_F(FrameSchedulerTest, JobCancelledBeforeFrameIsReportedCancelled) {
+    sSteps = { 3, 3 };
+    addJob(0);
+    RenderJob *cancelled = addJob(1);
+    cancelled->cancel();
+
+    EXPECT_EQ(0, renderFrame(500 * MS));
+    EXPECT_EQ(FPDF_RENDER_DONE, jobs[0]->getStatus());
+    EXPECT_EQ(RENDER_JOB_CANCELLED, cancelled->getStatus());
+}
+
+TEST_F(FrameSchedulerTest, JobCancelledBetweenFramesIsNotCountedIncomplete) {
+    sSteps = { 2000, 2000 };
+    RenderJob *cancelled = addJob(0);
+    addJob(1);
+
+    ASSERT_EQ(2, renderFrame(5 * MS));
+    ASSERT_EQ(FPDF_RENDER_TOBECOUNTINUED, cancelled->getStatus());
+    cancelled->cancel();
+
+    EXPECT_EQ(1, renderFrame(5 * MS));
+    EXPECT_EQ(RENDER_JOB_CANCELLED, cancelled->getStatus());
+    EXPECT_EQ(FPDF_RENDER_TOBECOUNTINUED, jobs[1]->getStatus());
+}
+
+TEST_F(FrameSchedulerTest, MissingJobsAreSkipped) {
+    sSteps = { 3 };
+    addJob(0);
+    jobs.push_back(NULL);
+
+    EXPECT_EQ(0, renderFrame(500 * MS));
+    EXPECT_EQ(FPDF_RENDER_DONE, jobs[0]->getStatus());
+}
+
+TEST_F(FrameSchedulerTest, FrameOverDeadlineIsTraced) {
+    sSteps = { 2000 };
+    addJob(0);
+
+    EXPECT_EQ(1, renderFrame(-MS));
+    FrameScheduler::Trace trace = scheduler.getTrace();
+    EXPECT_EQ(1u, trace.frames);
+    EXPECT_EQ(1u, trace.misses);
+    ASSERT_EQ(1u, trace.recent.size());
+    EXPECT_EQ(1, trace.recent[0].pendingJobs);
+}
@@ -0,0 +1,155 @@
+#include "pageGeometry.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fpdf_edit.h>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/*
+ * PageGeometry sidecar written for document file and mapped back, over fake PDFium
+ * document whose page sizes and rotations are functions of page index. Fake counts
+ * loaded pages, so test tells whether geometry came from sidecar or was measured.
+ */
+
+static const int PAGE_COUNT = 5;
+static const size_t FILE_SIZE = 200 * 1024;
+
+static int sPageCount = PAGE_COUNT;
+static int sLoadedPages = 0;
+static int sDocument;
+
+int FPDF_GetPageCount(FPDF_DOCUMENT document) {
+    return sPageCount;
+}
+
+int FPDF_GetPageSizeByIndex(FPDF_DOCUMENT document, int page_index, double *width,
+                            double *height) {
+    *width = 100 + page_index;
+    *height = 200 + page_index * 2;
+    return 1;
+}
+
+FPDF_PAGE FPDF_LoadPage(FPDF_DOCUMENT document, int page_index) {
+    sLoadedPages++;
+    return reinterpret_cast<FPDF_PAGE>((intptr_t) page_index + 1);
+}
+
+int FPDFPage_GetRotation(FPDF_PAGE page) {
+    return ((int) reinterpret_cast<intptr_t>(page) - 1) % 4;
+}
+
+void FPDF_ClosePage(FPDF_PAGE page) {
+}
+
+class PageGeometryTest : public ::testing::Test {
+    protected:
+    void SetUp() override {
+        char path[] = "/tmp/pageGeometryTestXXXXXX";
+        fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        unlink(path);
+        std::vector<uint8_t> data(FILE_SIZE);
+        for (size_t i = 0; i < FILE_SIZE; i++) {
+            data[i] = (uint8_t) (i * 13);
+        }
+        ASSERT_EQ((ssize_t) FILE_SIZE, write(fd, &data[0], FILE_SIZE));
+
+        char sidecar[] = "/tmp/pageGeometrySidecarXXXXXX";
+        int sidecarFd = mkstemp(sidecar);
+        ASSERT_GE(sidecarFd, 0);
+        close(sidecarFd);
+        sidecarPath = sidecar;
+
+        sPageCount = PAGE_COUNT;
+        sLoadedPages = 0;
+    }
+
+    void TearDown() override {
+        unlink(sidecarPath.c_str());
+        close(fd);
+    }
+
+    DocumentFile* openDocument() {
+        BlockCache::Config config = { 0, 0, 0 };
+        DocumentFile *doc = new DocumentFile();
+        doc->setFile(fd, FILE_SIZE, ACCESS_PREAD, config);
+        doc->pdfDocument = reinterpret_cast<FPDF_DOCUMENT>(&sDocument);
+        return doc;
+    }
+
+    void writeSidecar() {
+        DocumentFile *doc = openDocument();
+        PageGeometry *geometry = PageGeometry::compute(doc);
+        ASSERT_TRUE(geometry != NULL);
+        EXPECT_EQ(PAGE_COUNT, sLoadedPages);
+        EXPECT_TRUE(geometry->write(doc, sidecarPath.c_str()));
+        delete geometry;
+        delete doc;
+    }
+
+    int fd = -1;
+    std::string sidecarPath;
+};
+
+TEST_F(PageGeometryTest, SidecarIsReadBackWithoutLoadingPages) {
+    writeSidecar();
+    sLoadedPages = 0;
+
+    DocumentFile *doc = openDocument();
+    PageGeometry *geometry = PageGeometry::open(doc, sidecarPath.c_str());
+    ASSERT_TRUE(geometry != NULL);
+    EXPECT_EQ(0, sLoadedPages);
+
+    ASSERT_EQ(PAGE_COUNT, geometry->getPageCount());
+    const PageGeometry::Page *pages = geometry->getPages();
+    for (int i = 0; i < PAGE_COUNT; i++) {
+        EXPECT_EQ(100.0f + i, pages[i].width);
+        EXPECT_EQ(200.0f + i * 2, pages[i].height);
+        EXPECT_EQ(i % 4, pages[i].rotation);
+    }
+    delete geometry;
+    delete doc;
+}
+
+TEST_F(PageGeometryTest, SidecarOfChangedFileIsRejected) {
+    writeSidecar();
+
+    //Saving document rewrites its trailer, size stays the same here
+    uint8_t changed = 0xff;
+    ASSERT_EQ(1, pwrite(fd, &changed, 1, FILE_SIZE - 10));
+
+    DocumentFile *doc = openDocument();
+    EXPECT_EQ(NULL, PageGeometry::open(doc, sidecarPath.c_str()));
+    delete doc;
+}
+
+TEST_F(PageGeometryTest, SidecarWithOtherPageCountIsRejected) {
+    writeSidecar();
+    sPageCount = PAGE_COUNT + 1;
+
+    DocumentFile *doc = openDocument();
+    EXPECT_EQ(NULL, PageGeometry::open(doc, sidecarPath.c_str()));
+    delete doc;
+}
+
+TEST_F(PageGeometryTest, TruncatedSidecarIsRejected) {
+    writeSidecar();
+    ASSERT_EQ(0, truncate(sidecarPath.c_str(), 40));
+
+    DocumentFile *doc = openDocument();
+    EXPECT_EQ(NULL, PageGeometry::open(doc, sidecarPath.c_str()));
+    delete doc;
+}
+
+TEST_F(PageGeometryTest, MissingSidecarIsNotOpened) {
+    unlink(sidecarPath.c_str());
+    DocumentFile *doc = openDocument();
+    EXPECT_EQ(NULL, PageGeometry::open(doc, sidecarPath.c_str()));
+    delete doc;
+}
@@ -0,0 +1,228 @@
+#include "documentFile.hpp"
+#include "progressiveLoader.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fpdf_dataavail.h>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/*
+ * ProgressiveLoader over a file which another thread keeps appending to, with a fake
+ * FPDFAvail standing in for PDFium. The fake document has a header at the start, a
+ * trailer at the end and fixed size pages between, each needed before it is available.
+ * Every byte of file is a function of its offset, so the fake detects reads of data
+ * which was not written yet.
+ */
+
+static const uint64_t FILE_SIZE = 64 * 1024;
+static const uint64_t HEADER_SIZE = 1024;
+static const uint64_t TRAILER_SIZE = 1024;
+static const uint64_t PAGE_SIZE = 8 * 1024;
+static const int PAGE_COUNT = 7;
+
+static uint8_t byteAt(uint64_t offset) {
+    return (uint8_t) ((offset * 131 + 7) >> 3);
+}
+
+struct FakeAvail {
+    FX_FILEAVAIL *fileAvail;
+    FPDF_FILEACCESS loader;
+    int document;
+};
+
+//Checks range is present, reports it as needed otherwise
+static bool require(FakeAvail *avail, FX_DOWNLOADHINTS *hints, uint64_t offset, uint64_t size) {
+    if (avail->fileAvail->IsDataAvail(avail->fileAvail, offset, size)) return true;
+    if (hints != NULL) hints->AddSegment(hints, offset, size);
+    return false;
+}
+
+static bool readMatches(FakeAvail *avail, uint64_t offset, uint64_t size) {
+    std::vector<uint8_t> buffer(size);
+    if (!avail->loader.m_GetBlock(avail->loader.m_Param, offset, &buffer[0], size)) return false;
+    for (uint64_t i = 0; i < size; i++) {
+        if (buffer[i] != byteAt(offset + i)) return false;
+    }
+    return true;
+}
+
+FPDF_AVAIL FPDFAvail_Create(FX_FILEAVAIL *file_avail, FPDF_FILEACCESS *file) {
+    FakeAvail *avail = new FakeAvail();
+    avail->fileAvail = file_avail;
+    avail->loader = *file;
+    return avail;
+}
+
+void FPDFAvail_Destroy(FPDF_AVAIL avail) {
+    delete reinterpret_cast<FakeAvail*>(avail);
+}
+
+int FPDFAvail_IsDocAvail(FPDF_AVAIL handle, FX_DOWNLOADHINTS *hints) {
+    FakeAvail *avail = reinterpret_cast<FakeAvail*>(handle);
+    bool header = require(avail, hints, 0, HEADER_SIZE);
+    bool trailer = require(avail, hints, FILE_SIZE - TRAILER_SIZE, TRAILER_SIZE);
+    if (!header || !trailer) return PDF_DATA_NOTAVAIL;
+
+    if (!readMatches(avail, 0, HEADER_SIZE)
+            || !readMatches(avail, FILE_SIZE - TRAILER_SIZE, TRAILER_SIZE)) {
+        return PDF_DATA_ERROR;
+    }
+    return PDF_DATA_AVAIL;
+}
+
+int FPDFAvail_IsPageAvail(FPDF_AVAIL handle, int page_index, FX_DOWNLOADHINTS *hints) {
+    FakeAvail *avail = reinterpret_cast<FakeAvail*>(handle);
+    if (page_index < 0 || page_index >= PAGE_COUNT) return PDF_DATA_ERROR;
+
+    //Two overlapping hints per page, like PDFium reporting object and its stream
+    uint64_t start = HEADER_SIZE + (uint64_t) page_index * PAGE_SIZE;
+    bool first = require(avail, hints, start, PAGE_SIZE / 2 + 100);
+    bool second = require(avail, hints, start + PAGE_SIZE / 2, PAGE_SIZE / 2);
+    if (!first || !second) return PDF_DATA_NOTAVAIL;
+
+    return readMatches(avail, start, PAGE_SIZE) ? PDF_DATA_AVAIL : PDF_DATA_ERROR;
+}
+
+int FPDFAvail_IsLinearized(FPDF_AVAIL avail) {
+    return PDF_NOT_LINEARIZED;
+}
+
+FPDF_DOCUMENT FPDFAvail_GetDocument(FPDF_AVAIL handle, FPDF_BYTESTRING password) {
+    FakeAvail *avail = reinterpret_cast<FakeAvail*>(handle);
+    return &avail->document;
+}
+
+class ProgressiveLoaderTest : public ::testing::Test {
+    protected:
+    void SetUp() override {
+        char path[] = "/tmp/progressiveLoaderTestXXXXXX";
+        fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        unlink(path);
+
+        BlockCache::Config config = { 0, 0, 0 };
+        doc = new DocumentFile();
+        doc->setFile(fd, FILE_SIZE, ACCESS_PREAD, config);
+        doc->progressive = new ProgressiveLoader(doc);
+        ASSERT_TRUE(doc->progressive->isValid());
+    }
+
+    void TearDown() override {
+        delete doc;
+        if (fd >= 0) close(fd);
+    }
+
+    void append(uint64_t count) {
+        std::vector<uint8_t> data(count);
+        for (uint64_t i = 0; i < count; i++) {
+            data[i] = byteAt(written + i);
+        }
+        ASSERT_EQ((ssize_t) count, write(fd, &data[0], count));
+        written += count;
+    }
+
+    int fd = -1;
+    uint64_t written = 0;
+    DocumentFile *doc = NULL;
+};
+
+TEST_F(ProgressiveLoaderTest, NeededRangesSkipAvailableBytes) {
+    ProgressiveLoader *loader = doc->progressive;
+    append(600);
+    loader->setAvailableBytes(600);
+    ASSERT_EQ(PDF_DATA_NOTAVAIL, loader->isDocumentAvailable());
+
+    std::vector<uint64_t> expected = { 600, HEADER_SIZE - 600,
+                                       FILE_SIZE - TRAILER_SIZE, TRAILER_SIZE };
+    EXPECT_EQ(expected, loader->getNeededRanges());
+}
+
+TEST_F(ProgressiveLoaderTest, OverlappingHintsAreMerged) {
+    ProgressiveLoader *loader = doc->progressive;
+    append(HEADER_SIZE);
+    loader->setAvailableBytes(HEADER_SIZE);
+    ASSERT_EQ(PDF_DATA_NOTAVAIL, loader->isPageAvailable(2));
+
+    std::vector<uint64_t> expected = { HEADER_SIZE + 2 * PAGE_SIZE, PAGE_SIZE };
+    EXPECT_EQ(expected, loader->getNeededRanges());
+}
+
+TEST_F(ProgressiveLoaderTest, AvailableBytesAreClampedToFileSize) {
+    doc->progressive->setAvailableBytes(FILE_SIZE * 2);
+    EXPECT_EQ(FILE_SIZE, doc->progressive->getAvailableBytes());
+    EXPECT_TRUE(doc->progressive->isComplete());
+}
+
+TEST_F(ProgressiveLoaderTest, FollowsFileAppendedByAnotherThread) {
+    ProgressiveLoader *loader = doc->progressive;
+    std::atomic<bool> failed(false);
+
+    //Downloader appends in small chunks, reader polls size of file like an app would
+    std::thread writer([&]() {
+        while (written < FILE_SIZE) {
+            uint64_t chunk = FILE_SIZE - written < 1000 ? FILE_SIZE - written : 1000;
+            std::vector<uint8_t> data(chunk);
+            for (uint64_t i = 0; i < chunk; i++) {
+                data[i] = byteAt(written + i);
+            }
+            if (write(fd, &data[0], chunk) != (ssize_t) chunk) {
+                failed = true;
+                return;
+            }
+            written += chunk;
+            usleep(200);
+        }
+    });
+
+    int documentStatus = PDF_DATA_NOTAVAIL;
+    std::vector<int> pageStatus(PAGE_COUNT, PDF_DATA_NOTAVAIL);
+    int pagesAvailable = 0;
+    while (pagesAvailable < PAGE_COUNT && !failed) {
+        uint64_t available = (uint64_t) getFileSize(fd);
+        loader->setAvailableBytes(available);
+        EXPECT_EQ(available >= FILE_SIZE, doc->hasCompleteSource());
+
+        if (documentStatus != PDF_DATA_AVAIL) {
+            documentStatus = loader->isDocumentAvailable();
+            ASSERT_NE(PDF_DATA_ERROR, documentStatus) << "read unwritten data at " << available;
+            std::vector<uint64_t> ranges = loader->getNeededRanges();
+            for (size_t i = 0; i < ranges.size(); i += 2) {
+                EXPECT_GE(ranges[i], loader->getAvailableBytes());
+            }
+            if (documentStatus == PDF_DATA_AVAIL) {
+                doc->pdfDocument = loader->loadDocument(NULL);
+                ASSERT_TRUE(doc->pdfDocument != NULL);
+            }
+        }
+
+        //Pages may only be checked once document is loaded
+        for (int i = 0; i < PAGE_COUNT && doc->pdfDocument != NULL; i++) {
+            if (pageStatus[i] == PDF_DATA_AVAIL) continue;
+            pageStatus[i] = loader->isPageAvailable(i);
+            ASSERT_NE(PDF_DATA_ERROR, pageStatus[i]) << "page " << i << " at " << available;
+            if (pageStatus[i] == PDF_DATA_AVAIL) pagesAvailable++;
+        }
+        usleep(100);
+    }
+    writer.join();
+
+    ASSERT_FALSE(failed);
+    EXPECT_EQ(PDF_DATA_AVAIL, documentStatus);
+    EXPECT_TRUE(loader->isComplete());
+    EXPECT_TRUE(loader->getNeededRanges().empty());
+
+    //Loader reads through the descriptor, independent of how file was written
+    std::vector<uint8_t> tail(100);
+    ASSERT_TRUE(doc->read(FILE_SIZE - 100, &tail[0], 100));
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(byteAt(FILE_SIZE - 100 + i), tail[i]);
+    }
+}
@@ -0,0 +1,13 @@
+#ifndef _HOST_ANDROID_LOG_STUB_H_
+#define _HOST_ANDROID_LOG_STUB_H_
+
+enum {
+    ANDROID_LOG_DEBUG = 3,
+    ANDROID_LOG_INFO = 4,
+    ANDROID_LOG_WARN = 5,
+    ANDROID_LOG_ERROR = 6
+};
+
+extern "C" int __android_log_print(int prio, const char *tag, const char *fmt, ...);
+
+#endif
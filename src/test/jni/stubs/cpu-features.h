@@ -0,0 +1,45 @@
+#ifndef _HOST_CPU_FEATURES_STUB_H_
+#define _HOST_CPU_FEATURES_STUB_H_
+
+#include <stdint.h>
+
+/* Subset of NDK cpufeatures answered for the host CPU */
+typedef enum {
+    ANDROID_CPU_FAMILY_UNKNOWN = 0,
+    ANDROID_CPU_FAMILY_ARM,
+    ANDROID_CPU_FAMILY_X86,
+    ANDROID_CPU_FAMILY_MIPS,
+    ANDROID_CPU_FAMILY_ARM64,
+    ANDROID_CPU_FAMILY_X86_64
+} AndroidCpuFamily;
+
+enum {
+    ANDROID_CPU_ARM_FEATURE_NEON = 1 << 2,
+    ANDROID_CPU_X86_FEATURE_SSSE3 = 1 << 0
+};
+
+static inline AndroidCpuFamily android_getCpuFamily() {
+#if defined(__x86_64__)
+    return ANDROID_CPU_FAMILY_X86_64;
+#elif defined(__i386__)
+    return ANDROID_CPU_FAMILY_X86;
+#elif defined(__aarch64__)
+    return ANDROID_CPU_FAMILY_ARM64;
+#elif defined(__arm__)
+    return ANDROID_CPU_FAMILY_ARM;
+#else
+    return ANDROID_CPU_FAMILY_UNKNOWN;
+#endif
+}
+
+static inline uint64_t android_getCpuFeatures() {
+#if defined(__i386__) || defined(__x86_64__)
+    return __builtin_cpu_supports("ssse3") ? ANDROID_CPU_X86_FEATURE_SSSE3 : 0;
+#elif defined(__ARM_NEON)
+    return ANDROID_CPU_ARM_FEATURE_NEON;
+#else
+    return 0;
+#endif
+}
+
+#endif
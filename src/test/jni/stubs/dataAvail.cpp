@@ -0,0 +1,31 @@
+#include <fpdf_dataavail.h>
+#include <stddef.h>
+
+/*
+ * Availability entry points linked through DocumentFile, whose ProgressiveLoader is not
+ * used by most tests. Tests of progressive loading define their own fakes, which the
+ * linker takes before this archive member.
+ */
+
+FPDF_AVAIL FPDFAvail_Create(FX_FILEAVAIL *file_avail, FPDF_FILEACCESS *file) {
+    return NULL;
+}
+
+void FPDFAvail_Destroy(FPDF_AVAIL avail) {
+}
+
+int FPDFAvail_IsDocAvail(FPDF_AVAIL avail, FX_DOWNLOADHINTS *hints) {
+    return PDF_DATA_ERROR;
+}
+
+int FPDFAvail_IsPageAvail(FPDF_AVAIL avail, int page_index, FX_DOWNLOADHINTS *hints) {
+    return PDF_DATA_ERROR;
+}
+
+int FPDFAvail_IsLinearized(FPDF_AVAIL avail) {
+    return PDF_NOT_LINEARIZED;
+}
+
+FPDF_DOCUMENT FPDFAvail_GetDocument(FPDF_AVAIL avail, FPDF_BYTESTRING password) {
+    return NULL;
+}
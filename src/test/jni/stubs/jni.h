@@ -0,0 +1,45 @@
+#ifndef _HOST_JNI_STUB_H_
+#define _HOST_JNI_STUB_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Only what host built sources need from jni.h. Host tests never run inside a Java VM,
+ * so the few JNIEnv methods reachable from them report failure.
+ */
+#define JNIEXPORT
+#define JNICALL
+#define JNI_OK 0
+#define JNI_ERR (-1)
+#define JNI_TRUE 1
+#define JNI_FALSE 0
+
+typedef uint8_t jboolean;
+typedef int8_t jbyte;
+typedef uint16_t jchar;
+typedef int32_t jint;
+typedef int64_t jlong;
+typedef jint jsize;
+
+class _jobject {};
+class _jbyteArray : public _jobject {};
+typedef _jobject* jobject;
+typedef _jbyteArray* jbyteArray;
+struct _jmethodID;
+typedef _jmethodID* jmethodID;
+
+struct _JavaVM {
+};
+typedef _JavaVM JavaVM;
+
+struct _JNIEnv {
+    jint GetJavaVM(JavaVM **vm) { *vm = NULL; return JNI_ERR; }
+    jobject NewGlobalRef(jobject obj) { return NULL; }
+    void DeleteGlobalRef(jobject obj) {}
+    void* GetDirectBufferAddress(jobject buffer) { return NULL; }
+    jlong GetDirectBufferCapacity(jobject buffer) { return -1; }
+};
+typedef _JNIEnv JNIEnv;
+
+#endif
@@ -0,0 +1,32 @@
+#include <fpdfview.h>
+#include <stddef.h>
+
+/*
+ * Library and document entry points of PDFium used by DocumentFile. Documents are
+ * opaque handles created and owned by fakes of the test, closing them does nothing.
+ */
+
+static int sInitCount = 0;
+
+void FPDF_InitLibrary() {
+    sInitCount++;
+}
+
+void FPDF_DestroyLibrary() {
+    sInitCount--;
+}
+
+FPDF_DOCUMENT FPDF_LoadMemDocument(const void *data_buf, int size, FPDF_BYTESTRING password) {
+    return NULL;
+}
+
+FPDF_DOCUMENT FPDF_LoadCustomDocument(FPDF_FILEACCESS *pFileAccess, FPDF_BYTESTRING password) {
+    return NULL;
+}
+
+unsigned long FPDF_GetLastError() {
+    return FPDF_ERR_FORMAT;
+}
+
+void FPDF_CloseDocument(FPDF_DOCUMENT document) {
+}
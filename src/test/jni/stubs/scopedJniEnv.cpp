@@ -0,0 +1,8 @@
+#include "javaDataSource.hpp"
+
+/* Host tests have no Java VM, so there is never an environment to attach */
+ScopedJniEnv::ScopedJniEnv(JavaVM *vm) : vm(vm) {
+}
+
+ScopedJniEnv::~ScopedJniEnv() {
+}
@@ -0,0 +1,214 @@
+#include "textIndex.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fpdf_text.h>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/*
+ * TextIndex written for document file and mapped back, over fake fpdf_text.h whose
+ * pages hold ASCII text of sPages. Char offsets of hits index that text.
+ */
+
+static const size_t FILE_SIZE = 100 * 1024;
+
+static std::vector<std::string> sPages;
+static int sDocument;
+
+int FPDF_GetPageCount(FPDF_DOCUMENT document) {
+    return (int) sPages.size();
+}
+
+FPDF_PAGE FPDF_LoadPage(FPDF_DOCUMENT document, int page_index) {
+    if (page_index < 0 || page_index >= (int) sPages.size()) return NULL;
+    return reinterpret_cast<FPDF_PAGE>(&sPages[page_index]);
+}
+
+void FPDF_ClosePage(FPDF_PAGE page) {
+}
+
+FPDF_TEXTPAGE FPDFText_LoadPage(FPDF_PAGE page) {
+    return reinterpret_cast<FPDF_TEXTPAGE>(page);
+}
+
+void FPDFText_ClosePage(FPDF_TEXTPAGE text_page) {
+}
+
+int FPDFText_CountChars(FPDF_TEXTPAGE text_page) {
+    return (int) reinterpret_cast<std::string*>(text_page)->size();
+}
+
+int FPDFText_GetText(FPDF_TEXTPAGE text_page, int start_index, int count,
+                     unsigned short *result) {
+    const std::string &text = *reinterpret_cast<std::string*>(text_page);
+    for (int i = 0; i < count; i++) {
+        result[i] = (unsigned char) text[start_index + i];
+    }
+    result[count] = 0;
+    return count + 1;
+}
+
+class TextIndexTest : public ::testing::Test {
+    protected:
+    void SetUp() override {
+        char path[] = "/tmp/textIndexTestXXXXXX";
+        fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        unlink(path);
+        std::vector<uint8_t> data(FILE_SIZE);
+        for (size_t i = 0; i < FILE_SIZE; i++) {
+            data[i] = (uint8_t) (i * 7);
+        }
+        ASSERT_EQ((ssize_t) FILE_SIZE, write(fd, &data[0], FILE_SIZE));
+
+        char index[] = "/tmp/textIndexSidecarXXXXXX";
+        int indexFd = mkstemp(index);
+        ASSERT_GE(indexFd, 0);
+        close(indexFd);
+        indexPath = index;
+
+        sPages = {
+            "The quick brown fox",
+            "no match here",
+            "Quick, quick! Brown fox; zebra",
+        };
+    }
+
+    void TearDown() override {
+        unlink(indexPath.c_str());
+        close(fd);
+    }
+
+    DocumentFile* openDocument() {
+        BlockCache::Config config = { 0, 0, 0 };
+        DocumentFile *doc = new DocumentFile();
+        doc->setFile(fd, FILE_SIZE, ACCESS_PREAD, config);
+        doc->pdfDocument = reinterpret_cast<FPDF_DOCUMENT>(&sDocument);
+        return doc;
+    }
+
+    void writeIndex() {
+        DocumentFile *doc = openDocument();
+        EXPECT_TRUE(TextIndex::write(doc, indexPath.c_str()));
+        delete doc;
+    }
+
+    static bool find(const TextIndex *index, const char *query, int maxHits,
+                     std::vector<TextIndex::Hit> *hits) {
+        std::vector<uint16_t> chars(query, query + strlen(query));
+        return index->find(&chars[0], chars.size(), maxHits, hits);
+    }
+
+    static void expectHit(const TextIndex::Hit &hit, int pageIndex, int charIndex,
+                          int charCount) {
+        EXPECT_EQ(pageIndex, hit.pageIndex);
+        EXPECT_EQ(charIndex, hit.charIndex);
+        EXPECT_EQ(charCount, hit.charCount);
+    }
+
+    int fd = -1;
+    std::string indexPath;
+};
+
+TEST_F(TextIndexTest, WrittenIndexIsReadBack) {
+    writeIndex();
+
+    DocumentFile *doc = openDocument();
+    TextIndex *index = TextIndex::open(doc, indexPath.c_str());
+    ASSERT_TRUE(index != NULL);
+    EXPECT_EQ(3, index->getPageCount());
+
+    std::vector<TextIndex::Hit> hits;
+    ASSERT_TRUE(find(index, "QUICK", 0, &hits));
+    ASSERT_EQ(3u, hits.size());
+    expectHit(hits[0], 0, 4, 5);
+    expectHit(hits[1], 2, 0, 5);
+    expectHit(hits[2], 2, 7, 5);
+
+    //Phrase spans punctuation between its terms
+    ASSERT_TRUE(find(index, "quick brown", 0, &hits));
+    ASSERT_EQ(2u, hits.size());
+    expectHit(hits[0], 0, 4, 11);
+    expectHit(hits[1], 2, 7, 12);
+
+    ASSERT_TRUE(find(index, "fox brown", 0, &hits));
+    EXPECT_TRUE(hits.empty());
+    ASSERT_TRUE(find(index, "missing", 0, &hits));
+    EXPECT_TRUE(hits.empty());
+
+    delete index;
+    delete doc;
+}
+
+TEST_F(TextIndexTest, HitsAreTruncatedToMaxHits) {
+    writeIndex();
+
+    DocumentFile *doc = openDocument();
+    TextIndex *index = TextIndex::open(doc, indexPath.c_str());
+    ASSERT_TRUE(index != NULL);
+
+    std::vector<TextIndex::Hit> hits;
+    ASSERT_TRUE(find(index, "quick", 2, &hits));
+    ASSERT_EQ(2u, hits.size());
+    expectHit(hits[0], 0, 4, 5);
+    expectHit(hits[1], 2, 0, 5);
+
+    ASSERT_TRUE(find(index, "brown fox", 1, &hits));
+    ASSERT_EQ(1u, hits.size());
+    expectHit(hits[0], 0, 10, 9);
+
+    delete index;
+    delete doc;
+}
+
+TEST_F(TextIndexTest, IndexOfChangedFileIsRejected) {
+    writeIndex();
+
+    uint8_t changed = 0xff;
+    ASSERT_EQ(1, pwrite(fd, &changed, 1, FILE_SIZE - 10));
+
+    DocumentFile *doc = openDocument();
+    EXPECT_EQ(NULL, TextIndex::open(doc, indexPath.c_str()));
+    delete doc;
+}
+
+TEST_F(TextIndexTest, TruncatedIndexIsRejected) {
+    writeIndex();
+    struct stat st;
+    ASSERT_EQ(0, stat(indexPath.c_str(), &st));
+    ASSERT_EQ(0, truncate(indexPath.c_str(), st.st_size - 1));
+
+    DocumentFile *doc = openDocument();
+    EXPECT_EQ(NULL, TextIndex::open(doc, indexPath.c_str()));
+    delete doc;
+}
+
+TEST_F(TextIndexTest, CorruptedPostingsFailSearch) {
+    writeIndex();
+
+    //Postings are stored in term order, so last byte belongs to "zebra"
+    int indexFd = open(indexPath.c_str(), O_RDWR);
+    ASSERT_GE(indexFd, 0);
+    off_t size = lseek(indexFd, 0, SEEK_END);
+    uint8_t unterminated = 0x80;
+    ASSERT_EQ(1, pwrite(indexFd, &unterminated, 1, size - 1));
+    close(indexFd);
+
+    DocumentFile *doc = openDocument();
+    TextIndex *index = TextIndex::open(doc, indexPath.c_str());
+    ASSERT_TRUE(index != NULL);
+
+    std::vector<TextIndex::Hit> hits;
+    EXPECT_FALSE(find(index, "zebra", 0, &hits));
+    EXPECT_TRUE(find(index, "quick", 0, &hits));
+
+    delete index;
+    delete doc;
+}
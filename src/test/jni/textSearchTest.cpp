@@ -0,0 +1,266 @@
+#include "textSearch.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fpdf_text.h>
+
+#include <ctype.h>
+#include <functional>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * TextSearch over fake fpdf_text.h whose pages hold ASCII text of sPages. Fake search
+ * honours FPDF_MATCHCASE and FPDF_MATCHWHOLEWORD and gives every hit one rectangle of
+ * its char range on its page, so tests can tell hits apart by rectangles too.
+ */
+
+struct FakeTextPage {
+    int pageIndex;
+    const std::string *text;
+};
+
+struct FakeSearch {
+    std::vector<int> starts;
+    int count;
+    int current;
+};
+
+//Class constant has no definition to bind to references EXPECT_EQ takes
+static const int WINDOW = TextSearch::PAGES_PER_WINDOW;
+
+static std::vector<std::string> sPages;
+static std::function<void(int)> sOnLoadPage;
+static int sDocument;
+
+FPDF_PAGE FPDF_LoadPage(FPDF_DOCUMENT document, int page_index) {
+    if (page_index < 0 || page_index >= (int) sPages.size()) return NULL;
+    if (sOnLoadPage) sOnLoadPage(page_index);
+    FakeTextPage *page = new FakeTextPage();
+    page->pageIndex = page_index;
+    page->text = &sPages[page_index];
+    return page;
+}
+
+void FPDF_ClosePage(FPDF_PAGE page) {
+    delete reinterpret_cast<FakeTextPage*>(page);
+}
+
+FPDF_TEXTPAGE FPDFText_LoadPage(FPDF_PAGE page) {
+    return page;
+}
+
+void FPDFText_ClosePage(FPDF_TEXTPAGE text_page) {
+}
+
+static bool isWordChar(char c) {
+    return isalnum((unsigned char) c) != 0;
+}
+
+FPDF_SCHHANDLE FPDFText_FindStart(FPDF_TEXTPAGE text_page, FPDF_WIDESTRING findwhat,
+                                  unsigned long flags, int start_index) {
+    const std::string &text = *reinterpret_cast<FakeTextPage*>(text_page)->text;
+    std::string query;
+    for (const unsigned short *c = findwhat; *c != 0; c++) {
+        query.push_back((char) *c);
+    }
+
+    FakeSearch *search = new FakeSearch();
+    search->count = (int) query.size();
+    search->current = -1;
+    for (size_t i = start_index; i + query.size() <= text.size(); i++) {
+        bool match = true;
+        for (size_t k = 0; k < query.size() && match; k++) {
+            char a = text[i + k], b = query[k];
+            match = (flags & FPDF_MATCHCASE) ? a == b : tolower(a) == tolower(b);
+        }
+        if (match && (flags & FPDF_MATCHWHOLEWORD)) {
+            size_t end = i + query.size();
+            match = (i == 0 || !isWordChar(text[i - 1]))
+                    && (end == text.size() || !isWordChar(text[end]));
+        }
+        if (match) search->starts.push_back((int) i);
+    }
+    return search;
+}
+
+FPDF_BOOL FPDFText_FindNext(FPDF_SCHHANDLE handle) {
+    FakeSearch *search = reinterpret_cast<FakeSearch*>(handle);
+    if (search->current + 1 >= (int) search->starts.size()) return 0;
+    search->current++;
+    return 1;
+}
+
+int FPDFText_GetSchResultIndex(FPDF_SCHHANDLE handle) {
+    FakeSearch *search = reinterpret_cast<FakeSearch*>(handle);
+    return search->starts[search->current];
+}
+
+int FPDFText_GetSchCount(FPDF_SCHHANDLE handle) {
+    return reinterpret_cast<FakeSearch*>(handle)->count;
+}
+
+void FPDFText_FindClose(FPDF_SCHHANDLE handle) {
+    delete reinterpret_cast<FakeSearch*>(handle);
+}
+
+static int sRectStart, sRectCount;
+
+int FPDFText_CountRects(FPDF_TEXTPAGE text_page, int start_index, int count) {
+    sRectStart = start_index;
+    sRectCount = count;
+    return 1;
+}
+
+void FPDFText_GetRect(FPDF_TEXTPAGE text_page, int rect_index, double *left, double *top,
+                      double *right, double *bottom) {
+    *left = sRectStart;
+    *top = reinterpret_cast<FakeTextPage*>(text_page)->pageIndex;
+    *right = sRectStart + sRectCount;
+    *bottom = 0;
+}
+
+/** Keeps every batch of results it is handed */
+class RecordingSink : public TextSearch::Sink {
+    public:
+    struct Batch {
+        int lastPageIndex;
+        std::vector<TextSearch::Hit> hits;
+        std::vector<float> rects;
+    };
+
+    virtual bool onResults(int lastPageIndex, const std::vector<TextSearch::Hit> &hits,
+                           const std::vector<float> &rects) {
+        Batch batch = { lastPageIndex, hits, rects };
+        batches.push_back(batch);
+        return true;
+    }
+
+    std::vector<TextSearch::Hit> allHits() const {
+        std::vector<TextSearch::Hit> result;
+        for (size_t i = 0; i < batches.size(); i++) {
+            result.insert(result.end(), batches[i].hits.begin(), batches[i].hits.end());
+        }
+        return result;
+    }
+
+    std::vector<Batch> batches;
+};
+
+class TextSearchTest : public ::testing::Test {
+    protected:
+    void SetUp() override {
+        sPages.clear();
+        sOnLoadPage = nullptr;
+    }
+
+    void TearDown() override {
+        sOnLoadPage = nullptr;
+    }
+
+    static std::vector<int> charIndexes(const char *query, bool matchCase, bool wholeWord) {
+        RecordingSink sink;
+        TextSearch search(toUtf16(query).data(), strlen(query), matchCase, wholeWord);
+        search.search(document(), 0, (int) sPages.size() - 1, &sink);
+
+        std::vector<int> result;
+        std::vector<TextSearch::Hit> hits = sink.allHits();
+        for (size_t i = 0; i < hits.size(); i++) {
+            result.push_back(hits[i].charIndex);
+        }
+        return result;
+    }
+
+    static std::vector<uint16_t> toUtf16(const char *text) {
+        return std::vector<uint16_t>(text, text + strlen(text));
+    }
+
+    static FPDF_DOCUMENT document() {
+        return reinterpret_cast<FPDF_DOCUMENT>(&sDocument);
+    }
+};
+
+TEST_F(TextSearchTest, CaseAndWholeWordFlagsNarrowHits) {
+    sPages = { "Fox fox foxes FOX" };
+
+    EXPECT_EQ(std::vector<int>({ 0, 4, 8, 14 }), charIndexes("fox", false, false));
+    EXPECT_EQ(std::vector<int>({ 4, 8 }), charIndexes("fox", true, false));
+    EXPECT_EQ(std::vector<int>({ 0, 4, 14 }), charIndexes("fox", false, true));
+    EXPECT_EQ(std::vector<int>({ 4 }), charIndexes("fox", true, true));
+}
+
+TEST_F(TextSearchTest, HitsOnBothSidesOfWindowBoundaryGoToTheirOwnWindow) {
+    const int lastOfFirst = WINDOW - 1;
+    sPages.assign(WINDOW * 2, "nothing here");
+    sPages[lastOfFirst] = "needle at end";
+    sPages[lastOfFirst + 1] = "a needle";
+
+    RecordingSink sink;
+    std::vector<uint16_t> query = toUtf16("needle");
+    TextSearch search(query.data(), query.size(), false, false);
+    EXPECT_EQ((int) sPages.size(), search.search(document(), 0, (int) sPages.size() - 1, &sink));
+
+    ASSERT_EQ(2u, sink.batches.size());
+    const RecordingSink::Batch &first = sink.batches[0];
+    EXPECT_EQ(lastOfFirst, first.lastPageIndex);
+    ASSERT_EQ(1u, first.hits.size());
+    EXPECT_EQ(lastOfFirst, first.hits[0].pageIndex);
+    EXPECT_EQ(0, first.hits[0].charIndex);
+    EXPECT_EQ(6, first.hits[0].charCount);
+    ASSERT_EQ(1, first.hits[0].rectCount);
+    EXPECT_EQ(std::vector<float>({ 0, (float) lastOfFirst, 6, 0 }), first.rects);
+
+    const RecordingSink::Batch &second = sink.batches[1];
+    EXPECT_EQ((int) sPages.size() - 1, second.lastPageIndex);
+    ASSERT_EQ(1u, second.hits.size());
+    EXPECT_EQ(lastOfFirst + 1, second.hits[0].pageIndex);
+    EXPECT_EQ(2, second.hits[0].charIndex);
+    EXPECT_EQ(std::vector<float>({ 2, (float) (lastOfFirst + 1), 8, 0 }), second.rects);
+}
+
+TEST_F(TextSearchTest, CancelFromOtherThreadStopsBeforeNextPage) {
+    sPages.assign(WINDOW * 3, "needle");
+    const int cancelPage = WINDOW + 1;
+
+    std::vector<uint16_t> query = toUtf16("needle");
+    TextSearch search(query.data(), query.size(), false, false);
+    int lastLoaded = -1;
+    sOnLoadPage = [&](int pageIndex) {
+        lastLoaded = pageIndex;
+        if (pageIndex == cancelPage) {
+            std::thread canceller([&]() { search.cancel(); });
+            canceller.join();
+        }
+    };
+
+    RecordingSink sink;
+    //Window in progress when search is cancelled is not handed to sink
+    EXPECT_EQ(WINDOW,
+              search.search(document(), 0, (int) sPages.size() - 1, &sink));
+    EXPECT_TRUE(search.isCancelled());
+    EXPECT_EQ(cancelPage, lastLoaded);
+    ASSERT_EQ(1u, sink.batches.size());
+    EXPECT_EQ((size_t) WINDOW, sink.batches[0].hits.size());
+}
+
+TEST_F(TextSearchTest, SinkReturningFalseStopsSearch) {
+    sPages.assign(WINDOW * 3, "needle");
+
+    class StoppingSink : public TextSearch::Sink {
+        public:
+        virtual bool onResults(int lastPageIndex, const std::vector<TextSearch::Hit> &hits,
+                               const std::vector<float> &rects) {
+            calls++;
+            return false;
+        }
+        int calls = 0;
+    } sink;
+
+    std::vector<uint16_t> query = toUtf16("needle");
+    TextSearch search(query.data(), query.size(), false, false);
+    EXPECT_EQ(WINDOW,
+              search.search(document(), 0, (int) sPages.size() - 1, &sink));
+    EXPECT_EQ(1, sink.calls);
+}